@@ -12,6 +12,9 @@ enum loglevel_e
     {logERROR=0, logWARNING=1, logINFO=2, logDEBUG=3, logDEBUG1=4, logDEBUG2=5, logDEBUG3=6, logDEBUG4=7};
 
 
+// Stream the log of this thread is written to (std::cerr unless set, see v2fSolver.h).
+extern thread_local std::ostream * logSink;
+
 class logIt
 {
 	public:
@@ -33,14 +36,16 @@ class logIt
 		~logIt()
 		{
 		        _buffer << std::endl;
-			std::cerr << _buffer.str();
+			// One line at a time, since threads may share a sink.
+			#pragma omp critical(logIt)
+			*logSink << _buffer.str();
 		}
 	private:
 		std::ostringstream _buffer;
 };
 
-// global loglevel as reference
-extern loglevel_e loglevel;
+// loglevel as reference, one per thread so solvers running side by side keep their own
+extern thread_local loglevel_e loglevel;
 
 // actual logging function
 #define Log(level) \
@@ -3,6 +3,9 @@
  *
  *  Created on: Apr 5, 2017
  *      Author: clarkp
+ *
+ * 10/17/2026 - Tables of the mapping derivatives and stencil coefficients.
+ * 10/17/2026 - Sized grids are constructed with a GridSize argument.
  */
 
 #include "Grid.h"
@@ -12,14 +15,22 @@
 
 Grid::Grid(bool isUniform, double delta, double delta_v)
     : remap_param(0.97), a(remap_param*M_PI/2),
-      b(std::sin(remap_param*M_PI/2)), isUniform(isUniform),
-      isDeriv1Cached(false), isDeriv2Cached(false) {
+      b(std::sin(remap_param*M_PI/2)), isUniform(isUniform) {
   if (isUniform) {
     size = std::ceil(delta/delta_v);
   } else {
     size = std::ceil(a/(std::asin(b*delta_v/delta-b)+a));
   }
+  setPoints(delta);
+}
+
+Grid::Grid(bool isUniform, double delta, GridSize size)
+    : remap_param(0.97), a(remap_param*M_PI/2),
+      b(std::sin(remap_param*M_PI/2)), size(size.n), isUniform(isUniform) {
+  setPoints(delta);
+}
 
+void Grid::setPoints(double delta) {
   chi = gsl_vector_alloc(size);
   y = gsl_vector_alloc(size);
 
@@ -31,11 +42,51 @@ Grid::Grid(bool isUniform, double delta, double delta_v)
       gsl_vector_set(y, i, remap(gsl_vector_get(chi, i)));
     }
   }
+  setStencils();
+}
+
+void Grid::setStencils() {
+  metric1 = new double[size];
+  metric2 = new double[size];
+  deriv1Lower = new double[size];
+  deriv1Upper = new double[size];
+  deriv2Lower = new double[size];
+  deriv2Center = new double[size];
+  deriv2Upper = new double[size];
+
+  // Central differences on the uniform chi grid, mapped to y by the chain rule.
+  double delta = gsl_vector_get(chi, 0);
+  for (unsigned int i = 0; i<size; i++) {
+    double a1 = dChidY(gsl_vector_get(chi, i));
+    double a2 = d2ChidY2(gsl_vector_get(chi, i));
+    metric1[i] = a1;
+    metric2[i] = a2;
+    deriv1Lower[i] = -a1/(2*delta);
+    deriv1Upper[i] = a1/(2*delta);
+    deriv2Lower[i] = a1*a1/(delta*delta) - a2/(2*delta);
+    deriv2Center[i] = -2*a1*a1/(delta*delta);
+    deriv2Upper[i] = a1*a1/(delta*delta) + a2/(2*delta);
+  }
+
+  // Zero Neumann condition at the centerline, with the ghost point folded into the point
+  // before it. The second derivative is not mapped to y there.
+  deriv1Lower[size-1] = 0.0;
+  deriv1Upper[size-1] = 0.0;
+  deriv2Lower[size-1] = 2/(delta*delta);
+  deriv2Center[size-1] = -2/(delta*delta);
+  deriv2Upper[size-1] = 0.0;
 }
 
 Grid::~Grid() {
   gsl_vector_free(chi);
   gsl_vector_free(y);
+  delete [] metric1;
+  delete [] metric2;
+  delete [] deriv1Lower;
+  delete [] deriv1Upper;
+  delete [] deriv2Lower;
+  delete [] deriv2Center;
+  delete [] deriv2Upper;
 }
 
 double Grid::remap(double chi) const {
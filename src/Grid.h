@@ -4,6 +4,9 @@
  *
  * \brief Defines class used for either a uniform or non-uniform grid. 
  *
+ * The grid also keeps the mapping derivatives and the finite difference coefficients of 
+ * every point, so the stencils do not evaluate the mapping again.
+ *
  *  Created on: Apr 5, 2017
  */
 
@@ -13,6 +16,16 @@
 #include<gsl/gsl_vector.h>
 #include <cmath>
 
+/**
+ * \brief Number of grid points, to construct a grid by its size rather than its spacing.
+ *
+ * The constructor is explicit, so a number alone never selects the sized Grid constructor.
+ */
+struct GridSize {
+  unsigned int n; /// number of grid points.
+  explicit GridSize(unsigned int n) : n(n) {}
+};
+
 /**
  * \brief Used to define either a uniform or a non-uniform grid.
  */
@@ -22,15 +35,26 @@ class Grid {
    const double a;            /// Equal to remap_param * pi/2
    const double b;            /// Equal to the denominator in the mapping func.
    unsigned int size;
-   mutable double cached_deriv1;
-   mutable double cached_deriv2;
+   void setPoints(double delta);
+   void setStencils();
  public:
   const bool isUniform; /// True if the grid is uniform
-  mutable bool isDeriv1Cached;
-  mutable bool isDeriv2Cached;
   gsl_vector* chi;
   gsl_vector* y;
 
+  /// dChidY and d2ChidY2 at each point, indexed like chi.
+  double* metric1;
+  double* metric2;
+
+  /// Coefficients of the three point first and second derivatives w.r.t. y at each point,
+  /// indexed like chi, on the points before (Lower), at (Center) and after (Upper) it. At
+  /// the last point (the centerline) they are those of the zero Neumann condition.
+  double* deriv1Lower;
+  double* deriv1Upper;
+  double* deriv2Lower;
+  double* deriv2Center;
+  double* deriv2Upper;
+
   /**
    * \brief Constructor
    * @param isUniform - True if the grid is to be uniform
@@ -39,6 +63,15 @@ class Grid {
    */
   Grid(bool isUniform, double delta, double delta_v);
 
+  /**
+   * \brief Constructor for a grid with a given number of points and the same
+   * mapping, e.g. a coarse level for grid sequencing.
+   * @param isUniform - True if the grid is to be uniform
+   * @param delta - The channel half-width.
+   * @param size - The number of grid points.
+   */
+  Grid(bool isUniform, double delta, GridSize size);
+
   /**
    * \brief Destructor
    */
@@ -0,0 +1,63 @@
+//--------------------------------------------------
+// adJacobian: Jacobian of F(xi) with dual numbers.
+//
+// 10/17/2026 - Written for exact Jacobians without SysJ.
+// 10/17/2026 - Seeded unknowns from the workspace in FParams.
+//--------------------------------------------------
+#include"adJacobian.h"
+#include"workspace.h"
+using namespace std;
+
+int ADJacobian(const gsl_vector * xi, void * p, BlockTridiag * J)
+{
+	struct FParams * params = (struct FParams *)p;
+	unsigned int n = J->n;
+	if (xi->size != BLOCK_SIZE*n)
+	{
+		Log(logERROR) << "Error: AD Jacobian needs " << BLOCK_SIZE*n << " unknowns";
+		return 1;
+	}
+	bool allocated = !WorkspaceFits(params->work,n+1);
+	DualVector * x, * f;
+	if (allocated)
+	{
+		x = VecTraits<DualVector>::Calloc(xi->size);
+		f = VecTraits<DualVector>::Calloc(xi->size);
+		WorkspaceCountAlloc(2);
+	}
+	else
+	{
+		x = params->work->x;
+		f = params->work->f;
+	}
+
+	// Seed unknown c at point r (from 0) with color 5*(r%3)+c. Every entry is reset, since x
+	// may hold the seeds of the previous call.
+	for (unsigned int r = 0; r < n; r++)
+		for (int c = 0; c < BLOCK_SIZE; c++)
+		{
+			x->data[BLOCK_SIZE*r+c] = JacDual(gsl_vector_get(xi,BLOCK_SIZE*r+c));
+			x->data[BLOCK_SIZE*r+c].d[BLOCK_SIZE*(r%3)+c] = 1.0;
+		}
+	int status = SysResidual(x,params,f);
+
+	// The residuals at point r see color 5*(s%3)+c only through point s = r+offset.
+	for (unsigned int r = 0; r < n && !status; r++)
+		for (int offset = -1; offset <= 1; offset++)
+		{
+			int s = r+offset;
+			if (s < 0 || s >= (int)n)
+				continue;
+			double * block = BlockTridiagBlock(J,r,offset);
+			for (int m = 0; m < BLOCK_SIZE; m++)
+				for (int c = 0; c < BLOCK_SIZE; c++)
+					block[BLOCK_SIZE*m+c] = f->data[BLOCK_SIZE*r+m].d[BLOCK_SIZE*(s%3)+c];
+		}
+
+	if (allocated)
+	{
+		VecTraits<DualVector>::Free(x);
+		VecTraits<DualVector>::Free(f);
+	}
+	return status;
+}
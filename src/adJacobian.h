@@ -0,0 +1,28 @@
+/**
+ * \file
+ *
+ * \brief Exact Jacobian of SysF by forward mode automatic differentiation.
+ *
+ * The unknowns are seeded with the same 15 colors as ColoredFDJacobian (unknown m at grid
+ * point i gets color \f$5((i-1) \bmod 3)+m\f$), and the residual is evaluated once with
+ * SysResidual on a DualVector. Every residual sees at most one unknown of each color, so the
+ * derivatives w.r.t. the colors are exactly the entries of the block tridiagonal Jacobian, with
+ * no truncation error and no need to update anything when model terms change.
+ */
+#ifndef ADJACOBIAN_H
+#define ADJACOBIAN_H
+#include<gsl/gsl_vector.h>
+#include"systemSolve.h"
+#include"blockTridiag.h"
+using namespace std;
+
+/**
+ * \brief Jacobian of SysF at xi, assembled as a BlockTridiag.
+ * \param xi pointer to gsl_vector of unknowns at n+1 time step.
+ * \param p pointer to parameters for system (FParams).
+ * \param J block tridiagonal Jacobian, with xi->size/5 block rows.
+ * \return Error code (0 = success).
+ */
+int ADJacobian(const gsl_vector * xi, void * p, BlockTridiag * J);
+
+#endif
@@ -0,0 +1,145 @@
+//--------------------------------------------------
+// anderson: Anderson acceleration of a fixed point
+// iteration.
+//
+// 10/17/2026 - Written for the pseudo time steps
+//              of NewtonSolve.
+//--------------------------------------------------
+#include<math.h>
+#include<gsl/gsl_blas.h>
+#include<gsl/gsl_linalg.h>
+#include"anderson.h"
+using namespace std;
+
+Anderson * AndersonAlloc(size_t n, int m, double restartRatio)
+{
+	Anderson * aa = new Anderson;
+	aa->m = m;
+	aa->restartRatio = restartRatio;
+	aa->dG = new gsl_vector*[m];
+	aa->dR = new gsl_vector*[m];
+	for (int j = 0; j < m; j++)
+	{
+		aa->dG[j] = gsl_vector_alloc(n);
+		aa->dR[j] = gsl_vector_alloc(n);
+	}
+	aa->gPrev = gsl_vector_alloc(n);
+	aa->rPrev = gsl_vector_alloc(n);
+	aa->r = gsl_vector_alloc(n);
+	aa->A = new gsl_matrix*[m];
+	aa->perm = new gsl_permutation*[m];
+	for (int j = 0; j < m; j++)
+	{
+		aa->A[j] = gsl_matrix_alloc(j+1,j+1);
+		aa->perm[j] = gsl_permutation_alloc(j+1);
+	}
+	aa->rhs = gsl_vector_alloc(m);
+	aa->gamma = gsl_vector_alloc(m);
+	aa->mixCount = 0;
+	aa->restartCount = 0;
+	AndersonReset(aa);
+	return aa;
+}
+
+void AndersonFree(Anderson * aa)
+{
+	for (int j = 0; j < aa->m; j++)
+	{
+		gsl_vector_free(aa->dG[j]);
+		gsl_vector_free(aa->dR[j]);
+		gsl_matrix_free(aa->A[j]);
+		gsl_permutation_free(aa->perm[j]);
+	}
+	delete [] aa->dG;
+	delete [] aa->dR;
+	gsl_vector_free(aa->gPrev);
+	gsl_vector_free(aa->rPrev);
+	gsl_vector_free(aa->r);
+	delete [] aa->A;
+	delete [] aa->perm;
+	gsl_vector_free(aa->rhs);
+	gsl_vector_free(aa->gamma);
+	delete aa;
+}
+
+void AndersonReset(Anderson * aa)
+{
+	aa->count = 0;
+	aa->head = 0;
+	aa->prevNorm = 0.0;
+}
+
+// Clears the history but keeps the current step as the start of the next one.
+static void Restart(Anderson * aa, const gsl_vector * g)
+{
+	AndersonReset(aa);
+	aa->restartCount++;
+	gsl_vector_memcpy(aa->gPrev,g);
+	gsl_vector_memcpy(aa->rPrev,aa->r);
+	aa->prevNorm = gsl_blas_dnrm2(aa->r);
+}
+
+bool AndersonMix(Anderson * aa, const gsl_vector * x, const gsl_vector * g, gsl_vector * xMix)
+{
+	// r_k = G(x_k) - x_k
+	gsl_vector_memcpy(aa->r,g);
+	gsl_vector_sub(aa->r,x);
+	double norm = gsl_blas_dnrm2(aa->r);
+
+	if (aa->prevNorm > 0.0 && norm > aa->restartRatio*aa->prevNorm)
+	{
+		Restart(aa,g);
+		return false;
+	}
+	if (aa->prevNorm > 0.0)
+	{
+		// The newest differences overwrite the oldest.
+		gsl_vector_memcpy(aa->dG[aa->head],g);
+		gsl_vector_sub(aa->dG[aa->head],aa->gPrev);
+		gsl_vector_memcpy(aa->dR[aa->head],aa->r);
+		gsl_vector_sub(aa->dR[aa->head],aa->rPrev);
+		aa->head = (aa->head+1)%aa->m;
+		if (aa->count < aa->m)
+			aa->count++;
+	}
+	gsl_vector_memcpy(aa->gPrev,g);
+	gsl_vector_memcpy(aa->rPrev,aa->r);
+	aa->prevNorm = norm;
+	if (aa->count == 0)
+		return false;
+
+	// Normal equations of min |r_k - dR gamma| on the stored differences.
+	int n = aa->count;
+	gsl_matrix * A = aa->A[n-1];
+	gsl_vector_view rhs = gsl_vector_subvector(aa->rhs,0,n);
+	gsl_vector_view gamma = gsl_vector_subvector(aa->gamma,0,n);
+	for (int i = 0; i < n; i++)
+	{
+		double d;
+		for (int j = 0; j <= i; j++)
+		{
+			gsl_blas_ddot(aa->dR[i],aa->dR[j],&d);
+			gsl_matrix_set(A,i,j,d);
+			gsl_matrix_set(A,j,i,d);
+		}
+		gsl_blas_ddot(aa->dR[i],aa->r,&d);
+		gsl_vector_set(&rhs.vector,i,d);
+	}
+	int s;
+	int status = gsl_linalg_LU_decomp(A,aa->perm[n-1],&s) || gsl_linalg_LU_solve(A,aa->perm[n-1],&rhs.vector,&gamma.vector);
+	double gammaSum = 0.0;
+	for (int j = 0; j < n; j++)
+		gammaSum += fabs(gsl_vector_get(&gamma.vector,j));
+	if (status || !isfinite(gammaSum) || gammaSum > AA_MAX_GAMMA)
+	{
+		Restart(aa,g);
+		return false;
+	}
+
+	// x_{k+1} = G(x_k) - dG gamma
+	gsl_vector_memcpy(xMix,g);
+	for (int j = 0; j < n; j++)
+		gsl_blas_daxpy(-gsl_vector_get(&gamma.vector,j),aa->dG[j],xMix);
+	aa->mixCount++;
+	return true;
+}
@@ -0,0 +1,84 @@
+/**
+ * \file
+ *
+ * \brief Anderson acceleration of the fixed point iteration \f$x \leftarrow G(x)\f$.
+ *
+ * In NewtonSolve, G is one pseudo time Newton step. With the fixed point residual
+ * \f$r_k = G(x_k) - x_k\f$ and the differences \f$\Delta G_j = G(x_{j+1}) - G(x_j)\f$ and
+ * \f$\Delta r_j = r_{j+1} - r_j\f$ of the last m steps, the next iterate is
+ * \f[ x_{k+1} = G(x_k) - \sum_j \gamma_j \Delta G_j, \quad
+ *     \gamma = \arg\min \|r_k - \sum_j \gamma_j \Delta r_j\|_2. \f]
+ * The m x m normal equations of the least squares problem are solved by LU. The differences
+ * are kept in ring buffers of m vectors, allocated once, so the oldest pair is overwritten.
+ *
+ * The history is cleared (a restart) when \f$\|r_k\|\f$ grows by more than restartRatio over
+ * one step, when the normal equations are singular, or when \f$\sum_j|\gamma_j|\f$ is above
+ * AA_MAX_GAMMA. After a restart the plain step \f$G(x_k)\f$ is taken. The caller may also
+ * discard \f$x_{k+1}\f$ and take \f$G(x_k)\f$, which is still kept in the history.
+ */
+#ifndef ANDERSON_H
+#define ANDERSON_H
+#include<gsl/gsl_vector.h>
+#include<gsl/gsl_matrix.h>
+#include<gsl/gsl_permutation.h>
+using namespace std;
+
+/**
+ * \brief Largest \f$\sum_j|\gamma_j|\f$ accepted before the history is cleared.
+ */
+#define AA_MAX_GAMMA 1.0e3
+
+/**
+ * \brief History and work space of Anderson acceleration.
+ */
+struct Anderson {
+	int m; /**< depth, the number of differences kept. */
+	int count; /**< number of differences stored. */
+	int head; /**< slot the next difference is written to. */
+	double restartRatio; /**< clear the history when \f$\|r_k\|/\|r_{k-1}\|\f$ is above this. */
+	double prevNorm; /**< \f$\|r_{k-1}\|\f$, 0 if there is no previous step. */
+	gsl_vector ** dG; /**< ring buffer of \f$\Delta G_j\f$. */
+	gsl_vector ** dR; /**< ring buffer of \f$\Delta r_j\f$. */
+	gsl_vector * gPrev; /**< \f$G(x_{k-1})\f$. */
+	gsl_vector * rPrev; /**< \f$r_{k-1}\f$. */
+	gsl_vector * r; /**< work vector for \f$r_k\f$. */
+	gsl_matrix ** A; /**< normal equations, A[n-1] is n x n for n stored differences. */
+	gsl_permutation ** perm; /**< pivots of the LU factorizations of A. */
+	gsl_vector * rhs; /**< \f$\Delta r^T r_k\f$. */
+	gsl_vector * gamma; /**< mixing coefficients. */
+	int mixCount; /**< number of mixed steps returned. */
+	int restartCount; /**< number of restarts. */
+};
+
+/**
+ * \brief Allocate Anderson acceleration for vectors of size n.
+ * \param n size of the unknowns.
+ * \param m depth (at least 1).
+ * \param restartRatio clear the history when the fixed point residual grows by more than this.
+ * \return pointer to new Anderson.
+ */
+Anderson * AndersonAlloc(size_t n, int m, double restartRatio);
+
+/**
+ * \brief Free an Anderson.
+ * \param aa pointer to Anderson.
+ */
+void AndersonFree(Anderson * aa);
+
+/**
+ * \brief Clear the history, so the next step is not accelerated.
+ * \param aa pointer to Anderson.
+ */
+void AndersonReset(Anderson * aa);
+
+/**
+ * \brief Adds the step \f$x \rightarrow G(x)\f$ to the history and mixes it with the earlier ones.
+ * \param aa pointer to Anderson.
+ * \param x current iterate \f$x_k\f$.
+ * \param g \f$G(x_k)\f$.
+ * \param xMix accelerated iterate \f$x_{k+1}\f$.
+ * \return true if xMix was set, false after a restart or with no history.
+ */
+bool AndersonMix(Anderson * aa, const gsl_vector * x, const gsl_vector * g, gsl_vector * xMix);
+
+#endif
@@ -0,0 +1,376 @@
+//--------------------------------------------------
+// blockTridiag: Storage and solve for block tridiagonal systems.
+//
+// 10/17/2026 - Added for analytic Jacobian.
+// 10/17/2026 - Native block Thomas factor/solve with 5x5 kernels.
+// 10/17/2026 - Single precision factorization with iterative refinement.
+// 10/17/2026 - Refinement that does not converge is returned as an error.
+//--------------------------------------------------
+#include<stdlib.h>
+#include<string.h>
+#include<math.h>
+#include"blockTridiag.h"
+#include"../include/loglevel.h"
+using namespace std;
+
+//--------------------------------------------------
+// Fixed size kernels on row major 5x5 blocks, in double 
+// or single (float) precision. 
+//--------------------------------------------------
+
+// LU factorization with partial pivoting, in place. piv[m] is the original row of row m.
+template<class R>
+static inline int Block5Factor(R * a, int * piv)
+{
+	for (int m = 0; m < BLOCK_SIZE; m++)
+		piv[m] = m;
+	for (int j = 0; j < BLOCK_SIZE; j++)
+	{
+		int p = j;
+		R maxVal = fabs(a[BLOCK_SIZE*j+j]);
+		for (int m = j+1; m < BLOCK_SIZE; m++)
+		{
+			if (fabs(a[BLOCK_SIZE*m+j]) > maxVal)
+			{
+				maxVal = fabs(a[BLOCK_SIZE*m+j]);
+				p = m;
+			}
+		}
+		if (maxVal == 0.0 || !isfinite(maxVal))
+			return 1;
+		if (p != j)
+		{
+			for (int c = 0; c < BLOCK_SIZE; c++)
+			{
+				R tmp = a[BLOCK_SIZE*j+c];
+				a[BLOCK_SIZE*j+c] = a[BLOCK_SIZE*p+c];
+				a[BLOCK_SIZE*p+c] = tmp;
+			}
+			int tmp = piv[j];
+			piv[j] = piv[p];
+			piv[p] = tmp;
+		}
+		R inv = 1/a[BLOCK_SIZE*j+j];
+		for (int m = j+1; m < BLOCK_SIZE; m++)
+		{
+			R l = a[BLOCK_SIZE*m+j]*inv;
+			a[BLOCK_SIZE*m+j] = l;
+			for (int c = j+1; c < BLOCK_SIZE; c++)
+				a[BLOCK_SIZE*m+c] -= l*a[BLOCK_SIZE*j+c];
+		}
+	}
+	return 0;
+}
+
+// Solve (LU)x = b for one vector, in place. The vector may be in higher precision than LU.
+template<class R, class S>
+static inline void Block5Solve(const R * lu, const int * piv, S * b)
+{
+	S y[BLOCK_SIZE];
+	for (int m = 0; m < BLOCK_SIZE; m++)
+	{
+		S val = b[piv[m]];
+		for (int c = 0; c < m; c++)
+			val -= lu[BLOCK_SIZE*m+c]*y[c];
+		y[m] = val;
+	}
+	for (int m = BLOCK_SIZE-1; m >= 0; m--)
+	{
+		S val = y[m];
+		for (int c = m+1; c < BLOCK_SIZE; c++)
+			val -= lu[BLOCK_SIZE*m+c]*y[c];
+		y[m] = val/lu[BLOCK_SIZE*m+m];
+	}
+	for (int m = 0; m < BLOCK_SIZE; m++)
+		b[m] = y[m];
+}
+
+// Solve (LU)X = B for a 5x5 block B, in place.
+template<class R>
+static inline void Block5SolveMat(const R * lu, const int * piv, R * B)
+{
+	R col[BLOCK_SIZE];
+	for (int c = 0; c < BLOCK_SIZE; c++)
+	{
+		for (int m = 0; m < BLOCK_SIZE; m++)
+			col[m] = B[BLOCK_SIZE*m+c];
+		Block5Solve(lu,piv,col);
+		for (int m = 0; m < BLOCK_SIZE; m++)
+			B[BLOCK_SIZE*m+c] = col[m];
+	}
+}
+
+// C = C - A*B
+template<class R>
+static inline void Block5MatMulSub(const R * A, const R * B, R * C)
+{
+	for (int m = 0; m < BLOCK_SIZE; m++)
+		for (int j = 0; j < BLOCK_SIZE; j++)
+		{
+			R a = A[BLOCK_SIZE*m+j];
+			for (int c = 0; c < BLOCK_SIZE; c++)
+				C[BLOCK_SIZE*m+c] -= a*B[BLOCK_SIZE*j+c];
+		}
+}
+
+// y = y - A*x
+template<class R>
+static inline void Block5MatVecSub(const R * A, const double * x, double * y)
+{
+	for (int m = 0; m < BLOCK_SIZE; m++)
+	{
+		double val = y[m];
+		for (int c = 0; c < BLOCK_SIZE; c++)
+			val -= A[BLOCK_SIZE*m+c]*x[c];
+		y[m] = val;
+	}
+}
+
+BlockTridiag * BlockTridiagAlloc(unsigned int n)
+{
+	BlockTridiag * A = (BlockTridiag *)malloc(sizeof(BlockTridiag));
+	A->n = n;
+	A->lower = (double *)calloc(n*BLOCK_ELEMS,sizeof(double));
+	A->diag  = (double *)calloc(n*BLOCK_ELEMS,sizeof(double));
+	A->upper = (double *)calloc(n*BLOCK_ELEMS,sizeof(double));
+	return A;
+}
+
+void BlockTridiagFree(BlockTridiag * A)
+{
+	free(A->lower);
+	free(A->diag);
+	free(A->upper);
+	free(A);
+}
+
+void BlockTridiagSetZero(BlockTridiag * A)
+{
+	memset(A->lower,0,A->n*BLOCK_ELEMS*sizeof(double));
+	memset(A->diag,0,A->n*BLOCK_ELEMS*sizeof(double));
+	memset(A->upper,0,A->n*BLOCK_ELEMS*sizeof(double));
+}
+
+double * BlockTridiagBlock(BlockTridiag * A, unsigned int row, int offset)
+{
+	if (offset < 0)
+		return A->lower + row*BLOCK_ELEMS;
+	if (offset > 0)
+		return A->upper + row*BLOCK_ELEMS;
+	return A->diag + row*BLOCK_ELEMS;
+}
+
+int BlockTridiagToDense(BlockTridiag * A, gsl_matrix * M)
+{
+	if (M->size1 != BLOCK_SIZE*A->n || M->size2 != BLOCK_SIZE*A->n)
+		return 1;
+	gsl_matrix_set_zero(M);
+	for (unsigned int r = 0; r < A->n; r++)
+	{
+		for (int offset = -1; offset <= 1; offset++)
+		{
+			if ((r == 0 && offset < 0) || (r == A->n-1 && offset > 0))
+				continue;
+			double * block = BlockTridiagBlock(A,r,offset);
+			for (unsigned int m = 0; m < BLOCK_SIZE; m++)
+				for (unsigned int c = 0; c < BLOCK_SIZE; c++)
+					gsl_matrix_set(M,BLOCK_SIZE*r+m,BLOCK_SIZE*(r+offset)+c,block[BLOCK_SIZE*m+c]);
+		}
+	}
+	return 0;
+}
+
+BlockTridiagLU * BlockTridiagLUAlloc(unsigned int n)
+{
+	BlockTridiagLU * LU = (BlockTridiagLU *)malloc(sizeof(BlockTridiagLU));
+	LU->n = n;
+	LU->single = false;
+	LU->lower  = (double *)calloc(n*BLOCK_ELEMS,sizeof(double));
+	LU->diagLU = (double *)calloc(n*BLOCK_ELEMS,sizeof(double));
+	LU->upper  = (double *)calloc(n*BLOCK_ELEMS,sizeof(double));
+	LU->lowerS  = NULL;
+	LU->diagLUS = NULL;
+	LU->upperS  = NULL;
+	LU->pivots = (int *)calloc(n*BLOCK_SIZE,sizeof(int));
+	return LU;
+}
+
+BlockTridiagLU * BlockTridiagLUAllocSingle(unsigned int n)
+{
+	BlockTridiagLU * LU = (BlockTridiagLU *)malloc(sizeof(BlockTridiagLU));
+	LU->n = n;
+	LU->single = true;
+	LU->lower  = NULL;
+	LU->diagLU = NULL;
+	LU->upper  = NULL;
+	LU->lowerS  = (float *)calloc(n*BLOCK_ELEMS,sizeof(float));
+	LU->diagLUS = (float *)calloc(n*BLOCK_ELEMS,sizeof(float));
+	LU->upperS  = (float *)calloc(n*BLOCK_ELEMS,sizeof(float));
+	LU->pivots = (int *)calloc(n*BLOCK_SIZE,sizeof(int));
+	return LU;
+}
+
+void BlockTridiagLUFree(BlockTridiagLU * LU)
+{
+	free(LU->lower);
+	free(LU->diagLU);
+	free(LU->upper);
+	free(LU->lowerS);
+	free(LU->diagLUS);
+	free(LU->upperS);
+	free(LU->pivots);
+	free(LU);
+}
+
+// Block Thomas factorization of the blocks already copied into lower, diagLU and upper.
+template<class R>
+static int BlockThomasFactor(unsigned int n, R * lower, R * diagLU, R * upper, int * pivots)
+{
+	// D_r = A_r - L_r*(D_{r-1}^{-1}U_{r-1}), stored as LU factors, 
+	// and U'_r = D_r^{-1}U_r for the back substitution. 
+	for (unsigned int r = 0; r < n; r++)
+	{
+		R * D = diagLU + r*BLOCK_ELEMS;
+		int * piv = pivots + r*BLOCK_SIZE;
+		if (r > 0)
+			Block5MatMulSub(lower + r*BLOCK_ELEMS,upper + (r-1)*BLOCK_ELEMS,D);
+		if (Block5Factor(D,piv))
+		{
+			Log(logERROR) << "Error: singular diagonal block at " << r;
+			return 1;
+		}
+		if (r < n-1)
+			Block5SolveMat(D,piv,upper + r*BLOCK_ELEMS);
+	}
+	return 0;
+}
+
+template<class R>
+static void BlockThomasSolve(unsigned int n, const R * lower, const R * diagLU, const R * upper, const int * pivots, double * xr)
+{
+	// Forward: y_r = D_r^{-1}(b_r - L_r*y_{r-1})
+	for (unsigned int r = 0; r < n; r++)
+	{
+		if (r > 0)
+			Block5MatVecSub(lower + r*BLOCK_ELEMS,xr + (r-1)*BLOCK_SIZE,xr + r*BLOCK_SIZE);
+		Block5Solve(diagLU + r*BLOCK_ELEMS,pivots + r*BLOCK_SIZE,xr + r*BLOCK_SIZE);
+	}
+
+	// Back substitution: x_r = y_r - U'_r*x_{r+1}
+	for (int r = n-2; r >= 0; r--)
+		Block5MatVecSub(upper + r*BLOCK_ELEMS,xr + (r+1)*BLOCK_SIZE,xr + r*BLOCK_SIZE);
+}
+
+int BlockTridiagFactor(BlockTridiag * A, BlockTridiagLU * LU)
+{
+	if (LU->n != A->n)
+		return 1;
+	unsigned int size = A->n*BLOCK_ELEMS;
+	if (!LU->single)
+	{
+		memcpy(LU->lower,A->lower,size*sizeof(double));
+		memcpy(LU->diagLU,A->diag,size*sizeof(double));
+		memcpy(LU->upper,A->upper,size*sizeof(double));
+		return BlockThomasFactor(A->n,LU->lower,LU->diagLU,LU->upper,LU->pivots);
+	}
+	for (unsigned int j = 0; j < size; j++)
+	{
+		LU->lowerS[j] = A->lower[j];
+		LU->diagLUS[j] = A->diag[j];
+		LU->upperS[j] = A->upper[j];
+	}
+	return BlockThomasFactor(A->n,LU->lowerS,LU->diagLUS,LU->upperS,LU->pivots);
+}
+
+int BlockTridiagLUSolve(BlockTridiagLU * LU, const gsl_vector * b, gsl_vector * x)
+{
+	if (x->size != BLOCK_SIZE*LU->n || x->stride != 1)
+	{
+		Log(logERROR) << "Error: block tridiagonal solve needs a contiguous vector of size " << BLOCK_SIZE*LU->n;
+		return 1;
+	}
+	if (x != b)
+		gsl_vector_memcpy(x,b);
+	if (LU->single)
+		BlockThomasSolve(LU->n,LU->lowerS,LU->diagLUS,LU->upperS,LU->pivots,x->data);
+	else
+		BlockThomasSolve(LU->n,LU->lower,LU->diagLU,LU->upper,LU->pivots,x->data);
+	return 0;
+}
+
+int BlockTridiagMatVec(BlockTridiag * A, const gsl_vector * x, gsl_vector * y)
+{
+	if (x->size != BLOCK_SIZE*A->n || y->size != x->size || x->stride != 1 || y->stride != 1 || x == y)
+		return 1;
+	const double * xr = x->data;
+	double * yr = y->data;
+	for (unsigned int r = 0; r < A->n; r++)
+	{
+		double * yb = yr + r*BLOCK_SIZE;
+		for (int m = 0; m < BLOCK_SIZE; m++)
+			yb[m] = 0.0;
+		// y_r = -(-A_r x_r - L_r x_{r-1} - U_r x_{r+1})
+		Block5MatVecSub(A->diag + r*BLOCK_ELEMS,xr + r*BLOCK_SIZE,yb);
+		if (r > 0)
+			Block5MatVecSub(A->lower + r*BLOCK_ELEMS,xr + (r-1)*BLOCK_SIZE,yb);
+		if (r < A->n-1)
+			Block5MatVecSub(A->upper + r*BLOCK_ELEMS,xr + (r+1)*BLOCK_SIZE,yb);
+		for (int m = 0; m < BLOCK_SIZE; m++)
+			yb[m] = -yb[m];
+	}
+	return 0;
+}
+
+int BlockTridiagRefinedSolve(BlockTridiag * A, BlockTridiagLU * LU, const gsl_vector * b, gsl_vector * x, 
+                             gsl_vector * r, double tol, int maxIters)
+{
+	if (x == b || b->stride != 1 || BlockTridiagLUSolve(LU,b,x))
+		return -1;
+	unsigned int size = x->size;
+	// fmax drops NaN, so the norms are checked to be finite on their own.
+	double bnorm = 0.0;
+	bool finite = true;
+	for (unsigned int j = 0; j < size; j++)
+	{
+		finite &= isfinite(b->data[j]);
+		bnorm = fmax(bnorm,fabs(b->data[j]));
+	}
+	if (!finite)
+		return -1;
+	// r = b - Ax in double, and the correction solved with the (single precision) factors.
+	double lastNorm = INFINITY;
+	for (int k = 0; ; k++)
+	{
+		if (BlockTridiagMatVec(A,x,r))
+			return -1;
+		double rnorm = 0.0;
+		for (unsigned int j = 0; j < size; j++)
+		{
+			r->data[j] = b->data[j] - r->data[j];
+			finite &= isfinite(r->data[j]);
+			rnorm = fmax(rnorm,fabs(r->data[j]));
+		}
+		if (!finite)
+			return REFINE_NOT_CONVERGED;
+		if (rnorm <= tol*bnorm)
+			return k;
+		// A correction that does not shrink the residual will not reach tol either.
+		if (k == maxIters || !(rnorm < lastNorm))
+			return REFINE_NOT_CONVERGED;
+		lastNorm = rnorm;
+		if (BlockTridiagLUSolve(LU,r,r))
+			return -1;
+		for (unsigned int j = 0; j < size; j++)
+			x->data[j] += r->data[j];
+	}
+}
+
+int BlockTridiagSolve(BlockTridiag * A, gsl_vector * b)
+{
+	BlockTridiagLU * LU = BlockTridiagLUAlloc(A->n);
+	int status = BlockTridiagFactor(A,LU);
+	if (!status)
+		status = BlockTridiagLUSolve(LU,b,b);
+	BlockTridiagLUFree(LU);
+	return status;
+}
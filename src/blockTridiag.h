@@ -0,0 +1,177 @@
+/**
+ * \file
+ *
+ * \brief Storage and solve for block tridiagonal systems.
+ *
+ * The unknowns in \f$\xi\f$ are ordered point by point (\f$U,k,\epsilon,\overline{v^2},f\f$ at
+ * each grid point), and every finite difference in the system only couples a point to its
+ * neighbors. The Jacobian of \f$F(\xi)\f$ is therefore block tridiagonal with 5x5 blocks,
+ * which this file stores in O(N) memory. The solve is a block Thomas algorithm with
+ * fixed size 5x5 kernels and partial pivoting within each diagonal block. The factorization
+ * is kept in a separate BlockTridiagLU, so it can be reused for several right hand sides
+ * (e.g. by a preconditioner). The factors may be kept in single precision, which halves the
+ * memory traffic of the factor and the solves; BlockTridiagRefinedSolve then recovers double
+ * precision accuracy with iterative refinement against the double precision matrix.
+ */
+#ifndef BLOCKTRIDIAG_H
+#define BLOCKTRIDIAG_H
+
+#include<gsl/gsl_vector.h>
+#include<gsl/gsl_matrix.h>
+
+#define BLOCK_SIZE 5  /**< number of unknowns per grid point. */
+#define BLOCK_ELEMS 25 /**< number of entries in a single block. */
+#define REFINE_TOL 1e-12 /**< relative residual of the mixed precision solves. */
+#define REFINE_MAX_ITERS 10 /**< largest number of refinement steps of a mixed precision solve. */
+#define REFINE_NOT_CONVERGED -2 /**< BlockTridiagRefinedSolve did not reach its tolerance. */
+
+/**
+ * \brief Block tridiagonal matrix with 5x5 blocks.
+ *
+ * Block row r couples grid point r+1 (in the indexing of the Set*Terms functions)
+ * to its neighbors. Each block is stored row major, so the entry for equation m and
+ * unknown c is at 5*m+c.
+ */
+struct BlockTridiag {
+	unsigned int n; /**< number of block rows (grid points). */
+	double * lower; /**< sub-diagonal blocks, couple a point to the one below it. lower[0] is unused. */
+	double * diag; /**< diagonal blocks. */
+	double * upper; /**< super-diagonal blocks, couple a point to the one above it. The last block is unused. */
+};
+
+/**
+ * \brief Block LU factorization of a BlockTridiag.
+ *
+ * The modified diagonal blocks \f$D_r = A_r - L_r D_{r-1}^{-1} U_{r-1}\f$ are stored
+ * as in place LU factors with their row pivots, together with \f$D_r^{-1}U_r\f$.
+ */
+struct BlockTridiagLU {
+	unsigned int n; /**< number of block rows (grid points). */
+	bool single; /**< the factors are stored in lowerS, diagLUS and upperS instead. */
+	double * lower; /**< copy of the sub-diagonal blocks of A. */
+	double * diagLU; /**< LU factors of the modified diagonal blocks. */
+	int * pivots; /**< row permutation of each diagonal block, 5 per block. */
+	double * upper; /**< \f$D_r^{-1}U_r\f$ for each block row. */
+	float * lowerS; /**< lower, in single precision. */
+	float * diagLUS; /**< diagLU, in single precision. */
+	float * upperS; /**< upper, in single precision. */
+};
+
+/**
+ * \brief Allocate a zeroed block tridiagonal matrix.
+ * \param n number of block rows.
+ * \return pointer to new matrix.
+ */
+BlockTridiag * BlockTridiagAlloc(unsigned int n);
+
+/**
+ * \brief Free a block tridiagonal matrix.
+ * \param A pointer to matrix.
+ */
+void BlockTridiagFree(BlockTridiag * A);
+
+/**
+ * \brief Set every block to zero.
+ * \param A pointer to matrix.
+ */
+void BlockTridiagSetZero(BlockTridiag * A);
+
+/**
+ * \brief Get a block of the matrix.
+ * \param A pointer to matrix.
+ * \param row block row (0 based).
+ * \param offset -1 for the lower block, 0 for the diagonal, 1 for the upper block.
+ * \return pointer to the 25 entries of the block.
+ */
+double * BlockTridiagBlock(BlockTridiag * A, unsigned int row, int offset);
+
+/**
+ * \brief Copy the matrix into a dense gsl_matrix.
+ *
+ * Only meant for small systems, e.g. for use with gsl's multiroot fdf solvers or for testing.
+ * \param A pointer to matrix.
+ * \param M dense matrix of size 5n x 5n.
+ * \return Error code (0 = success).
+ */
+int BlockTridiagToDense(BlockTridiag * A, gsl_matrix * M);
+
+/**
+ * \brief Allocate storage for the factorization of an n block row matrix.
+ * \param n number of block rows.
+ * \return pointer to new factorization.
+ */
+BlockTridiagLU * BlockTridiagLUAlloc(unsigned int n);
+
+/**
+ * \brief Allocate storage for a single precision factorization of an n block row matrix.
+ *
+ * The factorization is computed in float, and the solves accumulate in double.
+ * \param n number of block rows.
+ * \return pointer to new factorization.
+ */
+BlockTridiagLU * BlockTridiagLUAllocSingle(unsigned int n);
+
+/**
+ * \brief Free a factorization.
+ * \param LU pointer to factorization.
+ */
+void BlockTridiagLUFree(BlockTridiagLU * LU);
+
+/**
+ * \brief Factor A with the block Thomas algorithm.
+ *
+ * A is not modified, so it can be updated and refactored into the same LU.
+ * \param A pointer to matrix.
+ * \param LU pointer to factorization, allocated with the same number of block rows.
+ * \return Error code (0 = success, 1 = singular diagonal block).
+ */
+int BlockTridiagFactor(BlockTridiag * A, BlockTridiagLU * LU);
+
+/**
+ * \brief Solve Ax = b using a factorization from BlockTridiagFactor.
+ * \param LU pointer to factorization.
+ * \param b right hand side.
+ * \param x solution. May be the same vector as b.
+ * \return Error code (0 = success).
+ */
+int BlockTridiagLUSolve(BlockTridiagLU * LU, const gsl_vector * b, gsl_vector * x);
+
+/**
+ * \brief Matrix vector product, y = Ax.
+ * \param A pointer to matrix.
+ * \param x vector.
+ * \param y result, not the same vector as x.
+ * \return Error code (0 = success).
+ */
+int BlockTridiagMatVec(BlockTridiag * A, const gsl_vector * x, gsl_vector * y);
+
+/**
+ * \brief Solve Ax = b with the factors of A and iterative refinement.
+ *
+ * After the first solve, \f$r = b - Ax\f$ is formed in double precision and
+ * \f$x \leftarrow x + (LU)^{-1}r\f$ until \f$\|r\|_\infty \le tol\,\|b\|_\infty\f$. The solve fails
+ * if r is not finite, stops shrinking, or is still above the tolerance after maxIters steps; x
+ * is then not a solution and must not be used.
+ * \param A pointer to the double precision matrix LU was factored from.
+ * \param LU pointer to factorization, usually single precision.
+ * \param b right hand side.
+ * \param x solution, not the same vector as b.
+ * \param r work vector of the same size.
+ * \param tol relative tolerance of the residual.
+ * \param maxIters largest number of refinement steps.
+ * \return number of refinement steps taken, REFINE_NOT_CONVERGED if tol was not reached, or -1 on error.
+ */
+int BlockTridiagRefinedSolve(BlockTridiag * A, BlockTridiagLU * LU, const gsl_vector * b, gsl_vector * x, 
+                             gsl_vector * r, double tol, int maxIters);
+
+/**
+ * \brief Solve Ax = b using block Thomas algorithm.
+ *
+ * Convenience function that factors A and solves for a single right hand side.
+ * \param A pointer to matrix (not modified).
+ * \param b right hand side on input, solution on output.
+ * \return Error code (0 = success).
+ */
+int BlockTridiagSolve(BlockTridiag * A, gsl_vector * b);
+
+#endif
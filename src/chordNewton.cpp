@@ -0,0 +1,238 @@
+//--------------------------------------------------
+// chordNewton: Newton steps with a lagged, Broyden 
+// updated Jacobian. 
+//
+// 10/17/2026 - Written for Jacobian reuse across time steps.
+// 10/17/2026 - Refactor when the local time scales change.
+// 10/17/2026 - Optional mixed precision solves.
+// 10/17/2026 - Colored Jacobian on all threads.
+// 10/17/2026 - Failed residual evaluations returned as GSL_EBADFUNC.
+// 10/17/2026 - Factor in double when the refinement does not converge.
+//--------------------------------------------------
+#include<stdlib.h>
+#include<math.h>
+#include<gsl/gsl_errno.h>
+#include<gsl/gsl_blas.h>
+#include"chordNewton.h"
+#include"jacobian.h"
+#include"fdJacobian.h"
+#include"adJacobian.h"
+using namespace std;
+
+ChordNewton * ChordNewtonAlloc(unsigned int n, solverOptions * solverOpts)
+{
+	ChordNewton * C = new ChordNewton;
+	C->J = BlockTridiagAlloc(n);
+	bool mixed = (solverOpts->precision == "mixed");
+	C->LU = mixed ? BlockTridiagLUAllocSingle(n) : BlockTridiagLUAlloc(n);
+	C->maxAge = solverOpts->jacMaxAge;
+	C->dtChange = solverOpts->jacDtChange;
+	C->maxRatio = solverOpts->jacRatio;
+	C->broyden = solverOpts->broyden;
+	C->jacobian = solverOpts->jacobian;
+	C->age = -1;
+	C->deltaT = 0.0;
+	C->localDt = NULL;
+	C->stale = false;
+	C->nUpdates = 0;
+	C->s = (gsl_vector **)malloc(C->maxAge*sizeof(gsl_vector *));
+	C->u = (gsl_vector **)malloc(C->maxAge*sizeof(gsl_vector *));
+	for (int j = 0; j < C->maxAge; j++)
+	{
+		C->s[j] = C->broyden ? gsl_vector_alloc(BLOCK_SIZE*n) : NULL;
+		C->u[j] = C->broyden ? gsl_vector_alloc(BLOCK_SIZE*n) : NULL;
+	}
+	C->f0 = gsl_vector_alloc(BLOCK_SIZE*n);
+	C->dx = gsl_vector_alloc(BLOCK_SIZE*n);
+	C->z = gsl_vector_alloc(BLOCK_SIZE*n);
+	C->rhs = mixed ? gsl_vector_alloc(BLOCK_SIZE*n) : NULL;
+	C->r = mixed ? gsl_vector_alloc(BLOCK_SIZE*n) : NULL;
+	C->LUDouble = NULL;
+	C->doubleFactored = false;
+	C->solveCount = 0;
+	C->doubleCount = 0;
+	C->refineCount = 0;
+	C->refactorCount = 0;
+	C->stepCount = 0;
+	return C;
+}
+
+void ChordNewtonFree(ChordNewton * C)
+{
+	for (int j = 0; j < C->maxAge; j++)
+	{
+		if (C->s[j])
+			gsl_vector_free(C->s[j]);
+		if (C->u[j])
+			gsl_vector_free(C->u[j]);
+	}
+	free(C->s);
+	free(C->u);
+	gsl_vector_free(C->f0);
+	gsl_vector_free(C->dx);
+	gsl_vector_free(C->z);
+	if (C->rhs)
+		gsl_vector_free(C->rhs);
+	if (C->r)
+		gsl_vector_free(C->r);
+	if (C->localDt)
+		gsl_vector_free(C->localDt);
+	BlockTridiagFree(C->J);
+	BlockTridiagLUFree(C->LU);
+	if (C->LUDouble)
+		BlockTridiagLUFree(C->LUDouble);
+	delete C;
+}
+
+int ChordNewtonApply(ChordNewton * C, gsl_vector * w)
+{
+	if (C->LU->single)
+	{
+		gsl_vector_memcpy(C->rhs,w);
+		int iters = C->doubleFactored ? REFINE_NOT_CONVERGED :
+			BlockTridiagRefinedSolve(C->J,C->LU,C->rhs,w,C->r,REFINE_TOL,REFINE_MAX_ITERS);
+		if (iters == REFINE_NOT_CONVERGED)
+		{
+			// The single precision factors are too far from J to refine, so J is factored in double,
+			// and those factors are used until the next refactorization.
+			if (!C->LUDouble)
+				C->LUDouble = BlockTridiagLUAlloc(C->J->n);
+			if (!C->doubleFactored && BlockTridiagFactor(C->J,C->LUDouble))
+				return 1;
+			C->doubleFactored = true;
+			gsl_vector_memcpy(w,C->rhs);
+			if (BlockTridiagLUSolve(C->LUDouble,w,w))
+				return 1;
+			C->doubleCount++;
+		}
+		else if (iters < 0)
+			return 1;
+		else
+		{
+			C->solveCount++;
+			C->refineCount += iters;
+		}
+	}
+	else if (BlockTridiagLUSolve(C->LU,w,w))
+		return 1;
+	// w = (I + u_j s_j^T) w, for each update in the order they were made.
+	for (int j = 0; j < C->nUpdates; j++)
+	{
+		double sw;
+		gsl_blas_ddot(C->s[j],w,&sw);
+		gsl_blas_daxpy(sw,C->u[j],w);
+	}
+	return 0;
+}
+
+// Form and factor the Jacobian at x, dropping all Broyden updates. C->f0 = F(x).
+static int ChordNewtonRefactor(ChordNewton * C, const gsl_vector * x, FParams * params)
+{
+	if (C->jacobian == "colored")
+	{
+		if (ColoredFDJacobianThreads(x,C->f0,params,C->J))
+			return 1;
+	}
+	else if (C->jacobian == "ad")
+	{
+		if (ADJacobian(x,params,C->J))
+			return 1;
+	}
+	else if (SysJ(x,params,C->J))
+		return 1;
+	C->refactorCount++;
+	C->age = 0;
+	C->deltaT = params->deltaT;
+	if (params->localDt && !C->localDt)
+		C->localDt = gsl_vector_alloc(x->size);
+	if (params->localDt)
+		gsl_vector_memcpy(C->localDt,params->localDt);
+	C->stale = false;
+	C->nUpdates = 0;
+	C->doubleFactored = false;
+	return BlockTridiagFactor(C->J,C->LU);
+}
+
+// The local time scales change with the solution, and the lagged J keeps those it was formed with.
+static bool LocalDtChanged(ChordNewton * C, const gsl_vector * localDt)
+{
+	if (!localDt)
+		return false;
+	if (!C->localDt)
+		return true;
+	for (unsigned int j = 0; j < localDt->size; j++)
+		if (!(fabs(gsl_vector_get(localDt,j)/gsl_vector_get(C->localDt,j) - 1.0) <= C->dtChange))
+			return true;
+	return false;
+}
+
+static bool ChordNewtonNeedsRefactor(ChordNewton * C, FParams * params)
+{
+	// deltaT may be INFINITY for steady steps, so compare with !(<=) to catch NaN ratios.
+	double deltaT = params->deltaT;
+	return C->age < 0 || C->age >= C->maxAge || C->stale ||
+	       (deltaT != C->deltaT && !(fabs(deltaT/C->deltaT - 1.0) <= C->dtChange)) ||
+	       (isfinite(deltaT) && LocalDtChanged(C,params->localDt));
+}
+
+// Broyden update with the step s = C->dx and y = f - f0.
+static void ChordNewtonUpdate(ChordNewton * C, const gsl_vector * f)
+{
+	if (!C->broyden || C->nUpdates >= C->maxAge)
+		return;
+	gsl_vector_memcpy(C->z,f);
+	gsl_vector_sub(C->z,C->f0);
+	if (ChordNewtonApply(C,C->z))
+		return;
+	double denom;
+	gsl_blas_ddot(C->dx,C->z,&denom);
+	if (denom == 0.0 || !isfinite(denom))
+		return;
+
+	int j = C->nUpdates;
+	gsl_vector_memcpy(C->s[j],C->dx);
+	gsl_vector_memcpy(C->u[j],C->dx);
+	gsl_vector_sub(C->u[j],C->z);
+	gsl_vector_scale(C->u[j],1/denom);
+	C->nUpdates++;
+}
+
+int ChordNewtonStep(gsl_vector * x, FParams * params, ChordNewton * C, const gsl_vector * fx, gsl_vector * f)
+{
+	bool refactor = ChordNewtonNeedsRefactor(C,params);
+	double ratio = 0.0;
+	C->stepCount++;
+	if (fx)
+		gsl_vector_memcpy(C->f0,fx);
+	else if (SysF(x,params,C->f0))
+		return GSL_EBADFUNC;
+	double f0norm = gsl_blas_dnrm2(C->f0);
+	for (;;)
+	{
+		if (refactor && ChordNewtonRefactor(C,x,params))
+			return GSL_ESING;
+
+		// Solve B*dx = -F(x) and evaluate the residual at x + dx.
+		gsl_vector_memcpy(C->dx,C->f0);
+		gsl_vector_scale(C->dx,-1.0);
+		if (ChordNewtonApply(C,C->dx))
+			return GSL_ESING;
+		gsl_vector_memcpy(C->z,x);
+		gsl_vector_add(C->z,C->dx);
+		if (SysF(C->z,params,f))
+			return GSL_EBADFUNC;
+		ratio = gsl_blas_dnrm2(f)/f0norm;
+
+		// A lagged Jacobian that increases the residual is not worth keeping.
+		if (refactor || ratio < 1.0)
+			break;
+		Log(logDEBUG) << "Residual increased with lagged Jacobian, refactoring";
+		refactor = true;
+	}
+
+	C->age++;
+	C->stale = !(ratio <= C->maxRatio);
+	ChordNewtonUpdate(C,f);
+	gsl_vector_add(x,C->dx);
+	return GSL_SUCCESS;
+}
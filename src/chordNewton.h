@@ -0,0 +1,92 @@
+/**
+ * \file
+ *
+ * \brief Newton steps that reuse the factored Jacobian across pseudo-time steps.
+ *
+ * Forming and factoring the analytic Jacobian is most of the cost of a Newton step. The
+ * chord method keeps the factorization of an old Jacobian \f$B_0\f$ and corrects it with
+ * rank one (good) Broyden updates,
+ * \f[ B_{j+1}^{-1} = B_j^{-1} + \frac{(s_j - B_j^{-1}y_j)s_j^TB_j^{-1}}{s_j^TB_j^{-1}y_j}, \f]
+ * which are stored as pairs of vectors and applied after the block tridiagonal solve.
+ * The Jacobian is refactored when it gets too old, when \f$\Delta t\f$ changes too much or
+ * when the residual stops dropping fast enough.
+ *
+ * With precision = mixed the factorization is kept in single precision, and each solve is
+ * refined against the double precision Jacobian (BlockTridiagRefinedSolve).
+ */
+#ifndef CHORDNEWTON_H
+#define CHORDNEWTON_H
+#include<gsl/gsl_vector.h>
+#include"systemSolve.h"
+#include"blockTridiag.h"
+#include"setup.h"
+using namespace std;
+
+/**
+ * \brief Lagged Jacobian, its Broyden updates and the policy for refactoring it.
+ */
+struct ChordNewton {
+	BlockTridiag * J; /**< last Jacobian formed. */
+	BlockTridiagLU * LU; /**< factorization of J. */
+	int maxAge; /**< refactor after this many steps (1 = Newton's method). */
+	double dtChange; /**< refactor when \f$|\Delta t/\Delta t_J - 1|\f$ is above this. */
+	double maxRatio; /**< refactor when \f$\|F(x_{new})\|/\|F(x)\|\f$ is above this. */
+	bool broyden; /**< apply Broyden updates between refactorizations. */
+	string jacobian; /**< how J is formed: "analytic" (SysJ), "colored" (ColoredFDJacobianThreads) or "ad" (ADJacobian). */
+	int age; /**< steps taken with the current factorization (-1 = not factored). */
+	double deltaT; /**< \f$\Delta t\f$ when J was formed. */
+	gsl_vector * localDt; /**< local time scales when J was formed, NULL for a global step. */
+	bool stale; /**< the last step reduced the residual too little. */
+	int nUpdates; /**< number of stored Broyden updates. */
+	gsl_vector ** s; /**< Newton steps of the updates. */
+	gsl_vector ** u; /**< \f$(s_j - B_j^{-1}y_j)/(s_j^TB_j^{-1}y_j)\f$ of the updates. */
+	gsl_vector * f0; /**< work vector for F(x). */
+	gsl_vector * dx; /**< work vector for the step. */
+	gsl_vector * z; /**< work vector for \f$B^{-1}y\f$. */
+	gsl_vector * rhs; /**< right hand side of the refined solves (mixed precision only). */
+	gsl_vector * r; /**< residual of the refined solves (mixed precision only). */
+	BlockTridiagLU * LUDouble; /**< double precision factorization of J once a refined solve did not converge (NULL until then). */
+	bool doubleFactored; /**< LUDouble holds the factors of the current J. */
+	int solveCount; /**< number of refined solves. */
+	int doubleCount; /**< solves with LUDouble. */
+	int refineCount; /**< number of refinement steps in all solves. */
+	int refactorCount; /**< number of times the Jacobian has been factored. */
+	int stepCount; /**< number of steps taken. */
+};
+
+/**
+ * \brief Allocate a chord Newton solver for n grid points.
+ * \param n number of grid points.
+ * \param solverOpts pointer to solver options (jacobian, jac_max_age, jac_dt_change, jac_ratio, broyden, precision).
+ * \return pointer to new solver.
+ */
+ChordNewton * ChordNewtonAlloc(unsigned int n, solverOptions * solverOpts);
+
+/**
+ * \brief Free a chord Newton solver.
+ * \param C pointer to solver.
+ */
+void ChordNewtonFree(ChordNewton * C);
+
+/**
+ * \brief Applies the current approximate inverse Jacobian, \f$w = B^{-1}w\f$.
+ * \param C pointer to solver.
+ * \param w vector, overwritten with the result.
+ * \return Error code (0 = success).
+ */
+int ChordNewtonApply(ChordNewton * C, gsl_vector * w);
+
+/**
+ * \brief One Newton step with the lagged Jacobian.
+ *
+ * If a step with the lagged Jacobian increases the residual it is retaken with a new one.
+ * \param x current iterate on input, updated iterate on output.
+ * \param params parameters of the system.
+ * \param C pointer to solver.
+ * \param fx F(x), or NULL to have it evaluated.
+ * \param f residual at the updated x.
+ * \return Error code (0 = success).
+ */
+int ChordNewtonStep(gsl_vector * x, FParams * params, ChordNewton * C, const gsl_vector * fx, gsl_vector * f);
+
+#endif
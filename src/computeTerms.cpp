@@ -2,133 +2,456 @@
 // computeTerms: Compute terms T,L,P,vT and f(0),ep(0).
 // 
 // 12/3/2016 - (gry88) Writen for final project CSE380.  
+// 10/17/2026 - Templated on the vector type for dual numbers.
+// 10/17/2026 - Local time scales for local pseudo time steps.
+// 10/17/2026 - T, L and vT on the field arrays.
+// 10/17/2026 - Vectorized batch kernels for T, L and vT with runtime dispatch.
+// 10/17/2026 - ComputeFieldTerms on a range of points, for one range per thread.
+// 10/17/2026 - Non-finite terms are logged and returned to the caller instead of exiting.
+// 10/17/2026 - Bounds of k, ep and v2 in computeTerms.h, with Limit.
 //-------------------------------------------------- 
 #include<gsl/gsl_vector.h>
 #include<math.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include<immintrin.h>
+#define TERMS_X86
+#endif
 #include"setup.h"
 #include"finiteDiff.h"
+#include"computeTerms.h"
 using namespace std;
 
-#define EP_MIN 1.0e-7
-#define K_MIN  1.0e-7
-#define V2_MIN 1.0e-12
 #define T_MIN  1.0e-7
 #define L_MIN  1.0e-5
 #define F_MIN  1.0e-8
 
-double ComputeT(gsl_vector * xi, constants * modelConst,int i)
+// T from k and ep at one point, shared by ComputeT and ComputeFieldTerms.
+template<class S>
+static S TimeScale(S kIn, S epIn, constants * modelConst)
 {
-	double firstTerm,secondTerm; //1st and 2nd term as in documentation. 
-	double xiCounter = 5*(i-1);  //counter relative to xi. 	
-	
-	Log(logDEBUG1) << "Computing T";	
-
-	double k = fmax(gsl_vector_get(xi,xiCounter+1),K_MIN);
-	double ep = fmax(gsl_vector_get(xi,xiCounter+2),EP_MIN);
+	S firstTerm,secondTerm; //1st and 2nd term as in documentation. 
+	S k = fmax(kIn,K_MIN);
+	S ep = fmax(epIn,EP_MIN);
 
 	firstTerm = k/ep;
 	if (!isfinite(firstTerm))
 	{
 		Log(logERROR) << "Error: T non-finite (" << firstTerm << ")";
-		Log(logERROR) << "-Note ep = " << gsl_vector_get(xi,xiCounter+2) << " at " << i;
-		exit(1);
+		Log(logERROR) << "-Note ep = " << epIn;
+		return firstTerm;
 	}
 
 	secondTerm = 6*sqrt(1/(modelConst->reyn*ep));
 	if(!isfinite(secondTerm))
 	{
 		Log(logERROR) << "Error: T non-finite (" << secondTerm << ")";
-		Log(logERROR) << "Note ep = " << gsl_vector_get(xi,xiCounter+2) << " at " << i;
-		exit(1);
+		Log(logERROR) << "Note ep = " << epIn;
+		return secondTerm;
 	}
 
 	return fmax(fmax(firstTerm,secondTerm),T_MIN);
 }
 
-double ComputeL(gsl_vector * xi,constants * modelConst,int i)
+// L from k and ep at one point, shared by ComputeL and ComputeFieldTerms.
+template<class S>
+static S LengthScale(S kIn, S epIn, constants * modelConst)
 {
-	double firstTerm,secondTerm; //see doc.  
-	double xiCounter = 5*(i-1); //counter relative to xi.  
-
-	double k = fmax(gsl_vector_get(xi,xiCounter+1),K_MIN);
-	double ep = fmax(gsl_vector_get(xi,xiCounter+2),EP_MIN);
+	S firstTerm,secondTerm; //see doc.  
+	S k = fmax(kIn,K_MIN);
+	S ep = fmax(epIn,EP_MIN);
 
-	Log(logDEBUG1) << "Computing L";
-	firstTerm = pow(k,1.5)/ep;
+	firstTerm = k*sqrt(k)/ep;
 	if (!isfinite(firstTerm))
 	{
 		Log(logERROR) << "Error: L non-finite (" << firstTerm << ")";
-		exit(1);
+		return firstTerm;
 	}
 		
-		
-	secondTerm = modelConst->Ceta*pow(1/(pow(modelConst->reyn,3)*ep),0.25);
+	secondTerm = modelConst->Ceta*sqrt(sqrt(1/(pow(modelConst->reyn,3)*ep)));
 	if (!isfinite(secondTerm))
 	{
 		Log(logERROR) << "Error: L non-finite (" << secondTerm << ")";
-		exit(1);
+		return secondTerm;
 	}
 
 	return fmax(modelConst->CL*fmax(firstTerm,secondTerm),L_MIN);
 }
 
-double ComputeEddyVisc(gsl_vector * xi, gsl_vector * T, constants * modelConst,int i)
+template<class V>
+VecScalar<V> ComputeT(V * xi, constants * modelConst,int i)
 {
-	double val; 
-	double xiCounter = 5*(i-1); //counter relative to xi. -1 since U starts a 0. 
+	unsigned int xiCounter = 5*(i-1);  //counter relative to xi. 	
+	Log(logDEBUG1) << "Computing T";	
+	return TimeScale(VecGet(xi,xiCounter+1),VecGet(xi,xiCounter+2),modelConst);
+}
 
-	double v2 = fmax(gsl_vector_get(xi,xiCounter+3),V2_MIN);
+template<class V>
+VecScalar<V> ComputeL(V * xi,constants * modelConst,int i)
+{
+	unsigned int xiCounter = 5*(i-1); //counter relative to xi.  
+	Log(logDEBUG1) << "Computing L";
+	return LengthScale(VecGet(xi,xiCounter+1),VecGet(xi,xiCounter+2),modelConst);
+}
+
+template<class V>
+VecScalar<V> ComputeEddyVisc(V * xi, V * T, constants * modelConst,int i)
+{
+	VecScalar<V> val; 
+	unsigned int xiCounter = 5*(i-1); //counter relative to xi. -1 since U starts a 0. 
+
+	VecScalar<V> v2 = fmax(VecGet(xi,xiCounter+3),V2_MIN);
 
 	Log(logDEBUG1) << "Computing Eddy Viscosity";
-	val = modelConst->Cmu*v2*gsl_vector_get(T,i);
+	val = modelConst->Cmu*v2*VecGet(T,i);
 	if (!isfinite(val))
 	{
 		Log(logERROR) << "Error: vT non-finite (" << val << ")";
-		exit(1);
 	}
 	return val; 
 }
 
-double ComputeP(gsl_vector * xi, gsl_vector* vT, Grid* grid, int i)
+template<class V>
+VecScalar<V> ComputeP(V * xi, V * vT, Grid* grid, int i)
 {
-	double val; 
+	VecScalar<V> val; 
 
 	Log(logDEBUG1) << "Computing P";
 
 	//note: Diff1 takes xi-counter indices
-	val = gsl_vector_get(vT,i)*pow(Deriv1(xi,0.0,5*(i-1),grid),2);
+	val = VecGet(vT,i)*pow(Deriv1(xi,0.0,5*(i-1),grid),2);
 	if (!isfinite(val))
 	{
 		Log(logERROR) << "Error: P non-finite (" << val << ")";
-		exit(1);
 	}
 	return val; 
 }
 
-double ComputeEp0(gsl_vector * xi,constants * modelConst, Grid* grid)
+template<class V>
+VecScalar<V> ComputeEp0(V * xi,constants * modelConst, Grid* grid)
 {
 	Log(logDEBUG1) << "Compute dissipation at wall boundary";
 	double delta_y_0 = gsl_vector_get(grid->y, 0);
-	double ep0 = ((2*gsl_vector_get(xi,1))/(modelConst->reyn*pow(delta_y_0,2)));
+	VecScalar<V> ep0 = ((2*VecGet(xi,1))/(modelConst->reyn*pow(delta_y_0,2)));
 	if (!isfinite(ep0)) //|| ep0 < 0)
 	{
 		Log(logERROR) << "Error: unacceptable ep0 (" << ep0 << ")";
-		exit(1); 
 	}
 	return ep0; 
 }
 
-double Computef0(gsl_vector * xi,constants * modelConst, Grid* grid)
+template<class V>
+VecScalar<V> Computef0(V * xi,constants * modelConst, Grid* grid)
 {
 	Log(logDEBUG1)<<"Compute f at wall boundary";
         double delta_y_0 = gsl_vector_get(grid->y, 0);
-	double f0  = -(20*gsl_vector_get(xi,3))/
+	VecScalar<V> f0  = -(20*VecGet(xi,3))/
                     (pow(modelConst->reyn,2) *
                      ComputeEp0(xi, modelConst, grid) * pow(delta_y_0, 4));
 	if(!isfinite(f0))
 	{
 		Log(logERROR) << "Error: f0 non-finite (" << f0 << ")";
-		exit(1);
 	}
 	return f0; 
 }
+
+// The batch kernels below evaluate T, L and vT exactly as TimeScale, LengthScale and 
+// ComputeEddyVisc do, operation by operation, so every kernel gives the same bits. The limits
+// are clamped with max (which, like fmax, returns the limit for a NaN input) and the terms are
+// tested for finiteness once per batch by summing term*0, which is only finite if all are.
+int ComputeTermsScalar(const double * k, const double * ep, const double * v2, double * T,
+                       double * L, double * vT, unsigned int n, constants * modelConst)
+{
+	double reyn = modelConst->reyn, reyn3 = pow(modelConst->reyn,3);
+	double check = 0;
+	for (unsigned int j = 0; j < n; j++)
+	{
+		double kj = (k[j] > K_MIN) ? k[j] : K_MIN;
+		double epj = (ep[j] > EP_MIN) ? ep[j] : EP_MIN;
+		double v2j = (v2[j] > V2_MIN) ? v2[j] : V2_MIN;
+
+		double t1 = kj/epj;
+		double t2 = 6*sqrt(1/(reyn*epj));
+		double t = (t1 > t2) ? t1 : t2;
+		T[j] = (t > T_MIN) ? t : T_MIN;
+
+		double l1 = kj*sqrt(kj)/epj;
+		double l2 = modelConst->Ceta*sqrt(sqrt(1/(reyn3*epj)));
+		double l = modelConst->CL*((l1 > l2) ? l1 : l2);
+		L[j] = (l > L_MIN) ? l : L_MIN;
+
+		vT[j] = modelConst->Cmu*v2j*T[j];
+		check += t1*0 + t2*0 + l1*0 + l2*0 + vT[j]*0;
+	}
+	return !isfinite(check);
+}
+
+#ifdef TERMS_X86
+__attribute__((target("avx2")))
+static int ComputeTermsAVX2(const double * k, const double * ep, const double * v2, double * T,
+                            double * L, double * vT, unsigned int n, constants * modelConst)
+{
+	unsigned int n4 = n - n%4;
+	__m256d kMin = _mm256_set1_pd(K_MIN), epMin = _mm256_set1_pd(EP_MIN), v2Min = _mm256_set1_pd(V2_MIN);
+	__m256d tMin = _mm256_set1_pd(T_MIN), lMin = _mm256_set1_pd(L_MIN);
+	__m256d one = _mm256_set1_pd(1.0), six = _mm256_set1_pd(6.0), zero = _mm256_setzero_pd();
+	__m256d reyn = _mm256_set1_pd(modelConst->reyn), reyn3 = _mm256_set1_pd(pow(modelConst->reyn,3));
+	__m256d Ceta = _mm256_set1_pd(modelConst->Ceta), CL = _mm256_set1_pd(modelConst->CL);
+	__m256d Cmu = _mm256_set1_pd(modelConst->Cmu);
+	__m256d check = zero;
+	for (unsigned int j = 0; j < n4; j += 4)
+	{
+		__m256d kj = _mm256_max_pd(_mm256_loadu_pd(k+j),kMin);
+		__m256d epj = _mm256_max_pd(_mm256_loadu_pd(ep+j),epMin);
+		__m256d v2j = _mm256_max_pd(_mm256_loadu_pd(v2+j),v2Min);
+
+		__m256d t1 = _mm256_div_pd(kj,epj);
+		__m256d t2 = _mm256_mul_pd(six,_mm256_sqrt_pd(_mm256_div_pd(one,_mm256_mul_pd(reyn,epj))));
+		__m256d t = _mm256_max_pd(_mm256_max_pd(t1,t2),tMin);
+		_mm256_storeu_pd(T+j,t);
+
+		__m256d l1 = _mm256_div_pd(_mm256_mul_pd(kj,_mm256_sqrt_pd(kj)),epj);
+		__m256d l2 = _mm256_mul_pd(Ceta,_mm256_sqrt_pd(_mm256_sqrt_pd(_mm256_div_pd(one,_mm256_mul_pd(reyn3,epj)))));
+		_mm256_storeu_pd(L+j,_mm256_max_pd(_mm256_mul_pd(CL,_mm256_max_pd(l1,l2)),lMin));
+
+		__m256d v = _mm256_mul_pd(_mm256_mul_pd(Cmu,v2j),t);
+		_mm256_storeu_pd(vT+j,v);
+		check = _mm256_add_pd(check,_mm256_mul_pd(_mm256_add_pd(_mm256_add_pd(t1,t2),
+			_mm256_add_pd(_mm256_add_pd(l1,l2),v)),zero));
+	}
+	double c[4];
+	_mm256_storeu_pd(c,check);
+	int status = ComputeTermsScalar(k+n4,ep+n4,v2+n4,T+n4,L+n4,vT+n4,n-n4,modelConst);
+	return status || !isfinite(c[0]+c[1]+c[2]+c[3]);
+}
+
+// GCC 12 warns about the deliberately undefined vectors inside the AVX-512 intrinsics.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+__attribute__((target("avx512f")))
+static int ComputeTermsAVX512(const double * k, const double * ep, const double * v2, double * T,
+                              double * L, double * vT, unsigned int n, constants * modelConst)
+{
+	unsigned int n8 = n - n%8;
+	__m512d kMin = _mm512_set1_pd(K_MIN), epMin = _mm512_set1_pd(EP_MIN), v2Min = _mm512_set1_pd(V2_MIN);
+	__m512d tMin = _mm512_set1_pd(T_MIN), lMin = _mm512_set1_pd(L_MIN);
+	__m512d one = _mm512_set1_pd(1.0), six = _mm512_set1_pd(6.0), zero = _mm512_setzero_pd();
+	__m512d reyn = _mm512_set1_pd(modelConst->reyn), reyn3 = _mm512_set1_pd(pow(modelConst->reyn,3));
+	__m512d Ceta = _mm512_set1_pd(modelConst->Ceta), CL = _mm512_set1_pd(modelConst->CL);
+	__m512d Cmu = _mm512_set1_pd(modelConst->Cmu);
+	__m512d check = zero;
+	for (unsigned int j = 0; j < n8; j += 8)
+	{
+		__m512d kj = _mm512_max_pd(_mm512_loadu_pd(k+j),kMin);
+		__m512d epj = _mm512_max_pd(_mm512_loadu_pd(ep+j),epMin);
+		__m512d v2j = _mm512_max_pd(_mm512_loadu_pd(v2+j),v2Min);
+
+		__m512d t1 = _mm512_div_pd(kj,epj);
+		__m512d t2 = _mm512_mul_pd(six,_mm512_sqrt_pd(_mm512_div_pd(one,_mm512_mul_pd(reyn,epj))));
+		__m512d t = _mm512_max_pd(_mm512_max_pd(t1,t2),tMin);
+		_mm512_storeu_pd(T+j,t);
+
+		__m512d l1 = _mm512_div_pd(_mm512_mul_pd(kj,_mm512_sqrt_pd(kj)),epj);
+		__m512d l2 = _mm512_mul_pd(Ceta,_mm512_sqrt_pd(_mm512_sqrt_pd(_mm512_div_pd(one,_mm512_mul_pd(reyn3,epj)))));
+		_mm512_storeu_pd(L+j,_mm512_max_pd(_mm512_mul_pd(CL,_mm512_max_pd(l1,l2)),lMin));
+
+		__m512d v = _mm512_mul_pd(_mm512_mul_pd(Cmu,v2j),t);
+		_mm512_storeu_pd(vT+j,v);
+		check = _mm512_add_pd(check,_mm512_mul_pd(_mm512_add_pd(_mm512_add_pd(t1,t2),
+			_mm512_add_pd(_mm512_add_pd(l1,l2),v)),zero));
+	}
+	int status = ComputeTermsScalar(k+n8,ep+n8,v2+n8,T+n8,L+n8,vT+n8,n-n8,modelConst);
+	return status || !isfinite(_mm512_reduce_add_pd(check));
+}
+#pragma GCC diagnostic pop
+#endif
+
+termsKernel TermsKernelBest()
+{
+#ifdef TERMS_X86
+	if (__builtin_cpu_supports("avx512f"))
+		return TERMS_AVX512;
+	if (__builtin_cpu_supports("avx2"))
+		return TERMS_AVX2;
+#endif
+	return TERMS_SCALAR;
+}
+
+const char * TermsKernelName(termsKernel kernel)
+{
+	switch (kernel)
+	{
+		case TERMS_AVX512: return "avx512";
+		case TERMS_AVX2: return "avx2";
+		default: return "scalar";
+	}
+}
+
+int ComputeTermsBatch(const double * k, const double * ep, const double * v2, double * T,
+                      double * L, double * vT, unsigned int n, constants * modelConst, termsKernel kernel)
+{
+#ifdef TERMS_X86
+	if (kernel == TERMS_AVX512 && __builtin_cpu_supports("avx512f"))
+		return ComputeTermsAVX512(k,ep,v2,T,L,vT,n,modelConst);
+	if (kernel >= TERMS_AVX2 && __builtin_cpu_supports("avx2"))
+		return ComputeTermsAVX2(k,ep,v2,T,L,vT,n,modelConst);
+#endif
+	return ComputeTermsScalar(k,ep,v2,T,L,vT,n,modelConst);
+}
+
+// Dual numbers have no batch kernel.
+template<class S>
+static int FieldTermsBatch(Fields<S> * F, constants * modelConst, unsigned int first, unsigned int last)
+{
+	return 1;
+}
+
+static int FieldTermsBatch(Fields<double> * F, constants * modelConst, unsigned int first, unsigned int last)
+{
+	static termsKernel kernel = TermsKernelBest();
+	return ComputeTermsBatch(F->k+first,F->ep+first,F->v2+first,F->T+first,F->L+first,F->vT+first,
+		last-first,modelConst,kernel);
+}
+
+template<class S>
+int ComputeFieldTerms(Fields<S> * F, constants * modelConst, unsigned int first, unsigned int last)
+{
+	Log(logDEBUG1) << "Computing T, L and vT";
+	last = (last < F->size) ? last : F->size;
+	if (first >= last || !FieldTermsBatch(F,modelConst,first,last))
+		return 0;
+
+	// Point by point, which also reports the first term that is not finite.
+	for (unsigned int i = first; i < last; i++)
+	{
+		F->T[i] = TimeScale(F->k[i],F->ep[i],modelConst);
+		F->L[i] = LengthScale(F->k[i],F->ep[i],modelConst);
+		F->vT[i] = modelConst->Cmu*fmax(F->v2[i],V2_MIN)*F->T[i];
+		if (!isfinite(F->vT[i]))
+		{
+			Log(logERROR) << "Error: vT non-finite (" << F->vT[i] << ")";
+			return 1;
+		}
+	}
+	return 0;
+}
+
+double ComputeTDerivs(gsl_vector * xi, constants * modelConst, int i, double * dTdk, double * dTdep)
+{
+	double firstTerm,secondTerm; //as in ComputeT.
+	unsigned int xiCounter = 5*(i-1); 
+	double T = ComputeT(xi,modelConst,i);
+
+	//the lower limits are flat, so they contribute nothing to the derivative.
+	double dk = (gsl_vector_get(xi,xiCounter+1) > K_MIN) ? 1.0 : 0.0;
+	double dep = (gsl_vector_get(xi,xiCounter+2) > EP_MIN) ? 1.0 : 0.0;
+	double k = fmax(gsl_vector_get(xi,xiCounter+1),K_MIN);
+	double ep = fmax(gsl_vector_get(xi,xiCounter+2),EP_MIN);
+
+	firstTerm = k/ep;
+	secondTerm = 6*sqrt(1/(modelConst->reyn*ep));
+
+	*dTdk = 0.0;
+	*dTdep = 0.0;
+	if (fmax(firstTerm,secondTerm) < T_MIN)
+		return T;
+	if (firstTerm >= secondTerm)
+	{
+		*dTdk = dk/ep;
+		*dTdep = -dep*firstTerm/ep;
+	}
+	else
+		*dTdep = -dep*0.5*secondTerm/ep;
+	return T;
+}
+
+double ComputeLDerivs(gsl_vector * xi, constants * modelConst, int i, double * dLdk, double * dLdep)
+{
+	double firstTerm,secondTerm; //as in ComputeL.
+	unsigned int xiCounter = 5*(i-1); 
+	double L = ComputeL(xi,modelConst,i);
+
+	double dk = (gsl_vector_get(xi,xiCounter+1) > K_MIN) ? 1.0 : 0.0;
+	double dep = (gsl_vector_get(xi,xiCounter+2) > EP_MIN) ? 1.0 : 0.0;
+	double k = fmax(gsl_vector_get(xi,xiCounter+1),K_MIN);
+	double ep = fmax(gsl_vector_get(xi,xiCounter+2),EP_MIN);
+
+	firstTerm = k*sqrt(k)/ep;
+	secondTerm = modelConst->Ceta*sqrt(sqrt(1/(pow(modelConst->reyn,3)*ep)));
+
+	*dLdk = 0.0;
+	*dLdep = 0.0;
+	if (modelConst->CL*fmax(firstTerm,secondTerm) < L_MIN)
+		return L;
+	if (firstTerm >= secondTerm)
+	{
+		*dLdk = modelConst->CL*dk*1.5*sqrt(k)/ep;
+		*dLdep = -modelConst->CL*dep*firstTerm/ep;
+	}
+	else
+		*dLdep = -modelConst->CL*dep*0.25*secondTerm/ep;
+	return L;
+}
+
+double ComputeEddyViscDerivs(gsl_vector * xi, gsl_vector * T, constants * modelConst, int i,
+                             double dTdk, double dTdep, double * dvT)
+{
+	unsigned int xiCounter = 5*(i-1); 
+	double vT = ComputeEddyVisc(xi,T,modelConst,i);
+	double v2 = fmax(gsl_vector_get(xi,xiCounter+3),V2_MIN);
+
+	dvT[0] = modelConst->Cmu*v2*dTdk;
+	dvT[1] = modelConst->Cmu*v2*dTdep;
+	dvT[2] = (gsl_vector_get(xi,xiCounter+3) > V2_MIN) ? modelConst->Cmu*gsl_vector_get(T,i) : 0.0;
+	return vT;
+}
+
+void ComputeLocalDt(gsl_vector * xi, constants * modelConst, Grid * grid, gsl_vector * dt)
+{
+	unsigned int size = xi->size/5 + 1;
+	double nu = 1/modelConst->reyn;
+	for (unsigned int i = 1; i < size; i++)
+	{
+		unsigned int xiCounter = 5*(i-1);
+		double T = ComputeT(xi,modelConst,i);
+		double L = ComputeL(xi,modelConst,i);
+		double vT = modelConst->Cmu*fmax(gsl_vector_get(xi,xiCounter+3),V2_MIN)*T;
+
+		// Diffusion across the local spacing h = dchi/(dchi/dy), 2D/h^2, and the decay rate of 
+		// each equation.
+		double delta = gsl_vector_get(grid->chi,0);
+		double a1 = grid->metric1[i-1];
+		double b = 2*a1*a1/(delta*delta);
+		double rate[5] = {
+			b*(nu + vT),
+			b*(nu + vT) + 1/T,
+			b*(nu + vT/modelConst->sigmaEp) + modelConst->Cep2/T,
+			b*(nu + vT) + 1/T,
+			b*L*L + 1};
+		for (unsigned int m = 0; m < 5; m++)
+			gsl_vector_set(dt,xiCounter+m,1/rate[m]);
+	}
+	gsl_vector_scale(dt,1/gsl_vector_max(dt));
+}
+
+// Instantiations for residuals in double (gsl_vector) and dual numbers (DualVector).
+#define INSTANTIATE_COMPUTETERMS(V) \
+	template VecScalar<V> ComputeT(V *,constants *,int); \
+	template VecScalar<V> ComputeL(V *,constants *,int); \
+	template VecScalar<V> ComputeEddyVisc(V *,V *,constants *,int); \
+	template VecScalar<V> ComputeP(V *,V *,Grid *,int); \
+	template VecScalar<V> ComputeEp0(V *,constants *,Grid *); \
+	template VecScalar<V> Computef0(V *,constants *,Grid *); \
+	template int ComputeFieldTerms(Fields< VecScalar<V> > *,constants *,unsigned int,unsigned int);
+INSTANTIATE_COMPUTETERMS(gsl_vector)
+INSTANTIATE_COMPUTETERMS(DualVector)
+
+void Limit(gsl_vector * x)
+{
+	for (unsigned int i = 0; i < x->size; i++)
+	{
+		if(i%5==1)
+			gsl_vector_set(x,i,fmax(gsl_vector_get(x,i),K_MIN));
+		if(i%5==3)
+			gsl_vector_set(x,i,fmax(gsl_vector_get(x,i),V2_MIN));
+	}
+}
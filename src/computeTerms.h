@@ -7,13 +7,21 @@
  * This file defines the methods to compute various terms for the v2-f equations 
  * including turublent time scale, turbulent length scale, production rate, eddy viscosity, 
  * as well as the wall boundary terms for the dissipation and redistribution term. 
+ * The terms used by SysF are templated on the vector type (gsl_vector or DualVector, see dual.h).
  */
 #ifndef COMPUTETERMS_H
 #define COMPUTETERMS_H
 
 #include<gsl/gsl_vector.h>
 #include"setup.h"
+#include"dual.h"
+#include"fields.h"
 using namespace std;
+
+/** \brief Lower bounds of \f$\epsilon\f$, k and \f$\overline{v^2}\f$ in the terms, and of k and \f$\overline{v^2}\f$ after a step (Limit). */
+#define EP_MIN 1.0e-7
+#define K_MIN  1.0e-7
+#define V2_MIN 1.0e-12
 /**
  * \brief Compute turbulent time scale, T.
  *
@@ -21,9 +29,10 @@ using namespace std;
  * \param xi pointer to gsl_vector of unknowns \f$U,k,\epsilon,\overline{v^2},f\f$.
  * \param modelConst pointer to struct containing model constants. 
  * \param i position at which to compute T. 
- * \return T at i. 
+ * \return T at i. A term that is not finite is logged and returned, for the caller to check.
  */
-double ComputeT(gsl_vector * xi, constants * modelConst,int i);
+template<class V>
+VecScalar<V> ComputeT(V * xi, constants * modelConst,int i);
 /**
  * \brief Compute turbulent length scale, L. 
  *
@@ -35,7 +44,8 @@ double ComputeT(gsl_vector * xi, constants * modelConst,int i);
  * \param i position at which to compute L.
  * \return L at i. 
  */
-double ComputeL(gsl_vector * xi, constants * modelConst,int i);
+template<class V>
+VecScalar<V> ComputeL(V * xi, constants * modelConst,int i);
 
 /**
  * \brief Compute eddy viscosity. 
@@ -47,7 +57,8 @@ double ComputeL(gsl_vector * xi, constants * modelConst,int i);
  * \param i position at which to compute \f$\nu_T\f$. 
  * \return \f$\nu_T\f$ at i. 
  */
-double ComputeEddyVisc(gsl_vector * xi, gsl_vector * T, constants * modelConst,int i);
+template<class V>
+VecScalar<V> ComputeEddyVisc(V * xi, V * T, constants * modelConst,int i);
 
 /**
  * \brief Comute production rate. 
@@ -59,7 +70,8 @@ double ComputeEddyVisc(gsl_vector * xi, gsl_vector * T, constants * modelConst,i
  * \param i position at which to compute P. 
  * \return P at i.  
  */
-double ComputeP(gsl_vector * xi,gsl_vector * vT, Grid* grid, int i );
+template<class V>
+VecScalar<V> ComputeP(V * xi,V * vT, Grid* grid, int i );
 
 /**
  * \brief Compute redistribution term at wall boundary. 
@@ -70,7 +82,8 @@ double ComputeP(gsl_vector * xi,gsl_vector * vT, Grid* grid, int i );
  * \param grid - A pointer to the grid of points
  * \return f at boundary. 
  */
-double Computef0(gsl_vector * xi,constants * modelConst, Grid* grid);
+template<class V>
+VecScalar<V> Computef0(V * xi,constants * modelConst, Grid* grid);
 
 /**
  * \brief Compute dissipation term at wall boundary. 
@@ -81,5 +94,128 @@ double Computef0(gsl_vector * xi,constants * modelConst, Grid* grid);
  * \param grid - A pointer to the grid of points
  * \return \f$\epsilon\f$ at boundary. 
  */
-double ComputeEp0(gsl_vector * xi,constants * modelConst, Grid* grid);
+template<class V>
+VecScalar<V> ComputeEp0(V * xi,constants * modelConst, Grid* grid);
+
+/**
+ * \brief Computes T, L and vT at points first ... last-1 of the fields.
+ *
+ * Same values as ComputeT, ComputeL and ComputeEddyVisc, in one pass over the field arrays.
+ * In double precision the pass is ComputeTermsBatch with TermsKernelBest.
+ * \param F pointer to fields, with U,k,ep,v2,f set (FieldsGather).
+ * \param modelConst pointer to struct containing model constants.
+ * \param first first point (default 1).
+ * \param last one past the last point (default, and at most, size).
+ * \return 0 if all terms are finite, 1 otherwise.
+ */
+template<class S>
+int ComputeFieldTerms(Fields<S> * F, constants * modelConst, unsigned int first = 1, unsigned int last = UINT_MAX);
+
+/**
+ * \brief Instruction sets of the batch kernels for T, L and vT.
+ */
+enum termsKernel {
+	TERMS_SCALAR, /**< plain loop. */
+	TERMS_AVX2, /**< 4 points per instruction. */
+	TERMS_AVX512 /**< 8 points per instruction. */
+};
+
+/**
+ * \brief Widest batch kernel supported by the processor, used by ComputeFieldTerms.
+ * \return kernel.
+ */
+termsKernel TermsKernelBest();
+
+/**
+ * \brief Name of a batch kernel, for logs.
+ * \param kernel kernel.
+ * \return name.
+ */
+const char * TermsKernelName(termsKernel kernel);
+
+/**
+ * \brief Computes T, L and vT of n points from contiguous arrays of k, ep and v2.
+ *
+ * The same limits and formulas as ComputeT, ComputeL and ComputeEddyVisc, without branches,
+ * and the same bits with every kernel. Unlike the point functions it does not stop on a 
+ * term that is not finite, but checks all of them once at the end.
+ * \param k,ep,v2 n values of k, \f$\epsilon\f$ and \f$\overline{v^2}\f$.
+ * \param T,L,vT n values of T, L and \f$\nu_T\f$ (output).
+ * \param n number of points.
+ * \param modelConst pointer to struct containing model constants.
+ * \param kernel kernel to use; falls back to a narrower one the processor supports.
+ * \return 0 if all terms are finite.
+ */
+int ComputeTermsBatch(const double * k, const double * ep, const double * v2, double * T,
+                      double * L, double * vT, unsigned int n, constants * modelConst, termsKernel kernel);
+/**
+ * \brief Compute turbulent time scale, T, and its derivatives.
+ *
+ * Same as ComputeT, but also returns the partial derivatives of T with respect to
+ * \f$k\f$ and \f$\epsilon\f$ at i. The derivative is zero wherever a lower limit is active.
+ * \param xi pointer to gsl_vector of unknowns \f$U,k,\epsilon,\overline{v^2},f\f$.
+ * \param modelConst pointer to struct containing model constants. 
+ * \param i position at which to compute T. 
+ * \param dTdk returns \f$\partial T/\partial k\f$.
+ * \param dTdep returns \f$\partial T/\partial \epsilon\f$.
+ * \return T at i. 
+ */
+double ComputeTDerivs(gsl_vector * xi, constants * modelConst, int i, double * dTdk, double * dTdep);
+
+/**
+ * \brief Compute turbulent length scale, L, and its derivatives.
+ *
+ * Same as ComputeL, but also returns the partial derivatives of L with respect to
+ * \f$k\f$ and \f$\epsilon\f$ at i.
+ * \param xi pointer to gsl_vector of unknowns \f$U,k,\epsilon,\overline{v^2},f\f$.
+ * \param modelConst pointer to struct containing model constants. 
+ * \param i position at which to compute L. 
+ * \param dLdk returns \f$\partial L/\partial k\f$.
+ * \param dLdep returns \f$\partial L/\partial \epsilon\f$.
+ * \return L at i. 
+ */
+double ComputeLDerivs(gsl_vector * xi, constants * modelConst, int i, double * dLdk, double * dLdep);
+
+/**
+ * \brief Compute eddy viscosity and its derivatives.
+ *
+ * Same as ComputeEddyVisc, but also returns the partial derivatives of \f$\nu_T\f$ with
+ * respect to \f$k,\epsilon,\overline{v^2}\f$ at i.
+ * \param xi pointer to gsl_vector of unknowns \f$U,k,\epsilon,\overline{v^2},f\f$.
+ * \param T pointer to gsl_vector of turbulent time scale
+ * \param modelConst pointer to struct containing model constants. 
+ * \param i position at which to compute \f$\nu_T\f$. 
+ * \param dTdk \f$\partial T/\partial k\f$ at i (from ComputeTDerivs).
+ * \param dTdep \f$\partial T/\partial \epsilon\f$ at i (from ComputeTDerivs).
+ * \param dvT array of length 3 returning the derivatives w.r.t. \f$k,\epsilon,\overline{v^2}\f$.
+ * \return \f$\nu_T\f$ at i. 
+ */
+double ComputeEddyViscDerivs(gsl_vector * xi, gsl_vector * T, constants * modelConst, int i,
+                             double dTdk, double dTdep, double * dvT);
+
+/**
+ * \brief Local time scale of every equation, for local pseudo time steps.
+ *
+ * At each point the rates of diffusion across the local grid spacing h and of the decay of each
+ * unknown are added,
+ * \f[ \frac{1}{\tau_U} = \frac{2(\nu+\nu_T)}{h^2}, \quad
+ *     \frac{1}{\tau_k} = \frac{2(\nu+\nu_T)}{h^2} + \frac{1}{T}, \quad
+ *     \frac{1}{\tau_\epsilon} = \frac{2(\nu+\nu_T/\sigma_\epsilon)}{h^2} + \frac{C_{\epsilon 2}}{T}, \quad
+ *     \frac{1}{\tau_{v^2}} = \frac{2(\nu+\nu_T)}{h^2} + \frac{1}{T}, \quad
+ *     \frac{1}{\tau_f} = \frac{2L^2}{h^2} + 1, \f]
+ * so \f$\tau\f$ is small near the wall and in the stiff equations. The scales are divided by 
+ * their largest value, so deltaT is the step of the slowest equation and the others take 
+ * shorter steps.
+ * \param xi pointer to gsl_vector of unknowns \f$U,k,\epsilon,\overline{v^2},f\f$.
+ * \param modelConst pointer to struct containing model constants. 
+ * \param grid pointer to grid.
+ * \param dt \f$\tau\f$ of each unknown, same layout as xi.
+ */
+void ComputeLocalDt(gsl_vector * xi, constants * modelConst, Grid * grid, gsl_vector * dt);
+/**
+ * \brief Keeps k and v2 positive, clipping them to K_MIN and V2_MIN.
+ * \param x pointer to gsl_vector of unknowns.
+ */
+void Limit(gsl_vector * x);
+
 #endif
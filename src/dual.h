@@ -0,0 +1,158 @@
+/**
+ * \file
+ *
+ * \brief Dual numbers and the vector types the residual functions are templated on.
+ *
+ * A Dual<N> carries a value and N directional derivatives, which are propagated exactly by
+ * every operation used in SysF (forward mode automatic differentiation). The residual functions
+ * read and write their vectors through VecGet and VecSet, so the same code runs on gsl_vector
+ * (double) and on ScalarVector<S> for any scalar type S.
+ */
+#ifndef DUAL_H
+#define DUAL_H
+#include<stdlib.h>
+#include<math.h>
+#include<ostream>
+#include<gsl/gsl_vector.h>
+using namespace std;
+
+/**
+ * \brief Number of derivatives carried by JacDual, one per color of the block tridiagonal
+ * Jacobian (three grid points times five unknowns).
+ */
+#define DUAL_WIDTH 15
+
+/**
+ * \brief Value and N derivatives, \f$ a + \sum_k a_k \varepsilon_k \f$ with \f$\varepsilon_j\varepsilon_k = 0\f$.
+ */
+template<int N>
+struct Dual {
+	double val; /**< value. */
+	double d[N]; /**< derivatives. */
+	Dual() : val(0.0) { for (int k = 0; k < N; k++) d[k] = 0.0; }
+	/** \brief Constant, with zero derivatives. */
+	Dual(double v) : val(v) { for (int k = 0; k < N; k++) d[k] = 0.0; }
+};
+
+/** \brief Dual number used for the Jacobian of SysF. */
+typedef Dual<DUAL_WIDTH> JacDual;
+
+template<int N> inline Dual<N> operator-(const Dual<N> & a)
+{
+	Dual<N> r; r.val = -a.val;
+	for (int k = 0; k < N; k++) r.d[k] = -a.d[k];
+	return r;
+}
+template<int N> inline Dual<N> operator+(const Dual<N> & a, const Dual<N> & b)
+{
+	Dual<N> r; r.val = a.val + b.val;
+	for (int k = 0; k < N; k++) r.d[k] = a.d[k] + b.d[k];
+	return r;
+}
+template<int N> inline Dual<N> operator-(const Dual<N> & a, const Dual<N> & b)
+{
+	Dual<N> r; r.val = a.val - b.val;
+	for (int k = 0; k < N; k++) r.d[k] = a.d[k] - b.d[k];
+	return r;
+}
+template<int N> inline Dual<N> operator*(const Dual<N> & a, const Dual<N> & b)
+{
+	Dual<N> r; r.val = a.val*b.val;
+	for (int k = 0; k < N; k++) r.d[k] = a.d[k]*b.val + a.val*b.d[k];
+	return r;
+}
+template<int N> inline Dual<N> operator/(const Dual<N> & a, const Dual<N> & b)
+{
+	Dual<N> r; r.val = a.val/b.val;
+	for (int k = 0; k < N; k++) r.d[k] = (a.d[k] - r.val*b.d[k])/b.val;
+	return r;
+}
+template<int N> inline Dual<N> operator+(const Dual<N> & a, double b) { Dual<N> r = a; r.val += b; return r; }
+template<int N> inline Dual<N> operator+(double a, const Dual<N> & b) { return b + a; }
+template<int N> inline Dual<N> operator-(const Dual<N> & a, double b) { Dual<N> r = a; r.val -= b; return r; }
+template<int N> inline Dual<N> operator-(double a, const Dual<N> & b) { return -b + a; }
+template<int N> inline Dual<N> operator*(const Dual<N> & a, double b)
+{
+	Dual<N> r; r.val = a.val*b;
+	for (int k = 0; k < N; k++) r.d[k] = a.d[k]*b;
+	return r;
+}
+template<int N> inline Dual<N> operator*(double a, const Dual<N> & b) { return b*a; }
+template<int N> inline Dual<N> operator/(const Dual<N> & a, double b) { return a*(1/b); }
+template<int N> inline Dual<N> operator/(double a, const Dual<N> & b)
+{
+	Dual<N> r; r.val = a/b.val;
+	double dr = -r.val/b.val;
+	for (int k = 0; k < N; k++) r.d[k] = dr*b.d[k];
+	return r;
+}
+
+template<int N> inline Dual<N> sqrt(const Dual<N> & a)
+{
+	Dual<N> r; r.val = ::sqrt(a.val);
+	double dr = 0.5/r.val;
+	for (int k = 0; k < N; k++) r.d[k] = dr*a.d[k];
+	return r;
+}
+template<int N> inline Dual<N> pow(const Dual<N> & a, double p)
+{
+	Dual<N> r; r.val = ::pow(a.val,p);
+	double dr = p*::pow(a.val,p-1);
+	for (int k = 0; k < N; k++) r.d[k] = dr*a.d[k];
+	return r;
+}
+
+// On a tie the second argument wins, so fmax(x,X_MIN) is flat at x = X_MIN like the limits in SysJ.
+template<int N> inline Dual<N> fmax(const Dual<N> & a, const Dual<N> & b) { return a.val > b.val ? a : b; }
+template<int N> inline Dual<N> fmax(const Dual<N> & a, double b) { return a.val > b ? a : Dual<N>(b); }
+template<int N> inline Dual<N> fmax(double a, const Dual<N> & b) { return a > b.val ? Dual<N>(a) : b; }
+
+template<int N> inline bool isfinite(const Dual<N> & a) { return std::isfinite(a.val); }
+
+/** \brief Prints the value only, so Log messages look the same for every scalar type. */
+template<int N> inline ostream & operator<<(ostream & os, const Dual<N> & a) { return os << a.val; }
+
+/**
+ * \brief Contiguous vector of any scalar type, the counterpart of gsl_vector.
+ */
+template<class S>
+struct ScalarVector {
+	size_t size; /**< number of elements. */
+	S * data; /**< elements. */
+};
+
+/** \brief Vector of JacDual. */
+typedef ScalarVector<JacDual> DualVector;
+
+/**
+ * \brief Scalar type, allocation and element access of the vector types.
+ */
+template<class V> struct VecTraits;
+
+template<> struct VecTraits<gsl_vector> {
+	typedef double Scalar;
+	static gsl_vector * Calloc(size_t n) { return gsl_vector_calloc(n); }
+	static void Free(gsl_vector * v) { gsl_vector_free(v); }
+};
+
+template<class S> struct VecTraits< ScalarVector<S> > {
+	typedef S Scalar;
+	static ScalarVector<S> * Calloc(size_t n)
+	{
+		ScalarVector<S> * v = new ScalarVector<S>;
+		v->size = n;
+		v->data = new S[n];
+		return v;
+	}
+	static void Free(ScalarVector<S> * v) { delete [] v->data; delete v; }
+};
+
+inline double VecGet(const gsl_vector * v, size_t i) { return gsl_vector_get(v,i); }
+inline void VecSet(gsl_vector * v, size_t i, double x) { gsl_vector_set(v,i,x); }
+template<class S> inline S VecGet(const ScalarVector<S> * v, size_t i) { return v->data[i]; }
+template<class S, class T> inline void VecSet(ScalarVector<S> * v, size_t i, const T & x) { v->data[i] = x; }
+
+/** \brief Scalar type of vector type V. */
+template<class V> using VecScalar = typename VecTraits<V>::Scalar;
+
+#endif
@@ -0,0 +1,133 @@
+//--------------------------------------------------
+// fdJacobian: Colored finite difference Jacobian.
+//
+// 10/17/2026 - Written to build the block tridiagonal 
+//              Jacobian with 15 residual evaluations.
+// 10/17/2026 - Perturbed vectors from a workspace.
+// 10/17/2026 - Colors of SysF spread over threads.
+// 10/17/2026 - No threads of its own inside a sweep.
+//--------------------------------------------------
+#include<math.h>
+#include<gsl/gsl_math.h>
+#include<omp.h>
+#include"fdJacobian.h"
+#include"workspace.h"
+#include"../include/loglevel.h"
+using namespace std;
+
+// Perturbation of each unknown.
+static void FDSteps(const gsl_vector * x, gsl_vector * h)
+{
+	for (unsigned int j = 0; j < x->size; j++)
+	{
+		gsl_vector_set(h,j,GSL_SQRT_DBL_EPSILON*fmax(fabs(gsl_vector_get(x,j)),1.0));
+	}
+}
+
+// Perturbs all unknowns of one color and sets their columns of J. Only writes the columns of
+// this color, so the colors may be set in any order and by different threads.
+static int FDColor(gsl_multiroot_function * F, const gsl_vector * x, const gsl_vector * h, const gsl_vector * f0,
+                   gsl_vector * xPert, gsl_vector * fPert, int color, BlockTridiag * J)
+{
+	unsigned int n = J->n;
+	int start = color/BLOCK_SIZE; // first grid point (from 0) of this color
+	int c = color%BLOCK_SIZE;     // unknown perturbed at each of its points
+	gsl_vector_memcpy(xPert,x);
+	for (unsigned int p = start; p < n; p += 3)
+		gsl_vector_set(xPert,BLOCK_SIZE*p+c,gsl_vector_get(x,BLOCK_SIZE*p+c)+gsl_vector_get(h,BLOCK_SIZE*p+c));
+	int status = GSL_MULTIROOT_FN_EVAL(F,xPert,fPert);
+
+	// The residuals at point r only see the perturbed point p in r-1,r,r+1.
+	for (unsigned int p = start; p < n && !status; p += 3)
+	{
+		double hj = gsl_vector_get(h,BLOCK_SIZE*p+c);
+		for (int offset = -1; offset <= 1; offset++)
+		{
+			int r = p-offset;
+			if (r < 0 || r >= (int)n)
+				continue;
+			double * block = BlockTridiagBlock(J,r,offset);
+			for (int m = 0; m < BLOCK_SIZE; m++)
+				block[BLOCK_SIZE*m+c] = (gsl_vector_get(fPert,BLOCK_SIZE*r+m)-gsl_vector_get(f0,BLOCK_SIZE*r+m))/hj;
+		}
+	}
+	return status;
+}
+
+int ColoredFDJacobian(gsl_multiroot_function * F, const gsl_vector * x, const gsl_vector * fx, BlockTridiag * J, Workspace * work)
+{
+	unsigned int n = J->n;
+	if (x->size != BLOCK_SIZE*n || F->n != x->size)
+	{
+		Log(logERROR) << "Error: colored Jacobian needs " << BLOCK_SIZE*n << " unknowns";
+		return 1;
+	}
+	bool allocated = !WorkspaceFits(work,n+1);
+	gsl_vector * xPert = allocated ? ScratchVector(x->size) : work->xPert;
+	gsl_vector * fPert = allocated ? ScratchVector(x->size) : work->fPert;
+	gsl_vector * f0 = allocated ? ScratchVector(x->size) : work->f0;
+	gsl_vector * h = allocated ? ScratchVector(x->size) : work->h;
+	int status = 0;
+
+	if (fx)
+		gsl_vector_memcpy(f0,fx);
+	else
+		status = GSL_MULTIROOT_FN_EVAL(F,x,f0);
+	FDSteps(x,h);
+	BlockTridiagSetZero(J);
+
+	for (int color = 0; color < FD_COLORS && !status; color++)
+		status = FDColor(F,x,h,f0,xPert,fPert,color,J);
+
+	if (allocated)
+	{
+		gsl_vector_free(xPert);
+		gsl_vector_free(fPert);
+		gsl_vector_free(f0);
+		gsl_vector_free(h);
+	}
+	return status;
+}
+
+int ColoredFDJacobianThreads(const gsl_vector * x, const gsl_vector * fx, FParams * params, BlockTridiag * J)
+{
+	unsigned int n = J->n;
+	if (x->size != BLOCK_SIZE*n)
+	{
+		Log(logERROR) << "Error: colored Jacobian needs " << BLOCK_SIZE*n << " unknowns";
+		return 1;
+	}
+	int threads = AvailableThreads();
+	threads = (threads < FD_COLORS) ? threads : FD_COLORS;
+	bool allocated = !WorkspaceFits(params->work,n+1);
+	Workspace * w = allocated ? WorkspaceAlloc(n+1) : params->work;
+	WorkspaceThreads(w,threads);
+	int status = 0;
+
+	if (fx)
+		gsl_vector_memcpy(w->f0,fx);
+	else
+		status = SysF(x,params,w->f0);
+	FDSteps(x,w->h);
+	BlockTridiagSetZero(J);
+
+	// Each thread evaluates SysF on its own copy of x, with its own copy of the parameters and
+	// its own workspace. Nothing else in SysF is written, so the colors are independent.
+	if (!status)
+	{
+		#pragma omp parallel num_threads(threads) reduction(|:status)
+		{
+		Workspace * tw = w->threads[omp_get_thread_num()];
+		FParams p = *params;
+		p.work = tw;
+		gsl_multiroot_function F = {&SysF,x->size,&p};
+		#pragma omp for schedule(dynamic)
+		for (int color = 0; color < FD_COLORS; color++)
+			status |= FDColor(&F,x,w->h,w->f0,tw->xPert,tw->fPert,color,J);
+		}
+	}
+
+	if (allocated)
+		WorkspaceFree(w);
+	return status;
+}
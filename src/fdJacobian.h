@@ -0,0 +1,53 @@
+/**
+ * \file
+ *
+ * \brief Finite difference Jacobian of a block tridiagonal system, using graph coloring.
+ *
+ * Every residual at grid point i only depends on the unknowns at i-1, i and i+1, so two
+ * unknowns that are at least three grid points apart never affect the same residual.
+ * Giving unknown m at point i the color \f$5((i-1) \bmod 3)+m\f$, all unknowns of one color
+ * can be perturbed at once and the Jacobian is found with 15 residual evaluations
+ * (plus one at the unperturbed point) for any number of grid points.
+ */
+#ifndef FDJACOBIAN_H
+#define FDJACOBIAN_H
+#include<gsl/gsl_vector.h>
+#include<gsl/gsl_multiroots.h>
+#include"blockTridiag.h"
+#include"systemSolve.h"
+using namespace std;
+
+/** \brief Number of colors needed for a block tridiagonal Jacobian. */
+#define FD_COLORS (3*BLOCK_SIZE)
+
+/**
+ * \brief Forward difference Jacobian of F at x, assembled as a BlockTridiag.
+ *
+ * The column for unknown j is perturbed by \f$h_j = \sqrt{\epsilon}\max(|x_j|,1)\f$. Unlike
+ * gsl's dnewton, h is not scaled down for tiny unknowns such as \f$\overline{v^2}\f$ near the
+ * wall, where the change in F would be lost to round off.
+ * \param F function with the same signature as SysF, with F->n = x->size.
+ * \param x point at which the Jacobian is taken.
+ * \param fx F(x), or NULL to have it evaluated.
+ * \param J block tridiagonal Jacobian, with x->size/5 block rows.
+ * \param work workspace of the grid for the perturbed vectors, or NULL to allocate them.
+ * \return Error code (0 = success).
+ */
+int ColoredFDJacobian(gsl_multiroot_function * F, const gsl_vector * x, const gsl_vector * fx, BlockTridiag * J, struct Workspace * work = NULL);
+
+/**
+ * \brief ColoredFDJacobian of SysF, with the colors spread over threads.
+ *
+ * Each of up to FD_COLORS threads perturbs its own copy of x and calls SysF with its own copy
+ * of params and its own workspace (Workspace::threads), so no residual scratch is shared.
+ * Every column is computed by one thread exactly as in ColoredFDJacobian, so J is the same,
+ * bit for bit, for any number of threads.
+ * \param x point at which the Jacobian is taken.
+ * \param fx SysF(x), or NULL to have it evaluated.
+ * \param params parameters of SysF, with the workspace of the grid, or NULL to allocate one.
+ * \param J block tridiagonal Jacobian, with x->size/5 block rows.
+ * \return Error code (0 = success).
+ */
+int ColoredFDJacobianThreads(const gsl_vector * x, const gsl_vector * fx, FParams * params, BlockTridiag * J);
+
+#endif
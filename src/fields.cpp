@@ -0,0 +1,104 @@
+//--------------------------------------------------
+// fields: Structure of arrays storage of the fields with ghost cells.
+//
+// 10/17/2026 - Written for the residual on contiguous field arrays.
+// 10/17/2026 - Allocations counted with the workspace scratch.
+// 10/17/2026 - Gather and scatter of a range of points.
+//--------------------------------------------------
+#include<stdlib.h>
+#include<new>
+#include"fields.h"
+#include"workspace.h"
+using namespace std;
+
+// Number of arrays: U,k,ep,v2,f,T,L,vT.
+#define FIELDS_ARRAYS 8
+
+template<class S>
+Fields<S> * FieldsAlloc(unsigned int size)
+{
+	Fields<S> * F = new Fields<S>;
+	F->size = size;
+	WorkspaceCountAlloc(1);
+
+	// Round each array up to whole cache lines so every one of them starts aligned.
+	unsigned int perLine = (FIELDS_ALIGN % sizeof(S)) ? 1 : FIELDS_ALIGN/sizeof(S);
+	F->stride = ((size+1 + perLine-1)/perLine)*perLine;
+	size_t bytes = ((FIELDS_ARRAYS*F->stride*sizeof(S) + FIELDS_ALIGN-1)/FIELDS_ALIGN)*FIELDS_ALIGN;
+	void * block = NULL;
+	if (posix_memalign(&block,FIELDS_ALIGN,bytes))
+		throw bad_alloc();
+	F->data = (S *)block;
+	for (unsigned int j = 0; j < FIELDS_ARRAYS*F->stride; j++)
+		new (F->data+j) S(0.0);
+
+	F->U  = F->data;
+	F->k  = F->data + F->stride;
+	F->ep = F->data + 2*F->stride;
+	F->v2 = F->data + 3*F->stride;
+	F->f  = F->data + 4*F->stride;
+	F->T  = F->data + 5*F->stride;
+	F->L  = F->data + 6*F->stride;
+	F->vT = F->data + 7*F->stride;
+	return F;
+}
+
+template<class S>
+void FieldsFree(Fields<S> * F)
+{
+	free(F->data);
+	delete F;
+}
+
+template<class V>
+void FieldsGather(V * xi, Fields< VecScalar<V> > * F, unsigned int first, unsigned int last)
+{
+	last = (last < F->size) ? last : F->size;
+	for (int m = 0; m < FIELDS_VARS; m++)
+	{
+		VecScalar<V> * x = FieldsVar(F,m);
+		for (unsigned int i = first; i < last; i++)
+			x[i] = VecGet(xi,5*(i-1)+m);
+	}
+}
+
+template<class V>
+void FieldsScatter(Fields< VecScalar<V> > * F, V * xi, unsigned int first, unsigned int last)
+{
+	last = (last < F->size) ? last : F->size;
+	for (int m = 0; m < FIELDS_VARS; m++)
+	{
+		VecScalar<V> * x = FieldsVar(F,m);
+		for (unsigned int i = first; i < last; i++)
+			VecSet(xi,5*(i-1)+m,x[i]);
+	}
+}
+
+template<class S>
+void FieldsSetGhosts(Fields<S> * F, S ep0, S f0)
+{
+	unsigned int n = F->size;
+	F->U[0] = 0;
+	F->k[0] = 0;
+	F->ep[0] = ep0;
+	F->v2[0] = 0;
+	F->f[0] = f0;
+	F->T[0] = 0;
+	F->L[0] = 0;
+	F->vT[0] = 0;
+	for (int m = 0; m < FIELDS_ARRAYS; m++)
+	{
+		S * x = F->data + m*F->stride;
+		x[n] = x[n-2];
+	}
+}
+
+// Instantiations for residuals in double (gsl_vector) and dual numbers (DualVector).
+#define INSTANTIATE_FIELDS(V) \
+	template Fields< VecScalar<V> > * FieldsAlloc< VecScalar<V> >(unsigned int); \
+	template void FieldsFree(Fields< VecScalar<V> > *); \
+	template void FieldsGather(V *,Fields< VecScalar<V> > *,unsigned int,unsigned int); \
+	template void FieldsScatter(Fields< VecScalar<V> > *,V *,unsigned int,unsigned int); \
+	template void FieldsSetGhosts(Fields< VecScalar<V> > *,VecScalar<V>,VecScalar<V>);
+INSTANTIATE_FIELDS(gsl_vector)
+INSTANTIATE_FIELDS(DualVector)
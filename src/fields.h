@@ -0,0 +1,101 @@
+/**
+ * \file
+ *
+ * \brief Structure of arrays storage of the fields, with ghost cells at the wall and centerline.
+ *
+ * xi stores \f$U,k,\epsilon,\overline{v^2},f\f$ interleaved point by point, which is the
+ * layout of the block tridiagonal Jacobian and the linear solvers. The residual instead works
+ * on one contiguous, 64 byte aligned array per field. Index i of each array is grid point i:
+ * 0 is the wall, size-1 the centerline and size a ghost point. The wall entry holds the
+ * Dirichlet values \f$U=k=\overline{v^2}=0\f$, \f$\epsilon(0)\f$ and \f$f(0)\f$, and the
+ * ghost mirrors point size-2 for the zero Neumann condition at the centerline, so the
+ * stencils at every point are the same and need no boundary branches. FieldsGather and
+ * FieldsScatter convert between the two layouts.
+ */
+#ifndef FIELDS_H
+#define FIELDS_H
+
+#include<limits.h>
+#include"dual.h"
+using namespace std;
+
+/** \brief Alignment of each field array in bytes (one cache line). */
+#define FIELDS_ALIGN 64
+
+/** \brief Number of unknowns per point, U,k,ep,v2,f. */
+#define FIELDS_VARS 5
+
+/**
+ * \brief Fields of the system and the terms T, L and vT, one array per field.
+ */
+template<class S>
+struct Fields {
+	unsigned int size; /**< grid points including the wall, as in SysResidual. */
+	unsigned int stride; /**< elements between the starts of two arrays, at least size+1. */
+	S * data; /**< single aligned block holding all arrays. */
+	S * U; /**< mean velocity. */
+	S * k; /**< turbulent kinetic energy. */
+	S * ep; /**< dissipation. */
+	S * v2; /**< velocity scale. */
+	S * f; /**< redistribution. */
+	S * T; /**< turbulent time scale. */
+	S * L; /**< turbulent length scale. */
+	S * vT; /**< eddy viscosity. */
+};
+
+/**
+ * \brief Array of unknown m (0 = U ... 4 = f), the same order as in xi.
+ */
+template<class S>
+inline S * FieldsVar(Fields<S> * F, int m)
+{
+	return F->data + m*F->stride;
+}
+
+/**
+ * \brief Allocates zeroed fields for size grid points plus the centerline ghost.
+ * \param size grid points including the wall.
+ * \return pointer to fields.
+ */
+template<class S>
+Fields<S> * FieldsAlloc(unsigned int size);
+
+/**
+ * \brief Frees fields.
+ * \param F pointer to fields.
+ */
+template<class S>
+void FieldsFree(Fields<S> * F);
+
+/**
+ * \brief Copies the interleaved unknowns of points first ... last-1 into the fields.
+ * \param xi vector of unknowns, 5*(size-1) entries.
+ * \param F pointer to fields.
+ * \param first first point (default 1).
+ * \param last one past the last point (default, and at most, size).
+ */
+template<class V>
+void FieldsGather(V * xi, Fields< VecScalar<V> > * F, unsigned int first = 1, unsigned int last = UINT_MAX);
+
+/**
+ * \brief Copies points first ... last-1 of the fields into the interleaved layout.
+ * \param F pointer to fields.
+ * \param xi vector of unknowns, 5*(size-1) entries.
+ * \param first first point (default 1).
+ * \param last one past the last point (default, and at most, size).
+ */
+template<class V>
+void FieldsScatter(Fields< VecScalar<V> > * F, V * xi, unsigned int first = 1, unsigned int last = UINT_MAX);
+
+/**
+ * \brief Sets the ghost cells: the wall values at 0 and the mirror of size-2 at size.
+ *
+ * T, L and vT are zero at the wall. Call after the terms are set, since vT is mirrored too.
+ * \param F pointer to fields.
+ * \param ep0 dissipation at the wall (ComputeEp0).
+ * \param f0 redistribution at the wall (Computef0).
+ */
+template<class S>
+void FieldsSetGhosts(Fields<S> * F, S ep0, S f0);
+
+#endif
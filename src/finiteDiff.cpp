@@ -2,6 +2,8 @@
 // finiteDiff: Defines finite difference approximations. 
 //
 // 12/3/2016 - (gry88) Written for CSE380 final project. 
+// 10/17/2026 - Templated on the vector type for dual numbers.
+// 10/17/2026 - Deriv1, Deriv2 and BdryDeriv2 use the stencil tables of the grid.
 //--------------------------------------------------
 #include "finiteDiff.h"
 #include<gsl/gsl_vector.h>
@@ -10,68 +12,86 @@
 #include <iostream>
 using namespace std;
 
-double Diff2(gsl_vector * x,double deltaEta,double bdry,int i)
+template<class V>
+VecScalar<V> Diff2(V * x,double deltaEta,VecScalar<V> bdry,int i)
 {
   // i = xiCounter indices
   //if i < 5 use value at boundary. 5 for the index of xi.
   if (i<5)
-    return (gsl_vector_get(x,i+5) - 2*gsl_vector_get(x,i) + bdry)/pow(deltaEta,2);
+    return (VecGet(x,i+5) - 2*VecGet(x,i) + bdry)/pow(deltaEta,2);
   else
-    return ( gsl_vector_get(x,i+5) - 2*gsl_vector_get(x,i) + gsl_vector_get(x,i-5))/pow(deltaEta,2); //i+5 corresponds to i+1 for single terms. U_2 = xi_1+5 for example.
+    return ( VecGet(x,i+5) - 2*VecGet(x,i) + VecGet(x,i-5))/pow(deltaEta,2); //i+5 corresponds to i+1 for single terms. U_2 = xi_1+5 for example.
 }
 
-double Diff1(gsl_vector *x, double deltaEta,double bdry, int i)
+template<class V>
+VecScalar<V> Diff1(V * x, double deltaEta,VecScalar<V> bdry, int i)
 {
   //same structure as above but for first derivative.
   if (i<5)
-    return (gsl_vector_get(x,i+5)-bdry)/(2*deltaEta);
+    return (VecGet(x,i+5)-bdry)/(2*deltaEta);
   else
-    return (gsl_vector_get(x,i+5)-gsl_vector_get(x,i-5))/(2*deltaEta);
+    return (VecGet(x,i+5)-VecGet(x,i-5))/(2*deltaEta);
 }
 
-double Deriv2(gsl_vector * x, double bdry, int i, Grid* grid)
+template<class V>
+VecScalar<V> Deriv2(V * x, VecScalar<V> bdry, int i, Grid* grid)
 {
-  // Since xi is uniformly spaced, \xi(0) = \Delta \xi
-  double delta = gsl_vector_get(grid->chi, 0);
-  double chi = gsl_vector_get(grid->chi, (i/5));
-  return grid->d2ChidY2(chi)*Diff1(x, delta, bdry, i) +
-      pow(grid->dChidY(chi),2)*Diff2(x, delta, bdry, i);
+  // Coefficients of point i/5 (chi index) from the grid tables; the wall value replaces the
+  // point before the first one.
+  int j = i/5;
+  VecScalar<V> lower = (i<5) ? bdry : VecGet(x,i-5);
+  return grid->deriv2Lower[j]*lower + grid->deriv2Center[j]*VecGet(x,i) +
+      grid->deriv2Upper[j]*VecGet(x,i+5);
 }
 
-double Deriv1(gsl_vector *x, double bdry, int i, Grid* grid)
+template<class V>
+VecScalar<V> Deriv1(V * x, VecScalar<V> bdry, int i, Grid* grid)
 {
-  // Since xi is uniformly spaced, \xi(0) = \Delta \xi
-  double delta = gsl_vector_get(grid->chi, 0);
-  double chi = gsl_vector_get(grid->chi, (i/5));
-  return Diff1(x, delta, bdry, i)*grid->dChidY(chi);
+  int j = i/5;
+  VecScalar<V> lower = (i<5) ? bdry : VecGet(x,i-5);
+  return grid->deriv1Lower[j]*lower + grid->deriv1Upper[j]*VecGet(x,i+5);
 }
 
-double BdryDeriv2(gsl_vector *x, int i, Grid* grid)
+template<class V>
+VecScalar<V> BdryDeriv2(V * x, int i, Grid* grid)
 {
-  //Using zero Neumann boundary condition we use ghost points for second derivative.
-  double delta = gsl_vector_get(grid->chi, 0);
-  return BdryDiff2(x,delta,i);
+  //Using zero Neumann boundary condition the ghost point is folded into the point before.
+  int j = i/5;
+  return grid->deriv2Lower[j]*VecGet(x,i-5) + grid->deriv2Center[j]*VecGet(x,i);
 }
 
-double BdryDiff2(gsl_vector * x ,double deltaEta,int i)
+template<class V>
+VecScalar<V> BdryDiff2(V * x ,double deltaEta,int i)
 {
 	//Using zero Neumann boundary condition we use ghost points for second derivative.
-	double val = ( 2*gsl_vector_get(x,i-5) - 2*gsl_vector_get(x,i))/pow(deltaEta,2);
+	VecScalar<V> val = ( 2*VecGet(x,i-5) - 2*VecGet(x,i))/pow(deltaEta,2);
 	return val; 
 }
 
-double Deriv1vT(gsl_vector * x, int i, Grid* grid)
+template<class V>
+VecScalar<V> Deriv1vT(V * x, int i, Grid* grid)
 {
   // for vT we use normal finite difference approximation.
-  double delta = gsl_vector_get(grid->chi, 0);
-  double chi = gsl_vector_get(grid->chi, i-1);
-  return Diff1vT(x,delta,i)*grid->dChidY(chi);
+  return grid->deriv1Lower[i-1]*VecGet(x,i-1) + grid->deriv1Upper[i-1]*VecGet(x,i+1);
 }
 
-double Diff1vT(gsl_vector * x,double deltaEta,int i)
+template<class V>
+VecScalar<V> Diff1vT(V * x,double deltaEta,int i)
 {
 	// for vT we use normal finite difference approximation. 
-	double val=  (gsl_vector_get(x,i+1) - gsl_vector_get(x,i-1))/(2*deltaEta);
+	VecScalar<V> val=  (VecGet(x,i+1) - VecGet(x,i-1))/(2*deltaEta);
 	return val; 
 }
 
+// Instantiations for residuals in double (gsl_vector) and dual numbers (DualVector).
+#define INSTANTIATE_FINITEDIFF(V) \
+	template VecScalar<V> Diff2(V *,double,VecScalar<V>,int); \
+	template VecScalar<V> Diff1(V *,double,VecScalar<V>,int); \
+	template VecScalar<V> Deriv2(V *,VecScalar<V>,int,Grid *); \
+	template VecScalar<V> Deriv1(V *,VecScalar<V>,int,Grid *); \
+	template VecScalar<V> BdryDeriv2(V *,int,Grid *); \
+	template VecScalar<V> BdryDiff2(V *,double,int); \
+	template VecScalar<V> Deriv1vT(V *,int,Grid *); \
+	template VecScalar<V> Diff1vT(V *,double,int);
+INSTANTIATE_FINITEDIFF(gsl_vector)
+INSTANTIATE_FINITEDIFF(DualVector)
@@ -6,12 +6,14 @@
  *
  * This file defines the methods for finite difference approximations with respect to 
  * the structure of \f$\xi\f$ as defined in the model documentation.  
+ * They are templated on the vector type (gsl_vector or DualVector, see dual.h).
  *
  */
 #ifndef FINITEDIFF_H
 #define FINITEDIFF_H
 #include<gsl/gsl_vector.h>
 #include "Grid.h"
+#include "dual.h"
 using namespace std;
 
 
@@ -26,7 +28,8 @@ using namespace std;
  * \param i point at which to compute first derivative around (not relative to \f$\xi\f$ in this case).  
  * \return centered difference approximation. 
  */
-double Diff1vT(gsl_vector * x,double deltaEta,int i);
+template<class V>
+VecScalar<V> Diff1vT(V * x,double deltaEta,int i);
 
 /**
  * \brief Approximates second derivative of gsl_vector using center
@@ -39,7 +42,8 @@ double Diff1vT(gsl_vector * x,double deltaEta,int i);
  * \param i point at which to compute second derivative around (relative to ordering of \f$\xi\f$).
  * \return centered difference approximation.
  */
-double Diff2(gsl_vector * x,double deltaEta,double bdry, int i);
+template<class V>
+VecScalar<V> Diff2(V * x,double deltaEta,VecScalar<V> bdry, int i);
 
 /**
  * \brief Approximates first derivative of gsl_vector using center
@@ -52,31 +56,36 @@ double Diff2(gsl_vector * x,double deltaEta,double bdry, int i);
  * \param i point at which to compute first derivative around (relative to ordering of \f$\xi\f$).
  * \return centered difference approximation.
  */
-double Diff1(gsl_vector *x, double deltaEta,double bdry,int i);
+template<class V>
+VecScalar<V> Diff1(V * x, double deltaEta,VecScalar<V> bdry,int i);
 
 /**
  * \brief Approximates second derivative of gsl_vector using center
  * difference.
  *
- *
+ * Applies the coefficients Grid::deriv2Lower, Grid::deriv2Center and Grid::deriv2Upper.
  * \param x pointer to vector of unknowns \f$ U,k,\epsilon,\overline{v^2},f\f$.
  * \param bdry value at boundary.
  * \param i point at which to compute second derivative around (relative to ordering of \f$\xi\f$).
+ * \param grid pointer to grid.
  * \return centered difference approximation.
  */
-double Deriv2(gsl_vector * x, double bdry, int i, Grid* grid);
+template<class V>
+VecScalar<V> Deriv2(V * x, VecScalar<V> bdry, int i, Grid* grid);
 
 /**
  * \brief Approximates first derivative of gsl_vector using center
  * difference.
  *
- *
+ * Applies the coefficients Grid::deriv1Lower and Grid::deriv1Upper.
  * \param x pointer to vector of unknowns \f$ U,k,\epsilon,\overline{v^2},f\f$.
  * \param bdry value at boundary.
  * \param i point at which to compute first derivative around (relative to ordering of \f$\xi\f$).
+ * \param grid pointer to grid.
  * \return centered difference approximation.
  */
-double Deriv1(gsl_vector *x, double bdry, int i, Grid* grid);
+template<class V>
+VecScalar<V> Deriv1(V * x, VecScalar<V> bdry, int i, Grid* grid);
 
 /**
  * \brief Approximates second derivative of gsl_vector at boundary using centered difference making use of ghost points and zero Nuemann boundary conditions.
@@ -86,7 +95,8 @@ double Deriv1(gsl_vector *x, double bdry, int i, Grid* grid);
  * \param i point at which to compute second derivative around (relative to ordering of \f$\xi\f$).  
  * \return centered difference approximation. 
  */
-double BdryDeriv2(gsl_vector * x , int i, Grid* grid);
+template<class V>
+VecScalar<V> BdryDeriv2(V * x , int i, Grid* grid);
 
 /**
  * \brief Approximates second derivative of gsl_vector at boundary using centered difference making use of ghost points and zero Nuemann boundary conditions.
@@ -96,7 +106,8 @@ double BdryDeriv2(gsl_vector * x , int i, Grid* grid);
  * \param i point at which to compute second derivative around (relative to ordering of \f$\xi\f$).
  * \return centered difference approximation.
  */
-double BdryDiff2(gsl_vector * x ,double deltaEta,int i);
+template<class V>
+VecScalar<V> BdryDiff2(V * x ,double deltaEta,int i);
 
 /**
  * \brief Approximates first derivative of eddy viscosity vector using center
@@ -108,6 +119,7 @@ double BdryDiff2(gsl_vector * x ,double deltaEta,int i);
  * \param i point at which to compute first derivative around (not relative to \f$\xi\f$ in this case).
  * \return centered difference approximation.
  */
-double Deriv1vT(gsl_vector * x, int i, Grid* grid);
+template<class V>
+VecScalar<V> Deriv1vT(V * x, int i, Grid* grid);
 
 #endif
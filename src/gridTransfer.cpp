@@ -0,0 +1,84 @@
+//--------------------------------------------------
+// gridTransfer: Moves the unknowns between grids 
+// with the same mapping.
+//
+// 10/17/2026 - Written for grid sequencing.
+// 10/17/2026 - Restrict added for FAS multigrid.
+//--------------------------------------------------
+#include<math.h>
+#include"gridTransfer.h"
+#include"computeTerms.h"
+using namespace std;
+
+int Prolong(gsl_vector * xc, Grid * coarse, gsl_vector * xf, Grid * fine, constants * modelConst)
+{
+	unsigned int nc = coarse->getSize();
+	unsigned int nf = fine->getSize();
+	if (xc->size != 5*nc || xf->size != 5*nf)
+	{
+		Log(logERROR) << "Error: cannot prolong " << xc->size << " unknowns to " << xf->size;
+		return 1;
+	}
+
+	// Values at the wall, y = 0.
+	double wall[5] = {0.0, 0.0, ComputeEp0(xc,modelConst,coarse), 0.0, Computef0(xc,modelConst,coarse)};
+
+	unsigned int k = 0; // first coarse point at or above y
+	for (unsigned int i = 0; i < nf; i++)
+	{
+		double y = gsl_vector_get(fine->y,i);
+		while (k < nc-1 && gsl_vector_get(coarse->y,k) < y)
+			k++;
+		double y2 = gsl_vector_get(coarse->y,k);
+		double y1 = (k == 0) ? 0.0 : gsl_vector_get(coarse->y,k-1);
+		double w = (y2 > y1) ? (y - y1)/(y2 - y1) : 1.0;
+		for (unsigned int m = 0; m < 5; m++)
+		{
+			double v1 = (k == 0) ? wall[m] : gsl_vector_get(xc,5*(k-1)+m);
+			double v2 = gsl_vector_get(xc,5*k+m);
+			double val = (1 - w)*v1 + w*v2;
+			if (!isfinite(val))
+			{
+				Log(logERROR) << "Error: non-finite prolongation at " << y;
+				return 1;
+			}
+			gsl_vector_set(xf,5*i+m,val);
+		}
+	}
+	return 0;
+}
+
+int Restrict(const gsl_vector * rf, Grid * fine, gsl_vector * rc, Grid * coarse)
+{
+	unsigned int nc = coarse->getSize();
+	unsigned int nf = fine->getSize();
+	if (rc->size != 5*nc || rf->size != 5*nf)
+	{
+		Log(logERROR) << "Error: cannot restrict " << rf->size << " residuals to " << rc->size;
+		return 1;
+	}
+
+	// chi is uniformly spaced on both grids, chi_i = (i+1)*dchi. 
+	double dchiF = gsl_vector_get(fine->chi,0);
+	double dchiC = gsl_vector_get(coarse->chi,0);
+	for (unsigned int k = 0; k < nc; k++)
+	{
+		double chi = gsl_vector_get(coarse->chi,k);
+		int first = (int)floor((chi - dchiC)/dchiF) - 1;
+		int last = (int)ceil((chi + dchiC)/dchiF) - 1;
+		double sum[5] = {0.0, 0.0, 0.0, 0.0, 0.0};
+		double weights = 0.0;
+		for (int j = (first < 0 ? 0 : first); j <= last && j < (int)nf; j++)
+		{
+			double w = 1.0 - fabs(gsl_vector_get(fine->chi,j) - chi)/dchiC;
+			if (w <= 0.0)
+				continue;
+			weights += w;
+			for (unsigned int m = 0; m < 5; m++)
+				sum[m] += w*gsl_vector_get(rf,5*j+m);
+		}
+		for (unsigned int m = 0; m < 5; m++)
+			gsl_vector_set(rc,5*k+m,sum[m]/weights);
+	}
+	return 0;
+}
@@ -0,0 +1,50 @@
+/**
+ * \file
+ *
+ * \brief Transfer of the unknowns and residuals between two grids with the same mapping.
+ *
+ * Used for grid sequencing, where the system is solved on coarse Grids first and each converged
+ * solution is prolonged to the next finer grid as its initial guess, and by the FAS multigrid
+ * solver. The levels need not be nested.
+ */
+#ifndef GRIDTRANSFER_H
+#define GRIDTRANSFER_H
+#include<gsl/gsl_vector.h>
+#include"setup.h"
+#include"Grid.h"
+using namespace std;
+
+/**
+ * \brief Fewest points on a coarse grid of a grid sequence.
+ */
+#define SEQ_MIN_SIZE 8
+
+/**
+ * \brief Linear interpolation in y of U, k, \f$\epsilon\f$, \f$\overline{v^2}\f$ and f from one
+ * grid to another.
+ *
+ * Between the wall and the first point of the coarse grid, the wall values are used:
+ * zero for U, k and \f$\overline{v^2}\f$, and ComputeEp0 and Computef0 for \f$\epsilon\f$ and f.
+ * \param xc unknowns on grid coarse.
+ * \param coarse grid of xc.
+ * \param xf unknowns on grid fine (output).
+ * \param fine grid of xf.
+ * \param modelConst pointer to model constants.
+ * \return Error code (0 = success).
+ */
+int Prolong(gsl_vector * xc, Grid * coarse, gsl_vector * xf, Grid * fine, constants * modelConst);
+
+/**
+ * \brief Full weighting of a residual from a fine grid to a coarse grid.
+ *
+ * Each coarse residual is the average of the fine residuals of the same unknown, weighted
+ * by a hat function in \f$\chi\f$ that is one coarse grid spacing wide on either side.
+ * \param rf residual on grid fine.
+ * \param fine grid of rf.
+ * \param rc residual on grid coarse (output).
+ * \param coarse grid of rc.
+ * \return Error code (0 = success).
+ */
+int Restrict(const gsl_vector * rf, Grid * fine, gsl_vector * rc, Grid * coarse);
+
+#endif
@@ -0,0 +1,389 @@
+//--------------------------------------------------
+// jacobian: Sets up the analytic Jacobian of F(xi).
+//
+// 10/17/2026 - Written to replace the finite difference Jacobian of dnewton.
+// 10/17/2026 - Time terms use TimeStep for local pseudo time steps.
+// 10/17/2026 - Stencil coefficients from the grid tables.
+// 10/17/2026 - Scratch from the workspace in FParams.
+// 10/17/2026 - Rows set in one parallel region.
+// 10/17/2026 - Errors returned as a status instead of exiting.
+//--------------------------------------------------
+#include<math.h>
+#include"computeTerms.h"
+#include"finiteDiff.h"
+#include"jacobian.h"
+#include"workspace.h"
+using namespace std;
+
+// Add val to dF_{5*(i-1)+m}/dxi_{5*(j-1)+c}. i,j are grid points as in the Set*Terms
+// functions, so j=0 is the wall, which is not an unknown.
+static void AddJ(BlockTridiag * J, int i, int m, int j, int c, double val)
+{
+	if (j < 1 || j > (int)J->n)
+		return;
+	BlockTridiagBlock(J,i-1,j-i)[BLOCK_SIZE*m+c] += val;
+}
+
+// Coefficients of Deriv1 (c1) and Deriv2 (c2) on the points i-1,i,i+1.
+static void StencilCoefs(Grid * grid, int i, double * c1, double * c2)
+{
+	c1[0] = grid->deriv1Lower[i-1];
+	c1[1] = 0.0;
+	c1[2] = grid->deriv1Upper[i-1];
+	c2[0] = grid->deriv2Lower[i-1];
+	c2[1] = grid->deriv2Center[i-1];
+	c2[2] = grid->deriv2Upper[i-1];
+}
+
+// Adds derivatives of (1/reyn + vT/sigma)*Deriv2(phi) + Deriv1(phi)*Deriv1vT/sigma1 at
+// interior point i, where phi is unknown m. Returns the derivative w.r.t. the wall value bdry.
+static double AddDiffusionJac(BlockTridiag * J, gsl_vector * xi, gsl_vector * vT, TermDerivs * d,
+                              FParams * params, int i, int m, double bdry, double sigma, double sigma1)
+{
+	double c1[3],c2[3];
+	int xiCounter = 5*(i-1)+m;
+	StencilCoefs(params->grid,i,c1,c2);
+	double nuEff = 1/params->modelConst->reyn + gsl_vector_get(vT,i)/sigma;
+	double d2 = Deriv2(xi,bdry,xiCounter,params->grid);
+	double d1 = Deriv1(xi,bdry,xiCounter,params->grid);
+	double d1vT = Deriv1vT(vT,i,params->grid);
+
+	for (int o = -1; o <= 1; o++)
+		AddJ(J,i,m,i+o,m,nuEff*c2[o+1] + c1[o+1]*d1vT/sigma1);
+
+	// through vT at i
+	AddJ(J,i,m,i,1,gsl_vector_get(d->dvTdk,i)*d2/sigma);
+	AddJ(J,i,m,i,2,gsl_vector_get(d->dvTdep,i)*d2/sigma);
+	AddJ(J,i,m,i,3,gsl_vector_get(d->dvTdv2,i)*d2/sigma);
+
+	// through Deriv1vT, i.e. vT at i-1 and i+1
+	for (int o = -1; o <= 1; o += 2)
+	{
+		int j = i+o;
+		if (j < 1)
+			continue;
+		AddJ(J,i,m,j,1,d1*c1[o+1]*gsl_vector_get(d->dvTdk,j)/sigma1);
+		AddJ(J,i,m,j,2,d1*c1[o+1]*gsl_vector_get(d->dvTdep,j)/sigma1);
+		AddJ(J,i,m,j,3,d1*c1[o+1]*gsl_vector_get(d->dvTdv2,j)/sigma1);
+	}
+	return nuEff*c2[0] + c1[0]*d1vT/sigma1;
+}
+
+// Adds derivatives of (1/reyn + vT/sigma)*BdryDeriv2(phi) at the centerline point i.
+static void AddBdryDiffusionJac(BlockTridiag * J, gsl_vector * xi, gsl_vector * vT, TermDerivs * d,
+                                FParams * params, int i, int m, double sigma)
+{
+	int xiCounter = 5*(i-1)+m;
+	double nuEff = 1/params->modelConst->reyn + gsl_vector_get(vT,i)/sigma;
+	double d2 = BdryDeriv2(xi,xiCounter,params->grid);
+
+	AddJ(J,i,m,i,m,nuEff*params->grid->deriv2Center[i-1]);
+	AddJ(J,i,m,i-1,m,nuEff*params->grid->deriv2Lower[i-1]);
+	AddJ(J,i,m,i,1,gsl_vector_get(d->dvTdk,i)*d2/sigma);
+	AddJ(J,i,m,i,2,gsl_vector_get(d->dvTdep,i)*d2/sigma);
+	AddJ(J,i,m,i,3,gsl_vector_get(d->dvTdv2,i)*d2/sigma);
+}
+
+// Adds derivatives of scale*P at interior point i to the row of unknown m.
+static void AddProductionJac(BlockTridiag * J, gsl_vector * xi, gsl_vector * vT, TermDerivs * d,
+                             FParams * params, int i, int m, double scale)
+{
+	double c1[3],c2[3];
+	StencilCoefs(params->grid,i,c1,c2);
+	double d1U = Deriv1(xi,0.0,5*(i-1),params->grid);
+	double vTi = gsl_vector_get(vT,i);
+
+	AddJ(J,i,m,i-1,0,scale*2*vTi*d1U*c1[0]);
+	AddJ(J,i,m,i+1,0,scale*2*vTi*d1U*c1[2]);
+	AddJ(J,i,m,i,1,scale*gsl_vector_get(d->dvTdk,i)*d1U*d1U);
+	AddJ(J,i,m,i,2,scale*gsl_vector_get(d->dvTdep,i)*d1U*d1U);
+	AddJ(J,i,m,i,3,scale*gsl_vector_get(d->dvTdv2,i)*d1U*d1U);
+}
+
+int SysJ(const gsl_vector * xi, void * p, BlockTridiag * J)
+{
+	Log(logDEBUG2) << "Setting up Jacobian of F(xi)";
+	struct FParams * params = (struct FParams *)p;
+
+	int vecSize = ((xi->size))/double(5)+1;  // size of single vector. I in doc.
+
+	// Same as in SysF, the Compute* functions need a non-const vector but only read it.
+	gsl_vector * tempxi = const_cast<gsl_vector *>(xi);
+
+	// Entry 0 (the wall) of the terms is never written, so the workspace vectors stay valid.
+	Workspace * w = params->work;
+	bool allocated = !WorkspaceFits(w,vecSize);
+	gsl_vector * vT, * T;
+	struct TermDerivs derivs;
+	if (allocated)
+	{
+		vT = ScratchVector(vecSize);
+		T  = ScratchVector(vecSize);
+		derivs = {ScratchVector(vecSize),ScratchVector(vecSize),
+			ScratchVector(vecSize),ScratchVector(vecSize),ScratchVector(vecSize)};
+	}
+	else
+	{
+		vT = w->vT;
+		T  = w->T;
+		derivs = {w->dTdk,w->dTdep,w->dvTdk,w->dvTdep,w->dvTdv2};
+	}
+	TermDerivs * d = &derivs;
+	BlockTridiagSetZero(J);
+
+	// As in SysResidualByTerm, one parallel region in which the setters share out their loops.
+	// Point i of equation m only adds to row 5*(i-1)+m of J, so each row is set by one thread
+	// in a fixed order and J does not depend on the number of threads.
+	int status = 0;
+	#pragma omp parallel num_threads(GridThreads(vecSize)) reduction(|:status)
+	{
+	#pragma omp for
+	for (unsigned int i = 1; i<vT->size;i++)
+	{
+		double dTdk,dTdep,dvT[3];
+		gsl_vector_set(T,i,ComputeTDerivs(tempxi,params->modelConst,i,&dTdk,&dTdep));
+		gsl_vector_set(vT,i,ComputeEddyViscDerivs(tempxi,T,params->modelConst,i,dTdk,dTdep,dvT));
+		gsl_vector_set(d->dTdk,i,dTdk);
+		gsl_vector_set(d->dTdep,i,dTdep);
+		gsl_vector_set(d->dvTdk,i,dvT[0]);
+		gsl_vector_set(d->dvTdep,i,dvT[1]);
+		gsl_vector_set(d->dvTdv2,i,dvT[2]);
+		if (!isfinite(gsl_vector_get(vT,i)))
+			status = 1;
+	}
+
+	if(SetUJac(tempxi,vT,d,params,J))
+	{
+		Log(logERROR) << "Error setting U rows of Jacobian";
+		status = 1;
+	}
+
+	if(SetKJac(tempxi,vT,d,params,J))
+	{
+		Log(logERROR) << "Error setting k rows of Jacobian";
+		status = 1;
+	}
+
+	if(SetEpJac(tempxi,vT,T,d,params,J))
+	{
+		Log(logERROR) << "Error setting ep rows of Jacobian";
+		status = 1;
+	}
+
+	if(SetV2Jac(tempxi,vT,d,params,J))
+	{
+		Log(logERROR) << "Error setting v2 rows of Jacobian";
+		status = 1;
+	}
+
+	if(SetFJac(tempxi,vT,T,d,params,J))
+	{
+		Log(logERROR) << "Error setting f rows of Jacobian";
+		status = 1;
+	}
+	}
+
+	// Cleanup
+	if (allocated)
+	{
+		gsl_vector_free(d->dTdk);
+		gsl_vector_free(d->dTdep);
+		gsl_vector_free(d->dvTdk);
+		gsl_vector_free(d->dvTdep);
+		gsl_vector_free(d->dvTdv2);
+		gsl_vector_free(vT);
+		gsl_vector_free(T);
+	}
+
+	return status;
+}
+
+int SysDf(const gsl_vector * xi, void * p, gsl_matrix * J)
+{
+	BlockTridiag * blockJ = BlockTridiagAlloc(xi->size/5);
+	int status = SysJ(xi,p,blockJ);
+	if (!status)
+		status = BlockTridiagToDense(blockJ,J);
+	BlockTridiagFree(blockJ);
+	return status;
+}
+
+int SysFdf(const gsl_vector * xi, void * p, gsl_vector * sysF, gsl_matrix * J)
+{
+	if (SysF(xi,p,sysF))
+		return GSL_EBADFUNC;
+	return SysDf(xi,p,J);
+}
+
+int SetUJac(gsl_vector * xi, gsl_vector * vT, TermDerivs * d, FParams * params, BlockTridiag * J)
+{
+	Log(logDEBUG2) << "Setting U rows of Jacobian";
+	int size = vT->size;
+	#pragma omp for
+	for (int i = 1; i<size-1; i++)
+	{
+		AddJ(J,i,0,i,0,-1/TimeStep(params,5*(i-1)+0));
+		AddDiffusionJac(J,xi,vT,d,params,i,0,0.0,1.0,1.0);
+	}
+
+	//boundary terms.
+	#pragma omp single
+	{
+	int i = size-1;
+	AddJ(J,i,0,i,0,-1/TimeStep(params,5*(i-1)+0));
+	AddBdryDiffusionJac(J,xi,vT,d,params,i,0,1.0);
+	}
+	return 0;
+}
+
+int SetKJac(gsl_vector * xi, gsl_vector * vT, TermDerivs * d, FParams * params, BlockTridiag * J)
+{
+	Log(logDEBUG2) << "Setting k rows of Jacobian";
+	int size = vT->size;
+	#pragma omp for
+	for (int i = 1; i<size-1; i++)
+	{
+		AddJ(J,i,1,i,1,-1/TimeStep(params,5*(i-1)+1));
+		AddProductionJac(J,xi,vT,d,params,i,1,1.0);
+		AddJ(J,i,1,i,2,-1.0);
+		AddDiffusionJac(J,xi,vT,d,params,i,1,0.0,1.3,1.0);
+	}
+
+	#pragma omp single
+	{
+	int i = size-1;
+	AddJ(J,i,1,i,1,-1/TimeStep(params,5*(i-1)+1));
+	AddJ(J,i,1,i,2,-1.0);
+	AddBdryDiffusionJac(J,xi,vT,d,params,i,1,1.3);
+	}
+	return 0;
+}
+
+int SetEpJac(gsl_vector * xi, gsl_vector * vT, gsl_vector * T, TermDerivs * d, FParams * params, BlockTridiag * J)
+{
+	Log(logDEBUG2) << "Setting ep rows of Jacobian";
+	int size = vT->size;
+	constants * c = params->modelConst;
+	double ep0 = ComputeEp0(xi,c,params->grid);
+	double delta_y_0 = gsl_vector_get(params->grid->y, 0);
+	double dep0dk = 2/(c->reyn*pow(delta_y_0,2)); // ep0 only depends on k at the first point.
+
+	#pragma omp for
+	for (int i = 1; i<size-1; i++)
+	{
+		int xiCounter = 5*(i-1);
+		double Ti = gsl_vector_get(T,i);
+		double source = c->Cep1*ComputeP(xi,vT,params->grid,i) - c->Cep2*gsl_vector_get(xi,xiCounter+2);
+
+		AddJ(J,i,2,i,2,-1/TimeStep(params,5*(i-1)+2));
+		AddProductionJac(J,xi,vT,d,params,i,2,c->Cep1/Ti);
+		AddJ(J,i,2,i,2,-c->Cep2/Ti);
+		AddJ(J,i,2,i,1,-source*gsl_vector_get(d->dTdk,i)/(Ti*Ti));
+		AddJ(J,i,2,i,2,-source*gsl_vector_get(d->dTdep,i)/(Ti*Ti));
+		double dbdry = AddDiffusionJac(J,xi,vT,d,params,i,2,ep0,c->sigmaEp,c->sigmaEp);
+		if (i == 1)
+			AddJ(J,i,2,1,1,dbdry*dep0dk);
+	}
+
+	#pragma omp single
+	{
+	int i = size-1;
+	int xiCounter = 5*(i-1);
+	double Ti = gsl_vector_get(T,i);
+	double ep = gsl_vector_get(xi,xiCounter+2);
+	AddJ(J,i,2,i,2,-1/TimeStep(params,5*(i-1)+2) - c->Cep2/Ti + c->Cep2*ep*gsl_vector_get(d->dTdep,i)/(Ti*Ti));
+	AddJ(J,i,2,i,1,c->Cep2*ep*gsl_vector_get(d->dTdk,i)/(Ti*Ti));
+	AddBdryDiffusionJac(J,xi,vT,d,params,i,2,c->sigmaEp);
+	}
+	return 0;
+}
+
+int SetV2Jac(gsl_vector * xi, gsl_vector * vT, TermDerivs * d, FParams * params, BlockTridiag * J)
+{
+	Log(logDEBUG2) << "Setting v2 rows of Jacobian";
+	int size = vT->size;
+	#pragma omp for
+	for (int i = 1; i<size; i++)
+	{
+		int xiCounter = 5*(i-1);
+		double k = gsl_vector_get(xi,xiCounter+1);
+		double ep = gsl_vector_get(xi,xiCounter+2);
+		double v2 = gsl_vector_get(xi,xiCounter+3);
+		double f = gsl_vector_get(xi,xiCounter+4);
+
+		// k*f - ep*v2/k is the same in the interior and at the centerline.
+		AddJ(J,i,3,i,3,-1/TimeStep(params,5*(i-1)+3) - ep/k);
+		AddJ(J,i,3,i,1,f + ep*v2/(k*k));
+		AddJ(J,i,3,i,2,-v2/k);
+		AddJ(J,i,3,i,4,k);
+		if (i < size-1)
+			AddDiffusionJac(J,xi,vT,d,params,i,3,0.0,1.0,1.0);
+		else
+			AddBdryDiffusionJac(J,xi,vT,d,params,i,3,1.0);
+	}
+	return 0;
+}
+
+int SetFJac(gsl_vector * xi, gsl_vector * vT, gsl_vector * T, TermDerivs * d, FParams * params, BlockTridiag * J)
+{
+	Log(logDEBUG2) << "Setting f rows of Jacobian";
+	int size = vT->size;
+	constants * c = params->modelConst;
+	double c1[3],c2[3];
+	double f0 = Computef0(xi,c,params->grid);
+	double ep0 = ComputeEp0(xi,c,params->grid);
+	double delta_y_0 = gsl_vector_get(params->grid->y, 0);
+	// f0 depends on v2 and (through ep0) on k at the first point.
+	double df0dv2 = -20/(pow(c->reyn,2)*ep0*pow(delta_y_0,4));
+	double df0dk = -(f0/ep0)*2/(c->reyn*pow(delta_y_0,2));
+
+	#pragma omp for private(c1,c2)
+	for (int i = 1; i<size; i++)
+	{
+		int xiCounter = 5*(i-1);
+		double dLdk,dLdep;
+		double L = ComputeLDerivs(xi,c,i,&dLdk,&dLdep);
+		double Ti = gsl_vector_get(T,i);
+		double k = gsl_vector_get(xi,xiCounter+1);
+		double v2 = gsl_vector_get(xi,xiCounter+3);
+		double g = v2/k - float(2)/3; // float, as in SetFTerms
+		double d2f;
+
+		AddJ(J,i,4,i,4,-1/TimeStep(params,5*(i-1)+4) - 1.0);
+
+		// L^2*d^2f/dy^2
+		if (i < size-1)
+		{
+			StencilCoefs(params->grid,i,c1,c2);
+			d2f = Deriv2(xi,f0,xiCounter+4,params->grid);
+			for (int o = -1; o <= 1; o++)
+				AddJ(J,i,4,i+o,4,L*L*c2[o+1]);
+			if (i == 1)
+			{
+				AddJ(J,i,4,1,3,L*L*c2[0]*df0dv2);
+				AddJ(J,i,4,1,1,L*L*c2[0]*df0dk);
+			}
+		}
+		else
+		{
+			d2f = BdryDeriv2(xi,xiCounter+4,params->grid);
+			AddJ(J,i,4,i,4,L*L*params->grid->deriv2Center[i-1]);
+			AddJ(J,i,4,i-1,4,L*L*params->grid->deriv2Lower[i-1]);
+		}
+		AddJ(J,i,4,i,1,2*L*dLdk*d2f);
+		AddJ(J,i,4,i,2,2*L*dLdep*d2f);
+
+		// C2*P/k, which is not included at the centerline.
+		if (i < size-1)
+		{
+			AddProductionJac(J,xi,vT,d,params,i,4,c->C2/k);
+			AddJ(J,i,4,i,1,-c->C2*ComputeP(xi,vT,params->grid,i)/(k*k));
+		}
+
+		// -(C1/T)*(v2/k-2/3)
+		AddJ(J,i,4,i,3,-c->C1/(Ti*k));
+		AddJ(J,i,4,i,1,c->C1*v2/(Ti*k*k) + c->C1*g*gsl_vector_get(d->dTdk,i)/(Ti*Ti));
+		AddJ(J,i,4,i,2,c->C1*g*gsl_vector_get(d->dTdep,i)/(Ti*Ti));
+	}
+	return 0;
+}
@@ -0,0 +1,122 @@
+/**
+ * \file
+ *
+ * \brief Analytic Jacobian of the system \f$F(\xi)\f$.
+ *
+ * This file defines the exact derivatives of the residuals set by SetUTerms, SetKTerms,
+ * SetEpTerms, SetV2Terms and SetFTerms. Since every term only depends on the unknowns at
+ * a grid point and its two neighbors, the Jacobian is assembled as a BlockTridiag of 5x5 blocks.
+ */
+#ifndef JACOBIAN_H
+#define JACOBIAN_H
+#include<gsl/gsl_vector.h>
+#include<gsl/gsl_matrix.h>
+#include"systemSolve.h"
+#include"blockTridiag.h"
+using namespace std;
+
+/**
+ * \brief Derivatives of the derived terms at every grid point.
+ *
+ * Same layout as the T and vT vectors in SysF (index 0 is the wall).
+ */
+struct TermDerivs {
+	gsl_vector * dTdk; /**< \f$\partial T/\partial k\f$ */
+	gsl_vector * dTdep; /**< \f$\partial T/\partial \epsilon\f$ */
+	gsl_vector * dvTdk; /**< \f$\partial \nu_T/\partial k\f$ */
+	gsl_vector * dvTdep; /**< \f$\partial \nu_T/\partial \epsilon\f$ */
+	gsl_vector * dvTdv2; /**< \f$\partial \nu_T/\partial \overline{v^2}\f$ */
+};
+
+/**
+ * \brief Main function to set up the Jacobian of the system.
+ *
+ * The rows are set in one parallel region of GridThreads threads, and J is the same for any
+ * number of threads.
+ * \param xi pointer to gsl_vector of unknowns at n+1 time step.
+ * \param p pointer to parameters for system (FParams).
+ * \param J block tridiagonal Jacobian, with xi->size/5 block rows.
+ * \return Error code (0 = success).
+ */
+int SysJ(const gsl_vector * xi, void * p, BlockTridiag * J);
+
+/**
+ * \brief Dense Jacobian, with the signature needed by gsl_multiroot_function_fdf.
+ *
+ * Only meant for small grids, since J is 5N x 5N.
+ * \param xi pointer to gsl_vector of unknowns at n+1 time step.
+ * \param p pointer to parameters for system (FParams).
+ * \param J dense Jacobian.
+ * \return Error code (0 = success).
+ */
+int SysDf(const gsl_vector * xi, void * p, gsl_matrix * J);
+
+/**
+ * \brief Residual and dense Jacobian, with the signature needed by gsl_multiroot_function_fdf.
+ *
+ * \param xi pointer to gsl_vector of unknowns at n+1 time step.
+ * \param p pointer to parameters for system (FParams).
+ * \param sysF gsl_vector defining multiroot function.
+ * \param J dense Jacobian.
+ * \return Error code (0 = success).
+ */
+int SysFdf(const gsl_vector * xi, void * p, gsl_vector * sysF, gsl_matrix * J);
+
+/**
+ * \brief Sets rows of Jacobian related to mean velocity, U.
+ * \param xi pointer to gsl_vector of unknowns \f$ U,k,\epsilon,\overline{v^2},f\f$.
+ * \param vT pointer to vector of eddy viscosity.
+ * \param d pointer to derivatives of T and \f$\nu_T\f$.
+ * \param params pointer to parameters of system.
+ * \param J block tridiagonal Jacobian.
+ * \return Error code (0 = success).
+ */
+int SetUJac(gsl_vector * xi, gsl_vector * vT, TermDerivs * d, FParams * params, BlockTridiag * J);
+
+/**
+ * \brief Sets rows of Jacobian related to kinetic energy, k.
+ * \param xi pointer to gsl_vector of unknowns \f$ U,k,\epsilon,\overline{v^2},f\f$.
+ * \param vT pointer to vector of eddy viscosity.
+ * \param d pointer to derivatives of T and \f$\nu_T\f$.
+ * \param params pointer to parameters of system.
+ * \param J block tridiagonal Jacobian.
+ * \return Error code (0 = success).
+ */
+int SetKJac(gsl_vector * xi, gsl_vector * vT, TermDerivs * d, FParams * params, BlockTridiag * J);
+
+/**
+ * \brief Sets rows of Jacobian related to dissipation, \f$\epsilon\f$.
+ * \param xi pointer to gsl_vector of unknowns \f$ U,k,\epsilon,\overline{v^2},f\f$.
+ * \param vT pointer to vector of eddy viscosity.
+ * \param T pointer to gsl_vector of turbulent time scale.
+ * \param d pointer to derivatives of T and \f$\nu_T\f$.
+ * \param params pointer to parameters of system.
+ * \param J block tridiagonal Jacobian.
+ * \return Error code (0 = success).
+ */
+int SetEpJac(gsl_vector * xi, gsl_vector * vT, gsl_vector * T, TermDerivs * d, FParams * params, BlockTridiag * J);
+
+/**
+ * \brief Sets rows of Jacobian related to velocity scale, \f$\overline{v^2}\f$.
+ * \param xi pointer to gsl_vector of unknowns \f$ U,k,\epsilon,\overline{v^2},f\f$.
+ * \param vT pointer to vector of eddy viscosity.
+ * \param d pointer to derivatives of T and \f$\nu_T\f$.
+ * \param params pointer to parameters of system.
+ * \param J block tridiagonal Jacobian.
+ * \return Error code (0 = success).
+ */
+int SetV2Jac(gsl_vector * xi, gsl_vector * vT, TermDerivs * d, FParams * params, BlockTridiag * J);
+
+/**
+ * \brief Sets rows of Jacobian related to redistribution, f.
+ * \param xi pointer to gsl_vector of unknowns \f$ U,k,\epsilon,\overline{v^2},f\f$.
+ * \param vT pointer to vector of eddy viscosity.
+ * \param T pointer to gsl_vector of turbulent time scale.
+ * \param d pointer to derivatives of T and \f$\nu_T\f$.
+ * \param params pointer to parameters of system.
+ * \param J block tridiagonal Jacobian.
+ * \return Error code (0 = success).
+ */
+int SetFJac(gsl_vector * xi, gsl_vector * vT, gsl_vector * T, TermDerivs * d, FParams * params, BlockTridiag * J);
+
+#endif
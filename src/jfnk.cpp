@@ -0,0 +1,268 @@
+//--------------------------------------------------
+// jfnk: Jacobian-free Newton-Krylov solve of F(xi).
+//
+// 10/17/2026 - Written for solver = jfnk.
+// 10/17/2026 - Failed residual evaluations returned as GSL_EBADFUNC.
+// 10/17/2026 - GMRES stops when the operator or the preconditioner fails.
+//--------------------------------------------------
+#include<stdlib.h>
+#include<string.h>
+#include<math.h>
+#include<gsl/gsl_errno.h>
+#include<gsl/gsl_blas.h>
+#include<gsl/gsl_math.h>
+#include"jfnk.h"
+#include"jacobian.h"
+using namespace std;
+
+int JacVec(const gsl_vector * v, void * p, gsl_vector * Jv)
+{
+	struct JacVecParams * jp = (struct JacVecParams *)p;
+	double vnorm = gsl_blas_dnrm2(v);
+	if (vnorm == 0.0)
+	{
+		gsl_vector_set_zero(Jv);
+		return 0;
+	}
+
+	double h = GSL_SQRT_DBL_EPSILON*(1+gsl_blas_dnrm2(jp->x))/vnorm;
+	gsl_vector_memcpy(jp->xPert,jp->x);
+	gsl_blas_daxpy(h,v,jp->xPert);
+	if (SysF(jp->xPert,jp->params,jp->fPert))
+		return 1;
+
+	// Jv = (F(x+hv)-F(x))/h
+	gsl_vector_memcpy(Jv,jp->fPert);
+	gsl_vector_sub(Jv,jp->fx);
+	gsl_vector_scale(Jv,1/h);
+	return 0;
+}
+
+int ApplyPrecond(const gsl_vector * v, void * p, gsl_vector * Mv)
+{
+	struct JFNKPrecond * M = (struct JFNKPrecond *)p;
+	if (M->type == "none")
+		return gsl_vector_memcpy(Mv,v);
+	return BlockTridiagLUSolve(M->LU,v,Mv);
+}
+
+JFNKPrecond * JFNKPrecondAlloc(string type, unsigned int n)
+{
+	JFNKPrecond * M = new JFNKPrecond;
+	M->type = type;
+	M->J = NULL;
+	M->LU = NULL;
+	if (type != "none")
+	{
+		M->J = BlockTridiagAlloc(n);
+		M->LU = BlockTridiagLUAlloc(n);
+	}
+	return M;
+}
+
+void JFNKPrecondFree(JFNKPrecond * M)
+{
+	if (M->J)
+		BlockTridiagFree(M->J);
+	if (M->LU)
+		BlockTridiagLUFree(M->LU);
+	delete M;
+}
+
+int JFNKPrecondSet(JFNKPrecond * M, const gsl_vector * x, FParams * params)
+{
+	if (M->type == "none")
+		return 0;
+	if (SysJ(x,params,M->J))
+		return 1;
+	if (M->type == "blockjacobi")
+	{
+		// Only keep the coupling between unknowns at the same grid point.
+		memset(M->J->lower,0,M->J->n*BLOCK_ELEMS*sizeof(double));
+		memset(M->J->upper,0,M->J->n*BLOCK_ELEMS*sizeof(double));
+	}
+	return BlockTridiagFactor(M->J,M->LU);
+}
+
+int GMRES(LinearOp A, void * Aparams, LinearOp M, void * Mparams, const gsl_vector * b,
+          gsl_vector * x, int restart, int maxIter, double tol, int * iters)
+{
+	unsigned int n = b->size;
+	int m = restart;
+	int status = 1;
+	gsl_vector ** V = (gsl_vector **)malloc((m+1)*sizeof(gsl_vector *)); // Krylov basis
+	for (int i = 0; i <= m; i++)
+		V[i] = gsl_vector_alloc(n);
+	gsl_vector * w = gsl_vector_alloc(n);
+	gsl_vector * z = gsl_vector_alloc(n);
+	double * H  = (double *)calloc((m+1)*m,sizeof(double)); // Hessenberg matrix, H[i*m+j]
+	double * cs = (double *)calloc(m+1,sizeof(double));     // Givens rotations
+	double * sn = (double *)calloc(m+1,sizeof(double));
+	double * g  = (double *)calloc(m+1,sizeof(double));     // rotated residual
+	double * y  = (double *)calloc(m+1,sizeof(double));
+
+	double bnorm = gsl_blas_dnrm2(b);
+	*iters = 0;
+	if (bnorm == 0.0)
+	{
+		gsl_vector_set_zero(x);
+		status = 0;
+	}
+
+	while (status && *iters < maxIter)
+	{
+		// r = b - A*x
+		if (A(x,Aparams,w))
+		{
+			status = GMRES_OP_FAILED;
+			break;
+		}
+		gsl_vector_memcpy(V[0],b);
+		gsl_vector_sub(V[0],w);
+		double beta = gsl_blas_dnrm2(V[0]);
+		if (beta <= tol*bnorm)
+		{
+			status = 0;
+			break;
+		}
+		gsl_vector_scale(V[0],1/beta);
+		for (int i = 0; i <= m; i++)
+			g[i] = 0.0;
+		g[0] = beta;
+
+		// Arnoldi with modified Gram-Schmidt.
+		int k = 0;
+		while (k < m && *iters < maxIter)
+		{
+			(*iters)++;
+			if (M ? M(V[k],Mparams,z) : gsl_vector_memcpy(z,V[k]))
+			{
+				status = GMRES_OP_FAILED;
+				break;
+			}
+			if (A(z,Aparams,w))
+			{
+				status = GMRES_OP_FAILED;
+				break;
+			}
+			for (int i = 0; i <= k; i++)
+			{
+				gsl_blas_ddot(w,V[i],&H[i*m+k]);
+				gsl_blas_daxpy(-H[i*m+k],V[i],w);
+			}
+			H[(k+1)*m+k] = gsl_blas_dnrm2(w);
+			if (H[(k+1)*m+k] > 0.0)
+			{
+				gsl_vector_memcpy(V[k+1],w);
+				gsl_vector_scale(V[k+1],1/H[(k+1)*m+k]);
+			}
+
+			// Apply the previous rotations to the new column, then zero H[k+1][k].
+			for (int i = 0; i < k; i++)
+			{
+				double temp = cs[i]*H[i*m+k] + sn[i]*H[(i+1)*m+k];
+				H[(i+1)*m+k] = -sn[i]*H[i*m+k] + cs[i]*H[(i+1)*m+k];
+				H[i*m+k] = temp;
+			}
+			double denom = hypot(H[k*m+k],H[(k+1)*m+k]);
+			if (denom == 0.0)
+				break;
+			cs[k] = H[k*m+k]/denom;
+			sn[k] = H[(k+1)*m+k]/denom;
+			H[k*m+k] = denom;
+			H[(k+1)*m+k] = 0.0;
+			g[k+1] = -sn[k]*g[k];
+			g[k] = cs[k]*g[k];
+			k++;
+			if (fabs(g[k]) <= tol*bnorm)
+			{
+				status = 0;
+				break;
+			}
+		}
+		// The basis is not valid, so x is left at the last restart.
+		if (status == GMRES_OP_FAILED)
+			break;
+
+		// x = x + M^{-1}*V*y, where H*y = g.
+		for (int i = k-1; i >= 0; i--)
+		{
+			double val = g[i];
+			for (int j = i+1; j < k; j++)
+				val -= H[i*m+j]*y[j];
+			y[i] = val/H[i*m+i];
+		}
+		gsl_vector_set_zero(w);
+		for (int i = 0; i < k; i++)
+			gsl_blas_daxpy(y[i],V[i],w);
+		if (M ? M(w,Mparams,z) : gsl_vector_memcpy(z,w))
+		{
+			status = GMRES_OP_FAILED;
+			break;
+		}
+		gsl_vector_add(x,z);
+		if (k == 0)
+			break;
+	}
+
+	for (int i = 0; i <= m; i++)
+		gsl_vector_free(V[i]);
+	free(V);
+	gsl_vector_free(w);
+	gsl_vector_free(z);
+	free(H);
+	free(cs);
+	free(sn);
+	free(g);
+	free(y);
+	return status;
+}
+
+int JFNKStep(gsl_vector * x, FParams * params, JFNKPrecond * M, solverOptions * solverOpts,
+             const gsl_vector * fx, gsl_vector * f)
+{
+	int iters;
+
+	// Solve J*dx = -F(x), with J only available through JacVec.
+	if (fx)
+		gsl_vector_memcpy(f,fx);
+	else if (SysF(x,params,f))
+		return GSL_EBADFUNC;
+	if (JFNKPrecondSet(M,x,params))
+	{
+		Log(logERROR) << "Error setting up preconditioner";
+		return GSL_ESING;
+	}
+
+	gsl_vector * dx = gsl_vector_calloc(x->size);
+	gsl_vector * rhs = gsl_vector_alloc(x->size);
+	struct JacVecParams jp = {x,f,params,gsl_vector_alloc(x->size),gsl_vector_alloc(x->size)};
+	gsl_vector_memcpy(rhs,f);
+	gsl_vector_scale(rhs,-1.0);
+	int status = GMRES(&JacVec,&jp,&ApplyPrecond,M,rhs,dx,solverOpts->gmresRestart,
+	                   solverOpts->gmresMaxIter,solverOpts->gmresTol,&iters);
+	if (status == GMRES_OP_FAILED)
+	{
+		// x and f are left at the current iterate.
+		Log(logERROR) << "GMRES stopped after " << iters << " iterations, F or the preconditioner failed";
+		status = GSL_EBADFUNC;
+	}
+	else
+	{
+		if (status)
+		{
+			Log(logWARNING) << "GMRES did not converge in " << iters << " iterations";
+		}
+		Log(logDEBUG) << "GMRES iterations: " << iters;
+
+		gsl_vector_add(x,dx);
+		status = SysF(x,params,f) ? GSL_EBADFUNC : GSL_SUCCESS;
+	}
+
+	// Cleanup
+	gsl_vector_free(dx);
+	gsl_vector_free(rhs);
+	gsl_vector_free(jp.xPert);
+	gsl_vector_free(jp.fPert);
+	return status;
+}
@@ -0,0 +1,129 @@
+/**
+ * \file
+ *
+ * \brief Jacobian-free Newton-Krylov solve of the system \f$F(\xi)\f$.
+ *
+ * The Newton update is found with restarted GMRES, where every product of the Jacobian
+ * with a vector is approximated by a directional finite difference of SysF, so the Jacobian
+ * itself is never formed. GMRES is right preconditioned with either the block diagonal
+ * (block Jacobi) or the full block tridiagonal part of the analytic Jacobian. The
+ * preconditioner only needs to be close to the true Jacobian, so model terms can be added
+ * to SysF without updating SysJ.
+ */
+#ifndef JFNK_H
+#define JFNK_H
+#include<gsl/gsl_vector.h>
+#include"systemSolve.h"
+#include"blockTridiag.h"
+using namespace std;
+
+#define GMRES_OP_FAILED -1 /**< GMRES stopped because the operator or the preconditioner failed. */
+
+/**
+ * \brief Linear operator \f$y = Av\f$, as used by GMRES.
+ *
+ * \param v vector to apply operator to.
+ * \param p pointer to parameters of operator.
+ * \param Av result.
+ * \return Error code (0 = success).
+ */
+typedef int (*LinearOp)(const gsl_vector * v, void * p, gsl_vector * Av);
+
+/**
+ * \brief Parameters for the finite difference Jacobian-vector product.
+ */
+struct JacVecParams {
+	const gsl_vector * x; /**< point at which the Jacobian is taken. */
+	const gsl_vector * fx; /**< F(x). */
+	FParams * params; /**< parameters of the system. */
+	gsl_vector * xPert; /**< work vector for x + h*v. */
+	gsl_vector * fPert; /**< work vector for F(x + h*v). */
+};
+
+/**
+ * \brief Preconditioner for GMRES, built from the stencil structure of the system.
+ */
+struct JFNKPrecond {
+	string type; /**< "none", "blockjacobi" or "blocktridiag". */
+	BlockTridiag * J; /**< approximate Jacobian. */
+	BlockTridiagLU * LU; /**< factorization of J. */
+};
+
+/**
+ * \brief Approximates the product of the Jacobian of SysF with v.
+ *
+ * Uses \f$ Jv \approx (F(x+hv)-F(x))/h \f$ with \f$ h = \sqrt{\epsilon}(1+\|x\|)/\|v\| \f$.
+ * \param v vector to multiply.
+ * \param p pointer to JacVecParams.
+ * \param Jv result.
+ * \return Error code (0 = success).
+ */
+int JacVec(const gsl_vector * v, void * p, gsl_vector * Jv);
+
+/**
+ * \brief Applies the inverse of the preconditioner, \f$y = M^{-1}v\f$.
+ * \param v vector to apply preconditioner to.
+ * \param p pointer to JFNKPrecond.
+ * \param Mv result.
+ * \return Error code (0 = success).
+ */
+int ApplyPrecond(const gsl_vector * v, void * p, gsl_vector * Mv);
+
+/**
+ * \brief Allocate a preconditioner for a system of n grid points.
+ * \param type "none", "blockjacobi" or "blocktridiag".
+ * \param n number of grid points.
+ * \return pointer to new preconditioner.
+ */
+JFNKPrecond * JFNKPrecondAlloc(string type, unsigned int n);
+
+/**
+ * \brief Free a preconditioner.
+ * \param M pointer to preconditioner.
+ */
+void JFNKPrecondFree(JFNKPrecond * M);
+
+/**
+ * \brief Build and factor the preconditioner at x.
+ * \param M pointer to preconditioner.
+ * \param x point at which to build the preconditioner.
+ * \param params parameters of the system.
+ * \return Error code (0 = success).
+ */
+int JFNKPrecondSet(JFNKPrecond * M, const gsl_vector * x, FParams * params);
+
+/**
+ * \brief Restarted, right preconditioned GMRES for Ax = b.
+ *
+ * \param A linear operator.
+ * \param Aparams parameters of A.
+ * \param M inverse of preconditioner (NULL for none).
+ * \param Mparams parameters of M.
+ * \param b right hand side.
+ * \param x initial guess on input, solution on output.
+ * \param restart number of iterations before restarting.
+ * \param maxIter maximum number of iterations.
+ * \param tol stop when \f$\|b-Ax\| \le tol \|b\|\f$.
+ * \param iters returns the number of iterations taken.
+ * \return Error code (0 = converged, 1 = not converged, GMRES_OP_FAILED if A or M returned an error,
+ *         with x left at the last restart).
+ */
+int GMRES(LinearOp A, void * Aparams, LinearOp M, void * Mparams, const gsl_vector * b,
+          gsl_vector * x, int restart, int maxIter, double tol, int * iters);
+
+/**
+ * \brief One Newton step solved with preconditioned GMRES.
+ *
+ * \param x current iterate on input, updated iterate on output.
+ * \param params parameters of the system.
+ * \param M preconditioner.
+ * \param solverOpts pointer to solver options (GMRES restart, tolerance, iterations).
+ * \param fx F(x), or NULL to have it evaluated.
+ * \param f residual at the updated x.
+ * \return Error code (0 = success, GSL_EBADFUNC if F failed at the update or in GMRES, which
+ *         leaves x and f at the current iterate).
+ */
+int JFNKStep(gsl_vector * x, FParams * params, JFNKPrecond * M, solverOptions * solverOpts,
+             const gsl_vector * fx, gsl_vector * f);
+
+#endif
@@ -0,0 +1,125 @@
+//--------------------------------------------------
+// lineSearch: Positivity limiter and backtracking
+// line search for the Newton steps.
+//
+// 10/17/2026 - Written to replace clipping k and v2
+//              as the only safeguard in NewtonSolve.
+// 10/17/2026 - Steps kept above K_MIN and V2_MIN instead of clipped to them.
+// 10/17/2026 - Values on their bound held there, and SysF failures returned.
+// 10/17/2026 - Positivity limit of the Anderson mixed steps.
+//--------------------------------------------------
+#include<math.h>
+#include<gsl/gsl_blas.h>
+#include"lineSearch.h"
+#include"computeTerms.h"
+using namespace std;
+
+LineSearch * LineSearchAlloc(size_t n, solverOptions * solverOpts)
+{
+	LineSearch * ls = new LineSearch;
+	ls->tau = solverOpts->lsTau;
+	ls->c = 1e-4;
+	ls->maxBacktracks = solverOpts->lsMaxBacktracks;
+	ls->dx = gsl_vector_alloc(n);
+	ls->limitedCount = 0;
+	ls->backtrackCount = 0;
+	ls->failedCount = 0;
+	ls->heldCount = 0;
+	return ls;
+}
+
+void LineSearchFree(LineSearch * ls)
+{
+	gsl_vector_free(ls->dx);
+	delete ls;
+}
+
+// Largest alpha <= 1 that removes at most tau of the distance of k, ep and v2 to their
+// bounds (K_MIN, 0 and V2_MIN), so they never reach them. Values already on or below their
+// bound would give alpha = 0, so they are left out and the step holds them where they are.
+static double PositivityLimit(const gsl_vector * xi, gsl_vector * dx, double tau, bool * held)
+{
+	double alpha = 1.0;
+	*held = false;
+	for (unsigned int i = 0; i < xi->size; i++)
+	{
+		int m = i%5;
+		if (m != 1 && m != 2 && m != 3)
+			continue;
+		double d = gsl_vector_get(dx,i);
+		if (d >= 0.0)
+			continue;
+		double bound = (m == 1) ? K_MIN : (m == 3) ? V2_MIN : 0.0;
+		double distance = gsl_vector_get(xi,i) - bound;
+		if (distance <= 0.0)
+		{
+			gsl_vector_set(dx,i,0.0);
+			*held = true;
+			continue;
+		}
+		alpha = fmin(alpha,tau*distance/(-d));
+	}
+	return alpha;
+}
+
+// x = xi + alpha*dx and f = F(x). Returns the status of SysF.
+static int EvalStep(const gsl_vector * xi, double alpha, const gsl_vector * dx, FParams * params, gsl_vector * x, gsl_vector * f)
+{
+	gsl_vector_memcpy(x,xi);
+	gsl_blas_daxpy(alpha,dx,x);
+	return SysF(x,params,f);
+}
+
+int LineSearchStep(const gsl_vector * xi, gsl_vector * x, FParams * params, const gsl_vector * fxi, gsl_vector * f, LineSearch * ls, double * alphaOut)
+{
+	gsl_vector_memcpy(ls->dx,x);
+	gsl_vector_sub(ls->dx,xi);
+	double phi0 = gsl_blas_dnrm2(fxi);
+	phi0 = 0.5*phi0*phi0;
+
+	bool held;
+	double alphaMax = PositivityLimit(xi,ls->dx,ls->tau,&held);
+	if (alphaMax < 1.0)
+		ls->limitedCount++;
+	if (held)
+		ls->heldCount++;
+	double alpha = alphaMax;
+	for (int k = 0; ; k++)
+	{
+		// f already holds F at the full step, unless values were held on their bound.
+		if (alpha < 1.0 || held)
+		{
+			int status = EvalStep(xi,alpha,ls->dx,params,x,f);
+			if (status)
+				return status;
+		}
+		held = false;
+		double phi = gsl_blas_dnrm2(f);
+		phi = 0.5*phi*phi;
+		if (phi <= (1.0 - 2.0*ls->c*alpha)*phi0)
+			break;
+		if (k == ls->maxBacktracks)
+		{
+			// Tiny steps only stall the pseudo time iteration, so the limited step is taken and 
+			// the time step controller deals with the growing residual.
+			ls->failedCount++;
+			*alphaOut = alphaMax;
+			return EvalStep(xi,alphaMax,ls->dx,params,x,f);
+		}
+		alpha *= 0.5;
+		ls->backtrackCount++;
+	}
+	*alphaOut = alpha;
+	return 0;
+}
+
+double LineSearchLimit(const gsl_vector * xi, gsl_vector * x, LineSearch * ls)
+{
+	gsl_vector_memcpy(ls->dx,x);
+	gsl_vector_sub(ls->dx,xi);
+	bool held;
+	double alpha = PositivityLimit(xi,ls->dx,ls->tau,&held);
+	gsl_vector_memcpy(x,xi);
+	gsl_blas_daxpy(alpha,ls->dx,x);
+	return alpha;
+}
@@ -0,0 +1,78 @@
+/**
+ * \file
+ *
+ * \brief Globalization of the pseudo time Newton steps.
+ *
+ * A step \f$\delta = x - \xi\f$ from one of the Newton solvers is first limited so the unknowns
+ * that must stay above a bound \f$l_j\f$ (K_MIN for \f$k\f$, 0 for \f$\epsilon\f$ and V2_MIN for
+ * \f$\overline{v^2}\f$) lose at most a fraction \f$\tau\f$ of their distance to it,
+ * \f[ \alpha_{max} = \min\left(1, \min_{\delta_j < 0} \frac{\tau (\xi_j - l_j)}{-\delta_j}\right). \f]
+ * The whole step is scaled, so its direction is kept, and the unknowns are not clipped
+ * (Limit) afterwards: F of the step is F of the point the solver takes. Values already on or
+ * below their bound would give \f$\alpha_{max} = 0\f$ and discard every step, so they are left
+ * out of the limit and the step holds them where they are (\f$\delta_j = 0\f$). Then \f$\alpha\f$ is halved from \f$\alpha_{max}\f$ until the
+ * merit function \f$\phi(\alpha) = \frac{1}{2}\|F(\xi + \alpha\delta)\|^2\f$ (with the time term of
+ * the step) satisfies the Armijo condition for a Newton direction,
+ * \f$\phi(\alpha) \le (1 - 2c\alpha)\phi(0)\f$.
+ */
+#ifndef LINESEARCH_H
+#define LINESEARCH_H
+#include<gsl/gsl_vector.h>
+#include"systemSolve.h"
+#include"setup.h"
+using namespace std;
+
+/**
+ * \brief Line search parameters, work vector and counters.
+ */
+struct LineSearch {
+	double tau; /**< largest fraction of the distance of k, ep or v2 to its bound removed by one step. */
+	double c; /**< Armijo constant. */
+	int maxBacktracks; /**< largest number of halvings. */
+	gsl_vector * dx; /**< the full step. */
+	int limitedCount; /**< number of steps scaled by the positivity limiter. */
+	int backtrackCount; /**< number of halvings. */
+	int failedCount; /**< steps that took the smallest \f$\alpha\f$ without meeting the Armijo condition. */
+	int heldCount; /**< steps that held values on their bound. */
+};
+
+/**
+ * \brief Allocate a line search for vectors of size n.
+ * \param n size of the unknowns.
+ * \param solverOpts pointer to solver options (ls_*).
+ * \return pointer to new LineSearch.
+ */
+LineSearch * LineSearchAlloc(size_t n, solverOptions * solverOpts);
+
+/**
+ * \brief Free a LineSearch.
+ * \param ls pointer to LineSearch.
+ */
+void LineSearchFree(LineSearch * ls);
+
+/**
+ * \brief Scales the step from xi to x.
+ * \param xi unknowns before the step.
+ * \param x full step on input, \f$\xi + \alpha\delta\f$ on output.
+ * \param params parameters of the step, with XiN = xi.
+ * \param fxi \f$F(\xi)\f$.
+ * \param f F(x) on input, \f$F(\xi + \alpha\delta)\f$ on output.
+ * \param ls pointer to LineSearch.
+ * \param alpha set to \f$\alpha\f$.
+ * \return status of SysF at the scaled step (0 = success).
+ */
+int LineSearchStep(const gsl_vector * xi, gsl_vector * x, FParams * params, const gsl_vector * fxi, gsl_vector * f, LineSearch * ls, double * alpha);
+
+/**
+ * \brief Scales the step from xi to x by the positivity limit only, without the line search.
+ *
+ * For points that are not Newton steps, such as the Anderson mixed steps, whose residual is
+ * tested by the caller.
+ * \param xi unknowns before the step.
+ * \param x full step on input, \f$\xi + \alpha_{max}\delta\f$ on output.
+ * \param ls pointer to LineSearch.
+ * \return \f$\alpha_{max}\f$.
+ */
+double LineSearchLimit(const gsl_vector * xi, gsl_vector * x, LineSearch * ls);
+
+#endif
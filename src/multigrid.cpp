@@ -0,0 +1,159 @@
+//--------------------------------------------------
+// multigrid: FAS nonlinear multigrid solve of F(xi).
+//
+// 10/17/2026 - Written for solver = fas.
+// 10/17/2026 - One workspace per level.
+// 10/17/2026 - Limit from computeTerms.h instead of a copy.
+//--------------------------------------------------
+#include<math.h>
+#include<gsl/gsl_multiroots.h>
+#include<gsl/gsl_blas.h>
+#include"multigrid.h"
+#include"gridTransfer.h"
+#include"computeTerms.h"
+#include"workspace.h"
+using namespace std;
+
+// r = F(x) - b on level l.
+static int Residual(Multigrid * mg, unsigned int l)
+{
+	MGLevel * L = &mg->levels[l];
+	int status = SysF(L->x,&L->params,L->r);
+	gsl_vector_sub(L->r,L->b);
+	return status;
+}
+
+// x -= omega*D^{-1}(F(x) - b), nu times.
+static int Relax(Multigrid * mg, unsigned int l, int nu, double omega)
+{
+	MGLevel * L = &mg->levels[l];
+	for (int k = 0; k < nu; k++)
+	{
+		if (Residual(mg,l) || JFNKPrecondSet(L->D,L->x,&L->params) || ApplyPrecond(L->r,L->D,L->dx))
+			return 1;
+		Log(logDEBUG) << "Level " << l << " sweep " << k << ": residual norm " << gsl_blas_dnrm2(L->r);
+		gsl_blas_daxpy(-omega,L->dx,L->x);
+		Limit(L->x);
+	}
+	return 0;
+}
+
+Multigrid * MultigridAlloc(Grid * grid, constants * modelConst, solverOptions * solverOpts)
+{
+	// Level l has ceil(N/2^l) points, and none has fewer than SEQ_MIN_SIZE.
+	unsigned int levels = solverOpts->gridLevels;
+	while (levels > 1 && ceil(grid->getSize()/pow(2.0,levels-1)) < SEQ_MIN_SIZE)
+		levels--;
+
+	Multigrid * mg = new Multigrid;
+	mg->nLevels = levels;
+	mg->levels = new MGLevel[levels];
+	mg->gamma = (solverOpts->mgCycle == "w") ? 2 : 1;
+	mg->preSmooth = solverOpts->mgPreSmooth;
+	mg->postSmooth = solverOpts->mgPostSmooth;
+	mg->coarseIters = solverOpts->mgCoarseIters;
+	mg->omega = solverOpts->mgOmega;
+	mg->deltaT = solverOpts->mgDeltaT;
+	mg->modelConst = modelConst;
+	for (unsigned int l = 0; l < levels; l++)
+	{
+		MGLevel * L = &mg->levels[l];
+		L->grid = (l == 0) ? grid : new Grid(grid->isUniform,1.0,GridSize(ceil(grid->getSize()/pow(2.0,l))));
+		unsigned int n = L->grid->getSize();
+		L->x = gsl_vector_calloc(5*n);
+		L->x0 = gsl_vector_calloc(5*n);
+		L->b = gsl_vector_calloc(5*n);
+		L->r = gsl_vector_calloc(5*n);
+		L->dx = gsl_vector_calloc(5*n);
+		L->p = gsl_vector_calloc(5*n);
+		bool line = (l == levels-1) || solverOpts->mgSmoother == "line";
+		L->D = JFNKPrecondAlloc(line ? "blocktridiag" : "blockjacobi",n);
+		FParams params = {L->x,mg->deltaT,L->grid,modelConst,NULL,WorkspaceAlloc(n+1)};
+		L->params = params;
+	}
+	return mg;
+}
+
+void MultigridFree(Multigrid * mg)
+{
+	for (unsigned int l = 0; l < mg->nLevels; l++)
+	{
+		MGLevel * L = &mg->levels[l];
+		if (l > 0)
+			delete L->grid;
+		gsl_vector_free(L->x);
+		gsl_vector_free(L->x0);
+		gsl_vector_free(L->b);
+		gsl_vector_free(L->r);
+		gsl_vector_free(L->dx);
+		gsl_vector_free(L->p);
+		JFNKPrecondFree(L->D);
+		WorkspaceFree(L->params.work);
+	}
+	delete [] mg->levels;
+	delete mg;
+}
+
+int FASCycle(Multigrid * mg, unsigned int l)
+{
+	MGLevel * L = &mg->levels[l];
+	if (l == mg->nLevels-1)
+		return Relax(mg,l,mg->coarseIters,1.0);
+
+	MGLevel * C = &mg->levels[l+1];
+	if (Relax(mg,l,mg->preSmooth,mg->omega) || Residual(mg,l))
+		return 1;
+
+	// b_c = F_c(R x) - R(F(x) - b)
+	if (Prolong(L->x,L->grid,C->x,C->grid,mg->modelConst) || Restrict(L->r,L->grid,C->dx,C->grid))
+		return 1;
+	gsl_vector_memcpy(C->x0,C->x);
+	gsl_vector_set_zero(C->b);
+	if (Residual(mg,l+1))
+		return 1;
+	gsl_vector_memcpy(C->b,C->r);
+	gsl_vector_sub(C->b,C->dx);
+
+	for (int k = 0; k < mg->gamma; k++)
+	{
+		if (FASCycle(mg,l+1))
+			return 1;
+	}
+
+	// x += P(x_c) - P(R x)
+	if (Prolong(C->x,C->grid,L->p,L->grid,mg->modelConst) || Prolong(C->x0,C->grid,L->dx,L->grid,mg->modelConst))
+		return 1;
+	gsl_vector_add(L->x,L->p);
+	gsl_vector_sub(L->x,L->dx);
+	Limit(L->x);
+
+	return Relax(mg,l,mg->postSmooth,mg->omega);
+}
+
+int MultigridSolve(gsl_vector * xi, Multigrid * mg, int maxCycles)
+{
+	MGLevel * L = &mg->levels[0];
+	gsl_vector_memcpy(L->x,xi);
+	gsl_vector_set_zero(L->b);
+	if (Residual(mg,0))
+		return 1;
+	Log(logINFO) << "FAS cycle: 0\tMax Residual: " << gsl_vector_max(L->r) << "\tResidual norm: " << gsl_blas_dnrm2(L->r);
+	int status = GSL_CONTINUE;
+	int cycle = 0;
+	while (status == GSL_CONTINUE && cycle < maxCycles)
+	{
+		cycle++;
+		if (FASCycle(mg,0) || Residual(mg,0))
+		{
+			Log(logERROR) << "Error in FAS cycle " << cycle;
+			gsl_vector_memcpy(xi,L->x);
+			return 1;
+		}
+		Log(logINFO) << "FAS cycle: " << cycle << "\tMax Residual: " << gsl_vector_max(L->r)
+			<< "\tResidual norm: " << gsl_blas_dnrm2(L->r);
+		status = gsl_multiroot_test_residual(L->r,1e-7);
+	}
+	gsl_vector_memcpy(xi,L->x);
+	Log(logINFO) << "FAS: " << cycle << " " << ((mg->gamma == 2) ? "W" : "V") << " cycles on " << mg->nLevels << " levels";
+	return 0;
+}
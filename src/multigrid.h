@@ -0,0 +1,92 @@
+/**
+ * \file
+ *
+ * \brief Full Approximation Scheme (FAS) nonlinear multigrid for the steady system F(xi) = 0.
+ *
+ * Level 0 is the target grid and every coarser level has half the points, with the same
+ * mapping. Each level solves \f$F_l(x_l) = b_l\f$ with the residual of SysF (so the Set*Terms
+ * residuals are used on every level) and \f$b_0 = 0\f$. A cycle on level l
+ * - smooths with pre_smooth sweeps of \f$x \leftarrow x - \omega D^{-1}(F(x) - b)\f$. D is the Jacobian
+ *   shifted by \f$-1/\Delta t\f$, either all of it ("line", implicit along the one stretched grid
+ *   line) or only the 5x5 blocks coupling the unknowns at each grid point ("jacobi"),
+ * - restricts the solution with Prolong and the residual with Restrict, and sets
+ *   \f$b_{l+1} = F_{l+1}(Rx_l) - R(F_l(x_l) - b_l)\f$,
+ * - cycles on level l+1 once (V cycle) or twice (W cycle),
+ * - adds the prolonged coarse grid correction \f$P(x_{l+1}) - P(Rx_l)\f$ and post smooths.
+ *
+ * On the coarsest level a few Newton steps with the block tridiagonal Jacobian are taken instead.
+ * Point block Jacobi is not a smoother for the stretched grids of the nonuniform mapping (the
+ * cycle diverges at Re 2000), so "line" is the default.
+ */
+#ifndef MULTIGRID_H
+#define MULTIGRID_H
+#include<gsl/gsl_vector.h>
+#include"systemSolve.h"
+#include"jfnk.h"
+#include"setup.h"
+#include"Grid.h"
+using namespace std;
+
+/**
+ * \brief Unknowns, right hand side and work vectors on one grid.
+ */
+struct MGLevel {
+	Grid * grid; /**< grid of this level. */
+	FParams params; /**< residual parameters, with XiN = x so F has no time derivative, and the workspace of the level. */
+	gsl_vector * x; /**< current solution. */
+	gsl_vector * x0; /**< solution restricted from the finer level. */
+	gsl_vector * b; /**< FAS right hand side. */
+	gsl_vector * r; /**< \f$F(x) - b\f$. */
+	gsl_vector * dx; /**< work vector for the update. */
+	gsl_vector * p; /**< work vector for the correction from the coarser level. */
+	JFNKPrecond * D; /**< smoother matrix (block tridiagonal on the coarsest level). */
+};
+
+/**
+ * \brief FAS multigrid hierarchy and cycle parameters.
+ */
+struct Multigrid {
+	unsigned int nLevels; /**< number of levels. */
+	MGLevel * levels; /**< levels, 0 is the finest. */
+	int gamma; /**< cycles on the coarser level per cycle (1 = V, 2 = W). */
+	int preSmooth; /**< smoothing sweeps before the coarse grid correction. */
+	int postSmooth; /**< smoothing sweeps after the coarse grid correction. */
+	int coarseIters; /**< Newton steps on the coarsest level. */
+	double omega; /**< damping of the smoother. */
+	double deltaT; /**< pseudo time step added to the smoother and coarse Newton steps. */
+	constants * modelConst; /**< pointer to model constants. */
+};
+
+/**
+ * \brief Allocate the levels below grid.
+ * \param grid target grid (level 0), not owned by the hierarchy.
+ * \param modelConst pointer to model constants.
+ * \param solverOpts pointer to solver options (grid_levels and mg_*).
+ * \return pointer to new hierarchy.
+ */
+Multigrid * MultigridAlloc(Grid * grid, constants * modelConst, solverOptions * solverOpts);
+
+/**
+ * \brief Free a hierarchy and the grids it allocated.
+ * \param mg pointer to hierarchy.
+ */
+void MultigridFree(Multigrid * mg);
+
+/**
+ * \brief One FAS cycle on level l and below.
+ * \param mg pointer to hierarchy, with levels[l].x and levels[l].b set.
+ * \param l level.
+ * \return Error code (0 = success).
+ */
+int FASCycle(Multigrid * mg, unsigned int l);
+
+/**
+ * \brief Cycle until \f$\max|F(\xi)| < 10^{-7}\f$ on the target grid.
+ * \param xi initial guess on input, solution on output.
+ * \param mg pointer to hierarchy.
+ * \param maxCycles largest number of cycles.
+ * \return Error code (0 = success).
+ */
+int MultigridSolve(gsl_vector * xi, Multigrid * mg, int maxCycles);
+
+#endif
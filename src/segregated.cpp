@@ -0,0 +1,163 @@
+//--------------------------------------------------
+// segregated: Pseudo time steps that solve the U,
+// (k,ep) and (v2,f) equations in turn.
+//
+// 10/17/2026 - Written for cheap, loosely converged solves.
+// 10/17/2026 - Failed residual evaluations returned as GSL_EBADFUNC.
+// 10/17/2026 - Limit from computeTerms.h instead of a copy.
+//--------------------------------------------------
+#include<stdlib.h>
+#include<math.h>
+#include<gsl/gsl_errno.h>
+#include"segregated.h"
+#include"jacobian.h"
+#include"computeTerms.h"
+using namespace std;
+
+Segregated * SegregatedAlloc(unsigned int n, int maxAge)
+{
+	Segregated * S = new Segregated;
+	S->n = n;
+	S->J = BlockTridiagAlloc(n);
+	S->maxAge = maxAge;
+	S->age = -1;
+	S->deltaT = 0.0;
+	S->tri = TridiagAlloc(n);
+	S->dU = gsl_vector_alloc(n);
+	S->W = (double *)malloc(4*n*sizeof(double));
+	S->y = (double *)malloc(2*n*sizeof(double));
+	S->r = gsl_vector_alloc(BLOCK_SIZE*n);
+	S->stepCount = 0;
+	return S;
+}
+
+void SegregatedFree(Segregated * S)
+{
+	BlockTridiagFree(S->J);
+	TridiagFree(S->tri);
+	gsl_vector_free(S->dU);
+	free(S->W);
+	free(S->y);
+	gsl_vector_free(S->r);
+	delete S;
+}
+
+// Entry of the block at (row,offset) for equation m and unknown c.
+static double Entry(BlockTridiag * J, unsigned int row, int offset, int m, int c)
+{
+	return BlockTridiagBlock(J,row,offset)[BLOCK_SIZE*m+c];
+}
+
+// Newton step on the U equations, with U coupled to its neighbors only.
+static int SolveU(gsl_vector * x, Segregated * S)
+{
+	for (unsigned int i = 0; i < S->n; i++)
+	{
+		double lower = (i > 0) ? Entry(S->J,i,-1,0,0) : 0.0;
+		double upper = (i < S->n-1) ? Entry(S->J,i,1,0,0) : 0.0;
+		TridiagSetRow(S->tri,i,lower,Entry(S->J,i,0,0,0),upper,-gsl_vector_get(S->r,BLOCK_SIZE*i));
+	}
+	if (TridiagSolve(S->tri,S->dU))
+		return 1;
+	for (unsigned int i = 0; i < S->n; i++)
+		gsl_vector_set(x,BLOCK_SIZE*i,gsl_vector_get(x,BLOCK_SIZE*i)+gsl_vector_get(S->dU,i));
+	return 0;
+}
+
+// Newton step on the equations of the unknowns m0 and m0+1, with the 2x2 block Thomas algorithm.
+static int SolvePair(gsl_vector * x, Segregated * S, int m0)
+{
+	double * W = S->W;
+	double * y = S->y;
+	for (unsigned int i = 0; i < S->n; i++)
+	{
+		// D = A_i - L_i W_{i-1}, b = -F_i - L_i y_{i-1}
+		double D[4], b[2];
+		for (int a = 0; a < 2; a++)
+		{
+			b[a] = -gsl_vector_get(S->r,BLOCK_SIZE*i+m0+a);
+			for (int c = 0; c < 2; c++)
+				D[2*a+c] = Entry(S->J,i,0,m0+a,m0+c);
+			if (i > 0)
+			{
+				for (int k = 0; k < 2; k++)
+				{
+					double L = Entry(S->J,i,-1,m0+a,m0+k);
+					b[a] -= L*y[2*(i-1)+k];
+					for (int c = 0; c < 2; c++)
+						D[2*a+c] -= L*W[4*(i-1)+2*k+c];
+				}
+			}
+		}
+		double det = D[0]*D[3] - D[1]*D[2];
+		if (det == 0.0 || !isfinite(det))
+			return 1;
+		double inv[4] = {D[3]/det, -D[1]/det, -D[2]/det, D[0]/det};
+
+		// y_i = D^{-1} b, W_i = D^{-1} U_i
+		for (int a = 0; a < 2; a++)
+		{
+			y[2*i+a] = inv[2*a]*b[0] + inv[2*a+1]*b[1];
+			for (int c = 0; c < 2; c++)
+				W[4*i+2*a+c] = (i < S->n-1) ?
+					inv[2*a]*Entry(S->J,i,1,m0,m0+c) + inv[2*a+1]*Entry(S->J,i,1,m0+1,m0+c) : 0.0;
+		}
+	}
+	// Back substitution, x_i = y_i - W_i x_{i+1}, overwriting y.
+	for (unsigned int i = S->n-1; i-- > 0;)
+	{
+		for (int a = 0; a < 2; a++)
+			y[2*i+a] -= W[4*i+2*a]*y[2*(i+1)] + W[4*i+2*a+1]*y[2*(i+1)+1];
+	}
+	for (unsigned int i = 0; i < S->n; i++)
+	{
+		for (int a = 0; a < 2; a++)
+			gsl_vector_set(x,BLOCK_SIZE*i+m0+a,gsl_vector_get(x,BLOCK_SIZE*i+m0+a)+y[2*i+a]);
+	}
+	return 0;
+}
+
+int SegregatedStep(gsl_vector * x, FParams * params, Segregated * S, const gsl_vector * fx, gsl_vector * f)
+{
+	S->stepCount++;
+	if (S->age < 0 || S->age >= S->maxAge)
+	{
+		if (SysJ(x,params,S->J))
+			return GSL_EFAILED;
+		S->age = 0;
+		S->deltaT = params->deltaT;
+	}
+	else if (params->deltaT != S->deltaT)
+	{
+		// Every equation has -(x - XiN)/deltaT, so only the diagonal depends on deltaT.
+		for (unsigned int i = 0; i < S->n; i++)
+		{
+			double * D = BlockTridiagBlock(S->J,i,0);
+			for (int m = 0; m < BLOCK_SIZE; m++)
+				D[BLOCK_SIZE*m+m] += 1/S->deltaT - 1/params->deltaT;
+		}
+		S->deltaT = params->deltaT;
+	}
+	S->age++;
+	if (fx)
+		gsl_vector_memcpy(S->r,fx);
+	else if (SysF(x,params,S->r))
+		return GSL_EBADFUNC;
+
+	// The blocks stay frozen during the step, the residual is updated after each group.
+	if (SolveU(x,S))
+		return GSL_ESING;
+	if (SysF(x,params,S->r))
+		return GSL_EBADFUNC;
+	if (SolvePair(x,S,1))
+		return GSL_ESING;
+	Limit(x);
+	if (SysF(x,params,S->r))
+		return GSL_EBADFUNC;
+	if (SolvePair(x,S,3))
+		return GSL_ESING;
+	Limit(x);
+	if (SysF(x,params,f))
+		return GSL_EBADFUNC;
+	return GSL_SUCCESS;
+}
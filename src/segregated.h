@@ -0,0 +1,74 @@
+/**
+ * \file
+ *
+ * \brief Segregated pseudo time steps: U, then \f$(k,\epsilon)\f$, then \f$(\overline{v^2},f)\f$.
+ *
+ * Instead of solving the coupled 5N system, a segregated step solves the equations of one
+ * group of unknowns at a time, with the other groups frozen at their latest values:
+ * - the momentum equation for U, a scalar tridiagonal system (TridiagSolve),
+ * - the k and \f$\epsilon\f$ equations, block tridiagonal with 2x2 blocks,
+ * - the \f$\overline{v^2}\f$ and f equations, block tridiagonal with 2x2 blocks.
+ * Each group takes one Newton step on its own equations. The group's blocks are taken from the
+ * analytic Jacobian and the residual is reevaluated between groups, so later groups see the
+ * updated values (block Gauss-Seidel). The Jacobian is only formed every jac_max_age steps; in
+ * between, its \f$-1/\Delta t\f$ diagonal is shifted to the current \f$\Delta t\f$.
+ *
+ * Every step is a lot cheaper than a coupled Newton step, but it only converges linearly, so
+ * NewtonSolve switches to coupled steps once the residual is below segregated_switch.
+ *
+ * This is not a performance option. The frozen coupling limits \f$\Delta t\f$, so the segregated
+ * steps need far more iterations than they save per step: with the defaults, Re 180 takes 171
+ * steps and Re 5200 6703 steps (about 3 s), against 7 and 8 coupled Newton steps (about 20 ms),
+ * and smaller segregated_max_deltaT only adds steps. It is kept for comparison with the coupled steps.
+ */
+#ifndef SEGREGATED_H
+#define SEGREGATED_H
+#include<gsl/gsl_vector.h>
+#include"systemSolve.h"
+#include"blockTridiag.h"
+#include"tridiag.h"
+using namespace std;
+
+/**
+ * \brief Jacobian and work space of the segregated steps.
+ */
+struct Segregated {
+	unsigned int n; /**< number of grid points. */
+	BlockTridiag * J; /**< coupled Jacobian the group blocks are taken from. */
+	int maxAge; /**< steps between forming J. */
+	int age; /**< steps since J was formed, -1 before the first step. */
+	double deltaT; /**< \f$\Delta t\f$ of the time term in J. */
+	TridiagonalSystem * tri; /**< system of the U group. */
+	gsl_vector * dU; /**< update of U. */
+	double * W; /**< \f$D_r^{-1}C_r\f$ of the 2x2 block Thomas algorithm, 4 per grid point. */
+	double * y; /**< forward substituted right hand side of the 2x2 block solve, 2 per grid point. */
+	gsl_vector * r; /**< residual between the groups. */
+	int stepCount; /**< number of segregated steps taken. */
+};
+
+/**
+ * \brief Allocate segregated steps for n grid points.
+ * \param n number of grid points.
+ * \param maxAge steps between forming the Jacobian (1 = every step).
+ * \return pointer to new Segregated.
+ */
+Segregated * SegregatedAlloc(unsigned int n, int maxAge);
+
+/**
+ * \brief Free a Segregated.
+ * \param S pointer to Segregated.
+ */
+void SegregatedFree(Segregated * S);
+
+/**
+ * \brief One segregated step, solving the U, \f$(k,\epsilon)\f$ and \f$(\overline{v^2},f)\f$ groups in turn.
+ * \param x unknowns, updated in place.
+ * \param params parameters of the system (XiN and deltaT of the pseudo time step).
+ * \param S pointer to Segregated.
+ * \param fx F(x) on input, or NULL to evaluate it.
+ * \param f residual at the updated x.
+ * \return Error code (0 = success).
+ */
+int SegregatedStep(gsl_vector * x, FParams * params, Segregated * S, const gsl_vector * fx, gsl_vector * f);
+
+#endif
@@ -0,0 +1,153 @@
+//--------------------------------------------------
+// semismooth: Fischer-Burmeister Newton steps with 
+// the lower bounds on k, ep and v2. 
+//
+// 10/17/2026 - Written to replace clipping with a
+//              bound constrained solve.
+// 10/17/2026 - Optional mixed precision solve.
+// 10/17/2026 - Failed residual evaluations returned as GSL_EBADFUNC.
+// 10/17/2026 - Bounds from computeTerms.h.
+// 10/17/2026 - Factor in double when the refinement does not converge.
+// 10/17/2026 - Projection onto the bounds documented.
+//--------------------------------------------------
+#include<math.h>
+#include<gsl/gsl_errno.h>
+#include"semismooth.h"
+#include"jacobian.h"
+#include"computeTerms.h"
+using namespace std;
+
+Semismooth * SemismoothAlloc(unsigned int n, solverOptions * solverOpts)
+{
+	Semismooth * B = new Semismooth;
+	bool mixed = (solverOpts->precision == "mixed");
+	B->J = BlockTridiagAlloc(n);
+	B->LU = mixed ? BlockTridiagLUAllocSingle(n) : BlockTridiagLUAlloc(n);
+	B->dx = gsl_vector_alloc(BLOCK_SIZE*n);
+	B->res = gsl_vector_alloc(BLOCK_SIZE*n);
+	B->rhs = mixed ? gsl_vector_alloc(BLOCK_SIZE*n) : NULL;
+	B->r = mixed ? gsl_vector_alloc(BLOCK_SIZE*n) : NULL;
+	B->LUDouble = NULL;
+	B->refineCount = 0;
+	B->doubleCount = 0;
+	B->activeCount = 0;
+	B->stepCount = 0;
+	return B;
+}
+
+void SemismoothFree(Semismooth * B)
+{
+	BlockTridiagFree(B->J);
+	BlockTridiagLUFree(B->LU);
+	gsl_vector_free(B->dx);
+	gsl_vector_free(B->res);
+	if (B->rhs)
+		gsl_vector_free(B->rhs);
+	if (B->r)
+		gsl_vector_free(B->r);
+	if (B->LUDouble)
+		BlockTridiagLUFree(B->LUDouble);
+	delete B;
+}
+
+double SemismoothBound(unsigned int j)
+{
+	switch (j%BLOCK_SIZE)
+	{
+		case 1: return K_MIN;
+		case 2: return EP_MIN;
+		case 3: return V2_MIN;
+		default: return -INFINITY;
+	}
+}
+
+void SemismoothResidual(const gsl_vector * x, const gsl_vector * f, gsl_vector * res)
+{
+	for (unsigned int j = 0; j < x->size; j++)
+	{
+		double fj = gsl_vector_get(f,j);
+		if (gsl_vector_get(x,j) <= SemismoothBound(j))
+			fj = fmax(fj,0.0);
+		gsl_vector_set(res,j,fj);
+	}
+}
+
+int SemismoothStep(gsl_vector * x, FParams * params, Semismooth * B, const gsl_vector * fx, gsl_vector * f)
+{
+	B->stepCount++;
+	if (fx)
+		gsl_vector_memcpy(f,fx);
+	else if (SysF(x,params,f))
+		return GSL_EBADFUNC;
+	if (SysJ(x,params,B->J))
+		return GSL_EFAILED;
+
+	// Replace the rows of the bounded unknowns with the rows of Phi, and set dx = -Phi(x).
+	for (unsigned int j = 0; j < x->size; j++)
+	{
+		double fj = gsl_vector_get(f,j);
+		double l = SemismoothBound(j);
+		if (!isfinite(l))
+		{
+			gsl_vector_set(B->dx,j,-fj);
+			continue;
+		}
+		unsigned int row = j/BLOCK_SIZE;
+		unsigned int m = j%BLOCK_SIZE;
+		double * diag = BlockTridiagBlock(B->J,row,0);
+		double s = fabs(diag[BLOCK_SIZE*m+m]);
+		s = (s > 0.0) ? 1/s : 1.0;
+		double a = gsl_vector_get(x,j) - l;
+		double b = -s*fj;
+		double r = hypot(a,b);
+		double phiA = (r > 0.0) ? 1.0 - a/r : 1.0 - M_SQRT1_2;
+		double phiB = (r > 0.0) ? 1.0 - b/r : 1.0 - M_SQRT1_2;
+		for (int offset = -1; offset <= 1; offset++)
+		{
+			double * block = BlockTridiagBlock(B->J,row,offset);
+			for (unsigned int c = 0; c < BLOCK_SIZE; c++)
+				block[BLOCK_SIZE*m+c] *= -phiB*s;
+		}
+		diag[BLOCK_SIZE*m+m] += phiA;
+		gsl_vector_set(B->dx,j,-(a + b - r));
+	}
+	if (BlockTridiagFactor(B->J,B->LU))
+		return GSL_ESING;
+	if (B->LU->single)
+	{
+		gsl_vector_memcpy(B->rhs,B->dx);
+		int iters = BlockTridiagRefinedSolve(B->J,B->LU,B->rhs,B->dx,B->r,REFINE_TOL,REFINE_MAX_ITERS);
+		if (iters == REFINE_NOT_CONVERGED)
+		{
+			// The single precision factors are too far from J to refine, so J is factored in double.
+			if (!B->LUDouble)
+				B->LUDouble = BlockTridiagLUAlloc(B->J->n);
+			gsl_vector_memcpy(B->dx,B->rhs);
+			if (BlockTridiagFactor(B->J,B->LUDouble) || BlockTridiagLUSolve(B->LUDouble,B->dx,B->dx))
+				return GSL_ESING;
+			B->doubleCount++;
+		}
+		else if (iters < 0)
+			return GSL_ESING;
+		else
+			B->refineCount += iters;
+	}
+	else if (BlockTridiagLUSolve(B->LU,B->dx,B->dx))
+		return GSL_ESING;
+
+	// Take the step and project it onto the bounds, which puts the active values exactly on them.
+	B->activeCount = 0;
+	gsl_vector_add(x,B->dx);
+	for (unsigned int j = 0; j < x->size; j++)
+	{
+		double l = SemismoothBound(j);
+		if (gsl_vector_get(x,j) <= l)
+		{
+			gsl_vector_set(x,j,l);
+			B->activeCount++;
+		}
+	}
+	if (SysF(x,params,f))
+		return GSL_EBADFUNC;
+	return GSL_SUCCESS;
+}
@@ -0,0 +1,93 @@
+/**
+ * \file
+ *
+ * \brief Semismooth Newton steps with the lower bounds on \f$k\f$, \f$\epsilon\f$ and \f$\overline{v^2}\f$.
+ *
+ * Clipping k and \f$\overline{v^2}\f$ after each step makes the map from \f$\xi^n\f$ to
+ * \f$\xi^{n+1}\f$ non-smooth, and Newton stalls whenever a value near the wall is clipped. Here
+ * every bounded unknown \f$x_j \ge l_j\f$ (K_MIN, EP_MIN and V2_MIN) is instead paired with its
+ * residual as a complementarity condition,
+ * \f[ x_j - l_j \ge 0, \quad -F_j(x) \ge 0, \quad (x_j - l_j)F_j(x) = 0, \f]
+ * i.e. either \f$F_j = 0\f$ or the value sits on its bound while \f$F_j\f$ pushes it further down.
+ * With the Fischer-Burmeister function \f$\phi(a,b) = a + b - \sqrt{a^2 + b^2}\f$ this is
+ * \f$\Phi_j(x) = \phi(x_j - l_j, -s_jF_j(x)) = 0\f$, and the other equations stay \f$\Phi_j = F_j\f$.
+ * The scale \f$s_j = 1/|\partial F_j/\partial x_j|\f$ puts both arguments in the units of \f$x_j\f$,
+ * otherwise a large residual sends the value straight to its bound. One Newton step on
+ * \f$\Phi\f$ only scales rows of the block tridiagonal Jacobian and adds to its diagonal:
+ * \f[ \partial\Phi_j = \phi_a e_j^T - \phi_b s_j \partial F_j, \quad
+ *     \phi_a = 1 - a/r, \; \phi_b = 1 - b/r, \; r = \sqrt{a^2+b^2}, \f]
+ * with \f$\phi_a = \phi_b = 1 - 1/\sqrt{2}\f$ at \f$a = b = 0\f$. With precision = mixed the
+ * factorization is single precision and the solve is refined against the double precision J.
+ *
+ * This is a projected semismooth method: the bounds are still enforced by projecting each
+ * step onto them, \f$x_j \leftarrow \max(x_j, l_j)\f$. The projection is what puts a value
+ * exactly on its bound, where SemismoothResidual takes it as active; the Newton step alone
+ * only reaches the bound in the limit. The step is not globalized, the pseudo time term and
+ * the time step controller damp it instead.
+ */
+#ifndef SEMISMOOTH_H
+#define SEMISMOOTH_H
+#include<gsl/gsl_vector.h>
+#include"systemSolve.h"
+#include"blockTridiag.h"
+#include"setup.h"
+using namespace std;
+
+/**
+ * \brief Jacobian and work space of the semismooth Newton steps.
+ */
+struct Semismooth {
+	BlockTridiag * J; /**< Jacobian of \f$\Phi\f$. */
+	BlockTridiagLU * LU; /**< factorization of J. */
+	gsl_vector * dx; /**< Newton step. */
+	gsl_vector * res; /**< SemismoothResidual of the last F. */
+	gsl_vector * rhs; /**< right hand side of the refined solve (mixed precision only). */
+	gsl_vector * r; /**< residual of the refined solve (mixed precision only). */
+	BlockTridiagLU * LUDouble; /**< double precision factorization of J once a refined solve did not converge (NULL until then). */
+	int refineCount; /**< number of refinement steps in all solves. */
+	int doubleCount; /**< solves with LUDouble. */
+	int activeCount; /**< bounded values on their bound after the last step. */
+	int stepCount; /**< number of steps taken. */
+};
+
+/**
+ * \brief Allocate the semismooth Newton steps for n grid points.
+ * \param n number of grid points.
+ * \param solverOpts pointer to solver options (precision).
+ * \return pointer to new solver.
+ */
+Semismooth * SemismoothAlloc(unsigned int n, solverOptions * solverOpts);
+
+/**
+ * \brief Free the semismooth Newton steps.
+ * \param B pointer to solver.
+ */
+void SemismoothFree(Semismooth * B);
+
+/**
+ * \brief Lower bound of unknown j, or -INFINITY for U and f.
+ * \param j index into \f$\xi\f$.
+ * \return bound.
+ */
+double SemismoothBound(unsigned int j);
+
+/**
+ * \brief Residual of the bound constrained problem, \f$\max(F_j,0)\f$ for values on their bound 
+ * and \f$F_j\f$ otherwise. It is zero exactly at a solution, and has the units of F.
+ * \param x unknowns.
+ * \param f F(x).
+ * \param res residual, may be f.
+ */
+void SemismoothResidual(const gsl_vector * x, const gsl_vector * f, gsl_vector * res);
+
+/**
+ * \brief One semismooth Newton step on \f$\Phi(x) = 0\f$, projected onto the bounds.
+ * \param x current iterate on input, updated iterate on output.
+ * \param params parameters of the system.
+ * \param B pointer to solver.
+ * \param fx F(x), or NULL to have it evaluated.
+ * \param f F at the updated x.
+ * \return Error code (0 = success).
+ */
+int SemismoothStep(gsl_vector * x, FParams * params, Semismooth * B, const gsl_vector * fx, gsl_vector * f);
+#endif
@@ -2,22 +2,33 @@
 // setup: Initializes terms for v2-f code. 
 //
 // 12/3/2016 (gry88) - Written for CSE380 Final Project. 
+// 10/17/2026 - Log level and sink per thread, file and sweep options.
+// 10/17/2026 - anderson_depth rejected with solver = semismooth.
+// 10/17/2026 - anderson_depth rejected with solver = segregated.
+// 10/17/2026 - Thread count left to V2fSolverRun.
+// 10/17/2026 - SaveResults restores the format of the stream.
 //--------------------------------------------------
 #include<iomanip>
 #include "setup.h"
 #include "computeTerms.h"
-#include<gsl/gsl_linalg.h>
+#include "tridiag.h"
+#include "systemSolve.h"
+#include<omp.h>
 #include<fstream>
 #include<math.h>
 #include<boost/program_options.hpp>
 using namespace boost::program_options;
 using namespace std;
-loglevel_e loglevel = logINFO;
+thread_local loglevel_e loglevel = logINFO;
+thread_local ostream * logSink = &cerr;
 
-int Input_Parse(constants * modelConst,string & filename,string & outFile, bool &uniformGrid, int &max_ts, bool &restarting,int ac, char ** av)
+int Input_Parse(constants * modelConst,string & filename,string & outFile, bool &uniformGrid, int &max_ts, bool &restarting,solverOptions * solverOpts,int ac, char ** av, runOptions * runOpts)
 {
 	string config_file; 
 	int loglevelint;  
+	runOptions unused;
+	if (!runOpts)
+		runOpts = &unused;
 	try
 	{
 		options_description generic("Allowed Options");
@@ -44,6 +55,47 @@ int Input_Parse(constants * modelConst,string & filename,string & outFile, bool
 		("uniform-grid",value<bool>(&uniformGrid))
 		("max_ts",value<int>(&max_ts))
 		("restarting",value<bool>(&restarting))
+		("solver",value<string>(&(solverOpts->solver))->default_value("newton"))
+		("jfnk_precond",value<string>(&(solverOpts->precond))->default_value("blocktridiag"))
+		("gmres_restart",value<int>(&(solverOpts->gmresRestart))->default_value(30))
+		("gmres_maxiter",value<int>(&(solverOpts->gmresMaxIter))->default_value(300))
+		("gmres_tol",value<double>(&(solverOpts->gmresTol))->default_value(1e-6))
+		("jacobian",value<string>(&(solverOpts->jacobian))->default_value("analytic"))
+		("jac_max_age",value<int>(&(solverOpts->jacMaxAge))->default_value(20))
+		("jac_dt_change",value<double>(&(solverOpts->jacDtChange))->default_value(0.2))
+		("jac_ratio",value<double>(&(solverOpts->jacRatio))->default_value(0.5))
+		("broyden",value<bool>(&(solverOpts->broyden))->default_value(true))
+		("time_control",value<string>(&(solverOpts->timeControl))->default_value("ser"))
+		("deltaT0",value<double>(&(solverOpts->deltaT0))->default_value(1.0))
+		("max_deltaT",value<double>(&(solverOpts->maxDeltaT))->default_value(1000.0))
+		("steady_switch",value<double>(&(solverOpts->steadySwitch))->default_value(1e-2))
+		("pi_kp",value<double>(&(solverOpts->piKP))->default_value(0.075))
+		("pi_ki",value<double>(&(solverOpts->piKI))->default_value(0.175))
+		("pi_target",value<double>(&(solverOpts->piTarget))->default_value(0.01))
+		("grid_levels",value<int>(&(solverOpts->gridLevels))->default_value(1))
+		("mg_cycle",value<string>(&(solverOpts->mgCycle))->default_value("v"))
+		("mg_smoother",value<string>(&(solverOpts->mgSmoother))->default_value("line"))
+		("mg_pre_smooth",value<int>(&(solverOpts->mgPreSmooth))->default_value(2))
+		("mg_post_smooth",value<int>(&(solverOpts->mgPostSmooth))->default_value(2))
+		("mg_coarse_iters",value<int>(&(solverOpts->mgCoarseIters))->default_value(4))
+		("mg_omega",value<double>(&(solverOpts->mgOmega))->default_value(1.0))
+		("mg_deltaT",value<double>(&(solverOpts->mgDeltaT))->default_value(10.0))
+		("segregated_switch",value<double>(&(solverOpts->segregatedSwitch))->default_value(1e-4))
+		("segregated_max_deltaT",value<double>(&(solverOpts->segregatedMaxDeltaT))->default_value(2.0))
+		("precision",value<string>(&(solverOpts->precision))->default_value("double"))
+		("local_dt",value<bool>(&(solverOpts->localDt))->default_value(false))
+		("line_search",value<bool>(&(solverOpts->lineSearch))->default_value(false))
+		("ls_tau",value<double>(&(solverOpts->lsTau))->default_value(0.9))
+		("ls_max_backtracks",value<int>(&(solverOpts->lsMaxBacktracks))->default_value(8))
+		("anderson_depth",value<int>(&(solverOpts->andersonDepth))->default_value(0))
+		("anderson_restart",value<double>(&(solverOpts->andersonRestart))->default_value(2.0))
+		("threads",value<int>(&(solverOpts->threads))->default_value(0))
+		("init_filename",value<string>(&(runOpts->initFile))->default_value(""))
+		("snapshot_prefix",value<string>(&(runOpts->snapshotPrefix))->default_value(""))
+		("snapshot_every",value<int>(&(runOpts->snapshotEvery))->default_value(50))
+		("sweep_filename",value<string>(&(runOpts->sweepFile))->default_value(""))
+		("sweep_threads",value<int>(&(runOpts->sweepThreads))->default_value(0))
+		("sweep_output",value<string>(&(runOpts->sweepOutput))->default_value(""))
 		;
 		variables_map vm;
 		options_description config_file_options;
@@ -77,6 +129,102 @@ int Input_Parse(constants * modelConst,string & filename,string & outFile, bool
 	}
 
 	loglevel=(loglevel_e)loglevelint; //tpye case int as loglevel
+	if (solverOpts->solver != "newton" && solverOpts->solver != "dnewton" && solverOpts->solver != "jfnk" &&
+	    solverOpts->solver != "fas" && solverOpts->solver != "segregated" && solverOpts->solver != "semismooth")
+	{
+		Log(logERROR) << "Unknown solver: " << solverOpts->solver;
+		return 1;
+	}
+	if (solverOpts->precond != "none" && solverOpts->precond != "blockjacobi" && solverOpts->precond != "blocktridiag")
+	{
+		Log(logERROR) << "Unknown jfnk_precond: " << solverOpts->precond;
+		return 1;
+	}
+	if (solverOpts->jacobian != "analytic" && solverOpts->jacobian != "colored" && solverOpts->jacobian != "ad")
+	{
+		Log(logERROR) << "Unknown jacobian: " << solverOpts->jacobian;
+		return 1;
+	}
+	if (solverOpts->timeControl != "legacy" && solverOpts->timeControl != "ser" && solverOpts->timeControl != "pi")
+	{
+		Log(logERROR) << "Unknown time_control: " << solverOpts->timeControl;
+		return 1;
+	}
+	if (solverOpts->jacMaxAge < 1)
+	{
+		Log(logERROR) << "jac_max_age must be at least 1";
+		return 1;
+	}
+	if (solverOpts->gridLevels < 1)
+	{
+		Log(logERROR) << "grid_levels must be at least 1";
+		return 1;
+	}
+	if (solverOpts->lsTau <= 0.0 || solverOpts->lsTau >= 1.0)
+	{
+		Log(logERROR) << "ls_tau must be between 0 and 1";
+		return 1;
+	}
+	if (solverOpts->precision != "double" && solverOpts->precision != "mixed")
+	{
+		Log(logERROR) << "Unknown precision: " << solverOpts->precision;
+		return 1;
+	}
+	if (solverOpts->localDt && (solverOpts->solver == "segregated" || solverOpts->solver == "fas"))
+	{
+		Log(logERROR) << "local_dt needs solver = newton, dnewton, jfnk or semismooth";
+		return 1;
+	}
+	if (solverOpts->lineSearch && solverOpts->solver == "semismooth")
+	{
+		Log(logERROR) << "line_search is not used with solver = semismooth, which projects onto the bounds itself";
+		return 1;
+	}
+	if (solverOpts->andersonDepth < 0)
+	{
+		Log(logERROR) << "anderson_depth must not be negative";
+		return 1;
+	}
+	if (solverOpts->andersonDepth > 0 && solverOpts->timeControl == "legacy")
+	{
+		Log(logERROR) << "anderson_depth needs time_control = ser or pi";
+		return 1;
+	}
+	if (solverOpts->andersonDepth > 0 && solverOpts->solver == "semismooth")
+	{
+		Log(logERROR) << "anderson_depth is not used with solver = semismooth, whose mixed steps would not keep the bounds";
+		return 1;
+	}
+	if (solverOpts->andersonDepth > 0 && solverOpts->solver == "segregated")
+	{
+		Log(logERROR) << "anderson_depth is not used with solver = segregated, whose mixed steps do not converge";
+		return 1;
+	}
+	if (solverOpts->threads < 0)
+	{
+		Log(logERROR) << "threads must not be negative";
+		return 1;
+	}
+	if (runOpts->snapshotEvery < 1)
+	{
+		Log(logERROR) << "snapshot_every must be at least 1";
+		return 1;
+	}
+	if (runOpts->sweepThreads < 0)
+	{
+		Log(logERROR) << "sweep_threads must not be negative";
+		return 1;
+	}
+	if (solverOpts->mgCycle != "v" && solverOpts->mgCycle != "w")
+	{
+		Log(logERROR) << "Unknown mg_cycle: " << solverOpts->mgCycle;
+		return 1;
+	}
+	if (solverOpts->mgSmoother != "line" && solverOpts->mgSmoother != "jacobi")
+	{
+		Log(logERROR) << "Unknown mg_smoother: " << solverOpts->mgSmoother;
+		return 1;
+	}
 	Log(logINFO) << "----------------------------- ";
 	Log(logINFO) << "---> reyn = " << modelConst->reyn;
 	Log(logINFO) << "---> Cmu = " << modelConst->Cmu;
@@ -89,9 +237,64 @@ int Input_Parse(constants * modelConst,string & filename,string & outFile, bool
 	Log(logINFO) << "---> Ceta = " << modelConst->Ceta;
 	Log(logINFO) << "---> data_filename = " << filename;
 	Log(logINFO) << "---> output_filename = " << outFile;
+	if (!runOpts->sweepFile.empty())
+	{
+		Log(logINFO) << "---> sweep_filename = " << runOpts->sweepFile;
+		Log(logINFO) << "---> sweep_output = " << runOpts->sweepOutput;
+	}
         Log(logINFO) << "---> Uniform grid?  " << uniformGrid;
         Log(logINFO) << "---> max time step = " << max_ts;
         Log(logINFO) << "---> Restarting?  " << restarting;
+        Log(logINFO) << "---> solver = " << solverOpts->solver;
+        Log(logINFO) << "---> time_control = " << solverOpts->timeControl;
+        Log(logINFO) << "---> deltaT0 = " << solverOpts->deltaT0;
+        Log(logINFO) << "---> max_deltaT = " << solverOpts->maxDeltaT;
+        Log(logINFO) << "---> steady_switch = " << solverOpts->steadySwitch;
+        Log(logINFO) << "---> grid_levels = " << solverOpts->gridLevels;
+        Log(logINFO) << "---> precision = " << solverOpts->precision;
+        Log(logINFO) << "---> local_dt = " << solverOpts->localDt;
+        Log(logINFO) << "---> line_search = " << solverOpts->lineSearch;
+        if (solverOpts->lineSearch)
+        {
+                Log(logINFO) << "---> ls_tau = " << solverOpts->lsTau;
+                Log(logINFO) << "---> ls_max_backtracks = " << solverOpts->lsMaxBacktracks;
+        }
+        Log(logINFO) << "---> threads = " << (solverOpts->threads > 0 ? solverOpts->threads : omp_get_max_threads());
+        Log(logINFO) << "---> anderson_depth = " << solverOpts->andersonDepth;
+        if (solverOpts->andersonDepth > 0)
+        {
+                Log(logINFO) << "---> anderson_restart = " << solverOpts->andersonRestart;
+        }
+        if (solverOpts->solver == "jfnk")
+        {
+                Log(logINFO) << "---> jfnk_precond = " << solverOpts->precond;
+                Log(logINFO) << "---> gmres_restart = " << solverOpts->gmresRestart;
+                Log(logINFO) << "---> gmres_maxiter = " << solverOpts->gmresMaxIter;
+                Log(logINFO) << "---> gmres_tol = " << solverOpts->gmresTol;
+        }
+        if (solverOpts->solver == "segregated")
+        {
+                Log(logINFO) << "---> segregated_switch = " << solverOpts->segregatedSwitch;
+                Log(logINFO) << "---> segregated_max_deltaT = " << solverOpts->segregatedMaxDeltaT;
+        }
+        if (solverOpts->solver == "fas")
+        {
+                Log(logINFO) << "---> mg_cycle = " << solverOpts->mgCycle;
+                Log(logINFO) << "---> mg_smoother = " << solverOpts->mgSmoother;
+                Log(logINFO) << "---> mg_pre_smooth = " << solverOpts->mgPreSmooth;
+                Log(logINFO) << "---> mg_post_smooth = " << solverOpts->mgPostSmooth;
+                Log(logINFO) << "---> mg_coarse_iters = " << solverOpts->mgCoarseIters;
+                Log(logINFO) << "---> mg_omega = " << solverOpts->mgOmega;
+                Log(logINFO) << "---> mg_deltaT = " << solverOpts->mgDeltaT;
+        }
+        if (solverOpts->solver == "newton" || solverOpts->solver == "segregated")
+        {
+                Log(logINFO) << "---> jacobian = " << solverOpts->jacobian;
+                Log(logINFO) << "---> jac_max_age = " << solverOpts->jacMaxAge;
+                Log(logINFO) << "---> jac_dt_change = " << solverOpts->jacDtChange;
+                Log(logINFO) << "---> jac_ratio = " << solverOpts->jacRatio;
+                Log(logINFO) << "---> broyden = " << solverOpts->broyden;
+        }
 	Log(logINFO) << "----------------------------- ";
 	Log(logINFO) << "";
 	return 0;
@@ -209,9 +412,8 @@ int Solve4f0(gsl_vector * xi, constants * modelConst, Grid* grid)
 {
 	//Solve for f_0 based on data from others terms.
 	int size = xi->size/float(5) + 1;  // size for f. 
-	gsl_matrix * A = gsl_matrix_calloc(size,size);
-	gsl_vector * b = gsl_vector_calloc(A->size1); 
-	gsl_vector * f = gsl_vector_calloc(A->size1);
+	TridiagonalSystem * A = TridiagAlloc(size);
+	gsl_vector * f = gsl_vector_calloc(size);
 
 	double Lsquared; // L^2
 	double coef1, coef2, coef3;
@@ -221,7 +423,7 @@ int Solve4f0(gsl_vector * xi, constants * modelConst, Grid* grid)
 	double LHS1,LHS2; // LHS of f from finite difference. 
 	unsigned int i,xiCounter; 
 
-	gsl_vector * T = gsl_vector_calloc(A->size1);
+	gsl_vector * T = gsl_vector_calloc(size);
 	gsl_vector * vT = gsl_vector_calloc(T->size);
 	for (unsigned int i = 1; i<vT->size; i++)
 	{
@@ -246,14 +448,13 @@ int Solve4f0(gsl_vector * xi, constants * modelConst, Grid* grid)
    //    a1 = dChi/dY
    //    a2 = d^2Chi/dY^2
    //    m  = deltaChi
+   // Only the three diagonals are stored.
 
-	gsl_matrix_set(A,0,0,1); 
-	gsl_vector_set(b,0,Computef0(xi,modelConst,grid));
-
+	TridiagSetRow(A,0,0.0,1.0,0.0,Computef0(xi,modelConst,grid));
 
   	deltaChi = gsl_vector_get(grid->chi, 0);
 	deltaChi2 = pow(deltaChi,2);
-	for(i =1; i<A->size1-1;i++)
+	for(i =1; i<A->n-1;i++)
 	{
 		xiCounter = 5*(i-1);
 		Lsquared = pow(ComputeL(xi,modelConst,i),2);
@@ -263,9 +464,6 @@ int Solve4f0(gsl_vector * xi, constants * modelConst, Grid* grid)
 		coef2 = -2*Lsquared*pow(grid->dChidY(Chi),2)/deltaChi2 - 1.0;
                 coef3 = Lsquared*(pow(grid->dChidY(Chi),2)/deltaChi2
                       + grid->d2ChidY2(Chi)/(2*deltaChi));
-		gsl_matrix_set(A,i,i-1,coef1);
-		gsl_matrix_set(A,i,i,  coef2);
-		gsl_matrix_set(A,i,i+1,coef3);
 
 		LHS1 = (modelConst->C1/gsl_vector_get(T,i))*( (gsl_vector_get(xi,xiCounter+3)/gsl_vector_get(xi,xiCounter+1)) - 2.0/3.0); 
 		LHS2 = (modelConst->C2*ComputeP(xi,vT,grid,i))/gsl_vector_get(xi,xiCounter+1);
@@ -275,7 +473,7 @@ int Solve4f0(gsl_vector * xi, constants * modelConst, Grid* grid)
 			Log(logERROR) << "Error: non-finite b (" << LHS1-LHS2 << ")"; 
 			return 1; 
 		}
-		gsl_vector_set(b,i,LHS1-LHS2); 
+		TridiagSetRow(A,i,coef1,coef2,coef3,LHS1-LHS2);
 	}
 	
 	// set boundary term of matrix. 
@@ -285,8 +483,6 @@ int Solve4f0(gsl_vector * xi, constants * modelConst, Grid* grid)
 	Lsquared = pow(ComputeL(xi,modelConst,i),2);
 	coef1 = 2*Lsquared*pow(grid->dChidY(Chi),2)/deltaChi2;
 	coef2 = -2*Lsquared*pow(grid->dChidY(Chi),2)/deltaChi2 - 1.0;
-	gsl_matrix_set(A,i,i-1,coef1);
-	gsl_matrix_set(A,i,i,coef2);
 
 	LHS1 = (modelConst->C1/gsl_vector_get(T,i)*( (gsl_vector_get(xi,xiCounter+3)/gsl_vector_get(xi,xiCounter+1)) - 2.0/3.0)); 
 
@@ -296,14 +492,26 @@ int Solve4f0(gsl_vector * xi, constants * modelConst, Grid* grid)
 		return 1; 
 	}
 
-	gsl_vector_set(b,i,LHS1); 
+	TridiagSetRow(A,i,coef1,coef2,0.0,LHS1);
 
-	// LU solve Af = b for initial values f. 
-	Log(logDEBUG) << "Performing LU Solve for f_0";
-	int s; 
-	gsl_permutation * p = gsl_permutation_alloc(A->size1);
-	gsl_linalg_LU_decomp(A,p,&s); 
-	gsl_linalg_LU_solve(A,p,b,f);
+	// Tridiagonal solve Af = b for initial values f. 
+	// Very large grids use cyclic reduction to spread the solve over all threads. 
+	int status;
+	if (A->n >= CR_MIN_SIZE && AvailableThreads() > 1)
+	{
+		Log(logDEBUG) << "Performing cyclic reduction solve for f_0";
+		status = TridiagSolveCR(A,f);
+	}
+	else
+	{
+		Log(logDEBUG) << "Performing tridiagonal solve for f_0";
+		status = TridiagSolve(A,f);
+	}
+	if (status)
+	{
+		Log(logERROR) << "Error: could not solve for f_0";
+		return 1;
+	}
 
 	// add f to xi. 
 	Log(logDEBUG) << "Setting f_0 values";
@@ -316,8 +524,7 @@ int Solve4f0(gsl_vector * xi, constants * modelConst, Grid* grid)
 	}
 
 	// Cleanup
-	gsl_matrix_free(A);
-	gsl_vector_free(b);
+	TridiagFree(A);
 	gsl_vector_free(f);
 	gsl_vector_free(vT);
 	gsl_vector_free(T);
@@ -325,10 +532,26 @@ int Solve4f0(gsl_vector * xi, constants * modelConst, Grid* grid)
 	return 0; 
 }
 
-void SaveResults(gsl_vector * xi, string filename, Grid* grid,constants * modelConst)
+int SaveResults(gsl_vector * xi, string filename, Grid* grid,constants * modelConst)
 {
 	ofstream outFile; 
 	outFile.open(filename.c_str()); 
+	if (!outFile)
+	{
+		Log(logERROR) << "Cannot write " << filename;
+		return 1;
+	}
+	SaveResults(xi,outFile,grid,modelConst);
+	outFile.close();
+	return outFile.fail() ? 1 : 0;
+}
+
+void SaveResults(gsl_vector * xi, ostream & outFile, Grid* grid,constants * modelConst)
+{
+	// The caller's stream gets its format back at the end.
+	ios_base::fmtflags flags = outFile.flags();
+	streamsize precision = outFile.precision();
+
 	//output format: gridpoint U K EP V2 F 
 	outFile << std::fixed << setprecision(15) << 0.0 <<"\t"<<0.0<<"\t"<< 0.0 <<"\t"
 	    << ComputeEp0(xi,modelConst,grid) <<"\t" << 0.0 << "\t"
@@ -352,7 +575,6 @@ void SaveResults(gsl_vector * xi, string filename, Grid* grid,constants * modelC
 		//outFile << val << endl;
 		
 	}
-
-	outFile.close();
-
+	outFile.flags(flags);
+	outFile.precision(precision);
 }
@@ -31,6 +31,61 @@ struct constants {
 	double sigmaEp; /**< \f$\sigma_\epsilon\f$ */
 };
 
+/**
+ * \brief Holds the options for the nonlinear solve. 
+ */
+struct solverOptions {
+	string solver; /**< "newton" (analytic block tridiagonal Jacobian), "dnewton" (gsl finite difference Jacobian) "jfnk" (Jacobian-free Newton-Krylov), "fas" (FAS multigrid) or "segregated" (U, (k,ep) and (v2,f) solved in turn). */
+	string precond; /**< preconditioner for jfnk: "none", "blockjacobi" or "blocktridiag". */
+	int gmresRestart; /**< GMRES iterations before restarting. */
+	int gmresMaxIter; /**< maximum GMRES iterations per Newton step. */
+	double gmresTol; /**< relative tolerance of the GMRES solve. */
+	string jacobian; /**< newton: "analytic" (SysJ), "colored" (colored finite differences of SysF) or "ad" (dual numbers). */
+	int jacMaxAge; /**< newton and segregated: maximum number of steps between Jacobian refactorizations. */
+	double jacDtChange; /**< newton: refactor when deltaT changes by more than this fraction. */
+	double jacRatio; /**< newton: refactor when a step reduces the residual by less than this ratio. */
+	bool broyden; /**< newton: apply Broyden updates to the lagged Jacobian. */
+	string timeControl; /**< pseudo time step controller: "legacy", "ser" or "pi". */
+	double deltaT0; /**< first pseudo time step. */
+	double maxDeltaT; /**< largest finite pseudo time step. */
+	double steadySwitch; /**< take steady Newton steps while the steady residual norm is below this (0 = never). */
+	double piKP; /**< proportional gain of the pi controller. */
+	double piKI; /**< integral gain of the pi controller. */
+	double piTarget; /**< relative change per step the pi controller aims for. */
+	int gridLevels; /**< number of grids in the grid sequence or fas hierarchy (1 = target grid only). */
+	string mgCycle; /**< fas: "v" or "w" cycles. */
+	string mgSmoother; /**< fas: "line" (block tridiagonal) or "jacobi" (point block Jacobi) smoothing. */
+	int mgPreSmooth; /**< fas: smoothing sweeps before the coarse grid correction. */
+	int mgPostSmooth; /**< fas: smoothing sweeps after the coarse grid correction. */
+	int mgCoarseIters; /**< fas: Newton steps on the coarsest grid. */
+	double mgOmega; /**< fas: damping of the point block Jacobi smoother. */
+	double mgDeltaT; /**< fas: pseudo time step of the smoother and coarse Newton steps. */
+	double segregatedSwitch; /**< segregated: take coupled newton steps once the max residual is below this (0 = never). */
+	double segregatedMaxDeltaT; /**< segregated: largest pseudo time step of the segregated steps. */
+	string precision; /**< newton, semismooth: "double" or "mixed" (single precision factorization with iterative refinement). */
+	bool localDt; /**< scale deltaT by the local time scale of each unknown (ComputeLocalDt). */
+	bool lineSearch; /**< scale the steps with a positivity limiter and a backtracking line search. */
+	double lsTau; /**< line search: largest fraction of k, ep or v2 removed by one step. */
+	int lsMaxBacktracks; /**< line search: largest number of step halvings. */
+	int andersonDepth; /**< Anderson acceleration of the pseudo time steps: number of steps mixed (0 = off, not with legacy). */
+	double andersonRestart; /**< clear the Anderson history when the step size grows by more than this factor. */
+	int threads; /**< OpenMP threads of the residual and Jacobians (0 = OMP_NUM_THREADS or all cores). */
+};
+
+/**
+ * \brief Holds the options for the files written during a solve and for sweeps.
+ *
+ * An empty file name means the file is not written.
+ */
+struct runOptions {
+	string initFile; /**< initial conditions, before the solve. */
+	string snapshotPrefix; /**< profiles during the solve, written to snapshotPrefix<iteration>.dat. */
+	int snapshotEvery; /**< pseudo time steps between two snapshots. */
+	string sweepFile; /**< list of cases to run instead of the single case (see sweep.h). */
+	int sweepThreads; /**< cases run at the same time (0 = OMP_NUM_THREADS or all cores). */
+	string sweepOutput; /**< prefix of the profile and log of each case, sweepOutput<case>.dat and .log. */
+};
+
 /**
  * \brief Parse inputs. 
  *
@@ -41,12 +96,15 @@ struct constants {
  * \param uniformGrid If true, the grid will be uniform.
  * \param max_ts Defines maximum time steps taken before exiting..
  * \param restarting If true, the simulation is picking up where left off. Data file contains f.
+ * \param solverOpts pointer to struct containing solver options.
  * \param ac Arguement count passed to main. 
  * \param av Arguement vector passed to main. 
+ * \param runOpts pointer to struct containing the file and sweep options (NULL = not needed).
  * \return Error code (0 = success).
  */
 int Input_Parse(constants * modelConst,string &filename,string & outFile,
-                     bool &uniformGrid, int &max_ts, bool &restarting,int ac,char ** av);
+                     bool &uniformGrid, int &max_ts, bool &restarting,solverOptions * solverOpts,
+                     int ac,char ** av, runOptions * runOpts = NULL);
 
 /**
  * \brief Solve for initial conditions.  
@@ -99,8 +157,20 @@ int Solve4f0(gsl_vector * xi,constants * modelConst, Grid* grid);
  * \param filename name of output file.
  * \param grid - A point to the grid of points
  * \param modelConst pointer to struct of model constants. 
+ * \return Error code (0 = success, 1 if the file could not be written).
+ */
+int SaveResults(gsl_vector *xi,string filename, Grid* grid, constants * modelConst);
+
+/**
+ * \brief Writes result to a stream, in the format of the file. The format flags and precision
+ * of the stream are restored afterwards.
+ *
+ * \param xi pointer to gsl_vector of unknowns. 
+ * \param out stream to write to.
+ * \param grid - A point to the grid of points
+ * \param modelConst pointer to struct of model constants. 
  */
-void SaveResults(gsl_vector *xi,string filename, Grid* grid, constants * modelConst);
+void SaveResults(gsl_vector *xi,ostream & out, Grid* grid, constants * modelConst);
 
 #endif
 
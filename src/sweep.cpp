@@ -0,0 +1,355 @@
+//--------------------------------------------------
+// sweep: Runs many cases side by side in one process,
+// with work stealing between the threads.
+//
+// 10/17/2026 - Written for sweeps over Reynolds numbers and model constants.
+// 10/17/2026 - Sweeps run by worker processes into a shared result file.
+//--------------------------------------------------
+#include<fstream>
+#include<sstream>
+#include<vector>
+#include<math.h>
+#include<sched.h>
+#include<unistd.h>
+#include<sys/wait.h>
+#include<omp.h>
+#include"sweep.h"
+#include"sweepStore.h"
+using namespace std;
+
+// Cases head ... tail-1 of one thread's block. The owner takes from the head, others from the tail.
+struct SweepQueue {
+	unsigned int head;
+	unsigned int tail;
+	omp_lock_t lock;
+};
+
+SweepCase * SweepRead(string filename, const V2fConfig * base, unsigned int * n)
+{
+	ifstream in(filename.c_str());
+	if (!in)
+	{
+		Log(logERROR) << "Cannot open case file " << filename;
+		return NULL;
+	}
+	// Two passes, to count and then to read the cases.
+	string line;
+	unsigned int count = 0;
+	while (getline(in,line))
+	{
+		line = line.substr(0,line.find('#'));
+		if (line.find_first_not_of(" \t\r") != string::npos)
+			count++;
+	}
+	if (count == 0)
+	{
+		Log(logERROR) << "No cases in " << filename;
+		return NULL;
+	}
+	in.clear();
+	in.seekg(0);
+
+	SweepCase * cases = new SweepCase[count];
+	unsigned int j = 0, lineNumber = 0;
+	while (getline(in,line))
+	{
+		lineNumber++;
+		line = line.substr(0,line.find('#'));
+		if (line.find_first_not_of(" \t\r") == string::npos)
+			continue;
+		SweepCase * c = &cases[j++];
+		constants * m = &c->modelConst;
+		istringstream fields(line);
+		if (!(fields >> m->reyn >> m->Cmu >> m->C1 >> m->C2 >> m->Cep1 >> m->Cep2 >> m->Ceta >> m->CL >> m->sigmaEp)
+		    || !(m->reyn > 0))
+		{
+			Log(logERROR) << "Cannot read case on line " << lineNumber << " of " << filename;
+			delete[] cases;
+			return NULL;
+		}
+		if (!(fields >> c->dataFile))
+			c->dataFile = base->dataFile;
+		c->status = -1;
+		c->converged = false;
+		c->iterations = 0;
+		c->maxResidual = INFINITY;
+		c->seconds = 0.0;
+		c->thread = -1;
+		c->stolen = false;
+	}
+	*n = count;
+	return cases;
+}
+
+// Next case for thread t: the head of its own block, or the tail of the fullest other one.
+// Returns n when no case is left.
+static unsigned int SweepNext(SweepQueue * q, int threads, int t, unsigned int n, bool * stolen)
+{
+	unsigned int j = n;
+	omp_set_lock(&q[t].lock);
+	if (q[t].head < q[t].tail)
+		j = q[t].head++;
+	omp_unset_lock(&q[t].lock);
+	*stolen = false;
+	while (j == n)
+	{
+		int victim = -1;
+		unsigned int most = 0;
+		for (int v = 0; v < threads; v++)
+		{
+			omp_set_lock(&q[v].lock);
+			unsigned int left = q[v].tail - q[v].head;
+			omp_unset_lock(&q[v].lock);
+			if (left > most)
+			{
+				most = left;
+				victim = v;
+			}
+		}
+		if (victim < 0)
+			return n;
+		// The block may have emptied since it was looked at, then look again.
+		omp_set_lock(&q[victim].lock);
+		if (q[victim].head < q[victim].tail)
+			j = --q[victim].tail;
+		omp_unset_lock(&q[victim].lock);
+		*stolen = true;
+	}
+	return j;
+}
+
+// Runs case j, with its log kept apart until it is done and then written to sink without an output prefix.
+static void SweepCaseRun(const V2fConfig * base, SweepCase * c, unsigned int j, string output, ostream * sink)
+{
+	ostringstream log;
+	V2fConfig config = *base;
+	config.modelConst = c->modelConst;
+	config.dataFile = c->dataFile;
+	config.initFile = "";
+	config.snapshotPrefix = "";
+	config.outFile = "";
+	config.log = &log;
+	if (!output.empty())
+	{
+		ostringstream name;
+		name << output << j << ".dat";
+		config.outFile = name.str();
+	}
+
+	double start = omp_get_wtime();
+	V2fSolver * s = V2fSolverAlloc(&config);
+	c->status = V2fSolverRun(s);
+	c->converged = s->converged;
+	c->iterations = s->iterations;
+	c->maxResidual = s->maxResidual;
+	V2fSolverFree(s);
+	c->seconds = omp_get_wtime() - start;
+
+	if (!output.empty())
+	{
+		ostringstream name;
+		name << output << j << ".log";
+		ofstream file(name.str().c_str());
+		file << log.str();
+	}
+	else
+	{
+		#pragma omp critical(logIt)
+		*sink << log.str();
+	}
+}
+
+int SweepRun(const V2fConfig * base, SweepCase * cases, unsigned int n, int threads, string output)
+{
+	if (threads <= 0)
+		threads = omp_get_max_threads();
+	if ((unsigned int)threads > n)
+		threads = n;
+	Log(logINFO) << "Sweep: " << n << " cases on " << threads << " threads";
+
+	SweepQueue * q = new SweepQueue[threads];
+	for (int t = 0; t < threads; t++)
+	{
+		q[t].head = (unsigned int)((unsigned long)n*t/threads);
+		q[t].tail = (unsigned int)((unsigned long)n*(t+1)/threads);
+		omp_init_lock(&q[t].lock);
+	}
+
+	// Each case runs on one thread, so its own parallel regions must stay inactive.
+	int activeLevels = omp_get_max_active_levels();
+	omp_set_max_active_levels(1);
+	double start = omp_get_wtime();
+	ostream * sink = logSink;
+	#pragma omp parallel num_threads(threads)
+	{
+		int t = omp_get_thread_num();
+		bool stolen;
+		unsigned int j;
+		while ((j = SweepNext(q,threads,t,n,&stolen)) < n)
+		{
+			cases[j].thread = t;
+			cases[j].stolen = stolen;
+			SweepCaseRun(base,&cases[j],j,output,sink);
+		}
+	}
+	double seconds = omp_get_wtime() - start;
+	omp_set_max_active_levels(activeLevels);
+
+	for (int t = 0; t < threads; t++)
+		omp_destroy_lock(&q[t].lock);
+	delete[] q;
+
+	int status = 0, converged = 0, stolen = 0;
+	double caseSeconds = 0.0;
+	for (unsigned int j = 0; j < n; j++)
+	{
+		SweepCase * c = &cases[j];
+		Log(logINFO) << "Case " << j << ": reyn = " << c->modelConst.reyn << ", status " << c->status
+			<< (c->converged ? ", converged" : ", not converged") << ", " << c->iterations << " iterations, max residual "
+			<< c->maxResidual << ", " << c->seconds << " s on thread " << c->thread << (c->stolen ? " (stolen)" : "");
+		status |= (c->status != 0);
+		converged += c->converged;
+		stolen += c->stolen;
+		caseSeconds += c->seconds;
+	}
+	Log(logINFO) << "Sweep: " << converged << " of " << n << " cases converged, " << stolen << " stolen, "
+		<< seconds << " s (" << caseSeconds << " s of cases)";
+	return status;
+}
+
+// Worker process: pinned to cpu, runs claimed cases until none is left. Returns its exit code.
+static int SweepWorker(const V2fConfig * base, SweepCase * cases, SweepStore * store, int cpu)
+{
+	if (cpu >= 0)
+	{
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(cpu,&set);
+		sched_setaffinity(0,sizeof(set),&set);
+	}
+	// One core per worker, so the solves stay serial.
+	omp_set_num_threads(1);
+	int status = 0;
+	unsigned int j;
+	while (!SweepStoreClaim(store,&j))
+	{
+		ostringstream log;
+		V2fConfig config = *base;
+		config.modelConst = cases[j].modelConst;
+		config.dataFile = cases[j].dataFile;
+		config.initFile = "";
+		config.snapshotPrefix = "";
+		config.outFile = "";
+		config.solverOpts.threads = 1;
+		config.log = &log;
+
+		double start = omp_get_wtime();
+		V2fSolver * s = V2fSolverAlloc(&config);
+		V2fSolverRun(s);
+		double seconds = omp_get_wtime() - start;
+		if (SweepStoreWrite(store,j,s,seconds))
+		{
+			Log(logERROR) << "Cannot write the result of case " << j;
+			status = 1;
+		}
+		Log(logINFO) << "Case " << j << ": reyn = " << cases[j].modelConst.reyn << ", status " << s->status
+			<< (s->converged ? ", converged" : ", not converged") << ", " << s->iterations << " iterations, max residual "
+			<< s->maxResidual << ", " << seconds << " s in process " << getpid() << " on cpu " << cpu;
+		V2fSolverFree(s);
+		// The log of a case in one piece, so the logs of the workers do not interleave.
+		*logSink << log.str() << flush;
+		if (status)
+			break;
+	}
+	return status;
+}
+
+int SweepProcesses(const V2fConfig * base, string manifest, int workers)
+{
+	unsigned int n;
+	SweepCase * cases = SweepRead(manifest,base,&n);
+	if (!cases)
+		return 1;
+	string results = manifest + ".results";
+	SweepStore * store = SweepStoreOpen(results,cases,n,base->uniformGrid);
+	if (!store)
+	{
+		delete[] cases;
+		return 1;
+	}
+	unsigned int pending = SweepStoreCount(store,SWEEP_PENDING);
+	Log(logINFO) << "Sweep: " << n << " cases in " << results << ", " << n - pending << " already finished";
+
+	// Cores this process may run on, one worker on each.
+	vector<int> cpus;
+	cpu_set_t set;
+	if (!sched_getaffinity(0,sizeof(set),&set))
+		for (int c = 0; c < CPU_SETSIZE; c++)
+			if (CPU_ISSET(c,&set))
+				cpus.push_back(c);
+	if (workers <= 0)
+		workers = cpus.empty() ? 1 : cpus.size();
+	if ((unsigned int)workers > pending)
+		workers = pending;
+
+	int status = 0;
+	if (workers > 0)
+	{
+		Log(logINFO) << "Sweep: " << pending << " cases on " << workers << " worker processes";
+		cout << flush;
+		cerr << flush;
+		vector<pid_t> pids;
+		double start = omp_get_wtime();
+		for (int w = 0; w < workers; w++)
+		{
+			int cpu = cpus.empty() ? -1 : cpus[w % cpus.size()];
+			pid_t pid = fork();
+			if (pid == 0)
+			{
+				int workerStatus = SweepWorker(base,cases,store,cpu);
+				cout << flush;
+				cerr << flush;
+				_exit(workerStatus);
+			}
+			if (pid < 0)
+			{
+				Log(logERROR) << "Cannot start worker " << w;
+				status = 1;
+				break;
+			}
+			pids.push_back(pid);
+		}
+		for (unsigned int w = 0; w < pids.size(); w++)
+		{
+			int wstatus;
+			if (waitpid(pids[w],&wstatus,0) < 0)
+			{
+				Log(logERROR) << "Cannot wait for worker process " << pids[w];
+				status = 1;
+			}
+			else if (WIFSIGNALED(wstatus))
+			{
+				Log(logERROR) << "Worker process " << pids[w] << " killed by signal " << WTERMSIG(wstatus);
+				status = 1;
+			}
+			else if (WEXITSTATUS(wstatus))
+			{
+				Log(logERROR) << "Worker process " << pids[w] << " stopped with an error";
+				status = 1;
+			}
+		}
+		Log(logINFO) << "Sweep: workers done in " << omp_get_wtime() - start << " s";
+	}
+
+	// A case left running belongs to a worker that died; the next run of the manifest redoes it.
+	unsigned int done = SweepStoreCount(store,SWEEP_DONE), failed = SweepStoreCount(store,SWEEP_FAILED);
+	unsigned int converged = 0;
+	for (unsigned int j = 0; j < n; j++)
+		converged += (store->records[j].state == SWEEP_DONE && store->records[j].converged);
+	Log(logINFO) << "Sweep: " << done << " of " << n << " cases done (" << converged << " converged), " << failed
+		<< " failed, " << n - done - failed << " not finished";
+	status |= (done != n);
+	SweepStoreClose(store);
+	delete[] cases;
+	return status;
+}
@@ -0,0 +1,84 @@
+/**
+ * \file
+ *
+ * \brief Runs a list of cases, each a Reynolds number and a set of model constants, side by side.
+ *
+ * Each case is one V2fSolver, run on one thread of a single parallel region. The nested
+ * regions of the residual and Jacobians are inactive there, so each case runs on its own
+ * thread and gives the same result as when it is run alone. The cases are dealt out in
+ * order, a contiguous block per thread. A thread takes the cases of its own block from the
+ * front, and once it is empty it steals from the back of the fullest other block, so a few
+ * slow cases (high Reynolds numbers, or cases that need many steps) do not leave the other
+ * threads idle.
+ *
+ * The case file has one case per line, '#' starts a comment:
+ *
+ *     reyn Cmu C1 C2 Cep1 Cep2 Ceta CL sigmaEp [data_filename]
+ *
+ * Without a data file the case starts from the data file of the input file.
+ *
+ * `v2fun sweep manifest.txt` runs a case file in worker processes instead, one per core,
+ * each pinned to its core. The results go to one binary file, manifest.txt.results
+ * (sweepStore.h), which is also the queue of the workers and the record of which cases
+ * are finished, so a sweep that stopped resumes where it was when run again.
+ */
+#ifndef SWEEP_H
+#define SWEEP_H
+#include<string>
+#include"v2fSolver.h"
+using namespace std;
+
+/**
+ * \brief One case of a sweep and its result.
+ */
+struct SweepCase {
+	constants modelConst; /**< Reynolds number and model constants. */
+	string dataFile; /**< data file of the initial conditions. */
+	int status; /**< error code of V2fSolverRun (-1 = not run). */
+	bool converged; /**< see V2fSolver. */
+	int iterations; /**< see V2fSolver. */
+	double maxResidual; /**< see V2fSolver. */
+	double seconds; /**< wall time of the case. */
+	int thread; /**< thread that ran the case. */
+	bool stolen; /**< taken from the block of another thread. */
+};
+
+/**
+ * \brief Reads a case file.
+ * \param filename name of the case file.
+ * \param base configuration the data file defaults to.
+ * \param n set to the number of cases.
+ * \return array of n cases (free with delete[]), or NULL on error.
+ */
+SweepCase * SweepRead(string filename, const V2fConfig * base, unsigned int * n);
+
+/**
+ * \brief Runs the cases on threads, each with the configuration base and its own constants.
+ *
+ * The log of each case is kept apart and written as one block when the case ends, to
+ * output<case>.log, or the log of the calling thread without an output prefix. The profile
+ * of case j is written to output<j>.dat. No other files are written.
+ * \param base configuration of all cases.
+ * \param cases array of cases, updated with their results.
+ * \param n number of cases.
+ * \param threads cases run at the same time (0 = OMP_NUM_THREADS or all cores).
+ * \param output prefix of the files of each case (empty = none).
+ * \return Error code (0 = all cases ran, 1 if any returned an error).
+ */
+int SweepRun(const V2fConfig * base, SweepCase * cases, unsigned int n, int threads, string output);
+
+/**
+ * \brief Runs the cases of a case file in worker processes, into the result file manifest.results.
+ *
+ * Cases already done or failed in the result file are skipped. Each worker is pinned to one
+ * of the cores this process may run on and solves on one thread; its log goes to the log
+ * of the calling thread, a case at a time. No text files are written. The workers are
+ * forked and keep to one thread, so they never use the thread pool of this process.
+ * \param base configuration of all cases.
+ * \param manifest name of the case file.
+ * \param workers worker processes (0 = one per core), at most the cases left.
+ * \return Error code (0 = all cases done, 1 if any failed or is not finished).
+ */
+int SweepProcesses(const V2fConfig * base, string manifest, int workers);
+
+#endif
@@ -0,0 +1,243 @@
+//--------------------------------------------------
+// sweepStore: Result file of a sweep, mapped and shared by
+// the worker processes.
+//
+// 10/17/2026 - Written for sweeps run by worker processes (sweep.h).
+//--------------------------------------------------
+#include<string.h>
+#include<math.h>
+#include<fcntl.h>
+#include<unistd.h>
+#include<sys/file.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<algorithm>
+#include"computeTerms.h"
+#include"sweepStore.h"
+using namespace std;
+
+static const char sweepMagic[8] = {'V','2','F','S','W','E','E','P'};
+
+// Constants of a case in the order of SweepRecord::constants.
+static void SweepConstants(const constants * m, double * c)
+{
+	c[0] = m->reyn; c[1] = m->Cmu; c[2] = m->C1; c[3] = m->C2; c[4] = m->Cep1;
+	c[5] = m->Cep2; c[6] = m->Ceta; c[7] = m->CL; c[8] = m->sigmaEp;
+}
+
+// Syncs bytes first ... first+bytes-1 of the mapping to the file.
+static int SweepSync(SweepStore * store, const void * first, size_t bytes)
+{
+	size_t page = sysconf(_SC_PAGESIZE);
+	size_t start = ((const char *)first - store->base)/page*page;
+	size_t end = (const char *)first - store->base + bytes;
+	return msync(store->base + start, end - start, MS_SYNC);
+}
+
+SweepStore * SweepStoreOpen(string filename, SweepCase * cases, unsigned int n, bool uniformGrid)
+{
+	// Layout of the file for these cases, profiles after the header, records and order.
+	size_t doubles = (sizeof(SweepHeader) + n*sizeof(SweepRecord) + n*sizeof(uint32_t) + sizeof(double) - 1)/sizeof(double);
+	uint32_t * points = new uint32_t[n];
+	uint64_t * offset = new uint64_t[n];
+	for (unsigned int j = 0; j < n; j++)
+	{
+		Grid grid(uniformGrid, 1.0, 1.0/cases[j].modelConst.reyn);
+		points[j] = grid.getSize() + 1;
+		offset[j] = doubles;
+		doubles += (size_t)points[j]*SWEEP_COLUMNS;
+	}
+	size_t bytes = doubles*sizeof(double);
+
+	int fd = open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+	if (fd < 0)
+	{
+		Log(logERROR) << "Cannot open result file " << filename;
+		delete[] points;
+		delete[] offset;
+		return NULL;
+	}
+	// One sweep at a time per file; the lock goes with the descriptor to the workers.
+	struct stat st;
+	if (flock(fd, LOCK_EX | LOCK_NB) || fstat(fd, &st))
+	{
+		Log(logERROR) << "Result file " << filename << " is in use by another sweep";
+		close(fd);
+		delete[] points;
+		delete[] offset;
+		return NULL;
+	}
+	bool creating = (st.st_size == 0);
+	if (!creating && (size_t)st.st_size != bytes)
+	{
+		Log(logERROR) << "Result file " << filename << " is not for the cases of this manifest";
+		close(fd);
+		delete[] points;
+		delete[] offset;
+		return NULL;
+	}
+	if (creating && ftruncate(fd, bytes))
+	{
+		Log(logERROR) << "Cannot write result file " << filename;
+		close(fd);
+		delete[] points;
+		delete[] offset;
+		return NULL;
+	}
+	void * base = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (base == MAP_FAILED)
+	{
+		Log(logERROR) << "Cannot map result file " << filename;
+		close(fd);
+		delete[] points;
+		delete[] offset;
+		return NULL;
+	}
+
+	SweepStore * store = new SweepStore;
+	store->fd = fd;
+	store->bytes = bytes;
+	store->base = (char *)base;
+	store->header = (SweepHeader *)base;
+	store->records = (SweepRecord *)(store->header + 1);
+	store->order = (uint32_t *)(store->records + n);
+	SweepHeader * h = store->header;
+
+	int status = 0;
+	if (creating)
+	{
+		memcpy(h->magic, sweepMagic, sizeof(sweepMagic));
+		h->version = SWEEP_STORE_VERSION;
+		h->nCases = n;
+		h->bytes = bytes;
+		for (unsigned int j = 0; j < n; j++)
+		{
+			SweepRecord * r = &store->records[j];
+			memset(r, 0, sizeof(SweepRecord));
+			r->state = SWEEP_PENDING;
+			r->status = -1;
+			r->points = points[j];
+			r->worker = -1;
+			r->offset = offset[j];
+			SweepConstants(&cases[j].modelConst, r->constants);
+			r->maxResidual = INFINITY;
+			store->order[j] = j;
+		}
+		// Slowest cases first.
+		stable_sort(store->order, store->order + n, [cases](uint32_t a, uint32_t b) {
+			return cases[a].modelConst.reyn > cases[b].modelConst.reyn; });
+	}
+	else
+	{
+		if (memcmp(h->magic, sweepMagic, sizeof(sweepMagic)) || h->version != SWEEP_STORE_VERSION ||
+		    h->nCases != n || h->bytes != bytes)
+			status = 1;
+		for (unsigned int j = 0; j < n && !status; j++)
+		{
+			SweepRecord * r = &store->records[j];
+			double c[9];
+			SweepConstants(&cases[j].modelConst, c);
+			if (memcmp(c, r->constants, sizeof(c)) || r->points != points[j] || r->offset != offset[j] ||
+			    r->state < SWEEP_PENDING || r->state > SWEEP_FAILED)
+				status = 1;
+		}
+		if (status)
+		{
+			Log(logERROR) << "Result file " << filename << " is not for the cases of this manifest";
+		}
+		else
+		{
+			// Cases that were running when the last sweep stopped are run again.
+			for (unsigned int j = 0; j < n; j++)
+			{
+				if (store->records[j].state == SWEEP_RUNNING)
+					store->records[j].state = SWEEP_PENDING;
+			}
+		}
+	}
+	h->next = 0;
+	delete[] points;
+	delete[] offset;
+	if (status || SweepSync(store, store->base, (char *)(store->order + n) - store->base))
+	{
+		if (!status)
+		{
+			Log(logERROR) << "Cannot write result file " << filename;
+		}
+		SweepStoreClose(store);
+		return NULL;
+	}
+	return store;
+}
+
+void SweepStoreClose(SweepStore * store)
+{
+	munmap(store->base, store->bytes);
+	close(store->fd);
+	delete store;
+}
+
+int SweepStoreClaim(SweepStore * store, unsigned int * j)
+{
+	uint32_t n = store->header->nCases;
+	uint32_t position;
+	while ((position = __atomic_fetch_add(&store->header->next, 1, __ATOMIC_ACQ_REL)) < n)
+	{
+		uint32_t k = store->order[position];
+		int32_t pending = SWEEP_PENDING;
+		if (__atomic_compare_exchange_n(&store->records[k].state, &pending, (int32_t)SWEEP_RUNNING,
+		                                false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+		{
+			store->records[k].worker = getpid();
+			*j = k;
+			return 0;
+		}
+	}
+	return 1;
+}
+
+int SweepStoreWrite(SweepStore * store, unsigned int j, V2fSolver * s, double seconds)
+{
+	SweepRecord * r = &store->records[j];
+	double * p = SweepStoreProfile(store, j);
+	bool done = (s->status == 0);
+	if (done)
+	{
+		// The rows of SaveResults, the wall first.
+		constants * modelConst = &s->config.modelConst;
+		p[0] = 0.0; p[1] = 0.0; p[2] = 0.0; p[4] = 0.0;
+		p[3] = ComputeEp0(s->xi, modelConst, s->grid);
+		p[5] = Computef0(s->xi, modelConst, s->grid);
+		for (unsigned int i = 1; i < r->points; i++)
+		{
+			p[SWEEP_COLUMNS*i] = gsl_vector_get(s->grid->y, i-1);
+			for (unsigned int m = 1; m < SWEEP_COLUMNS; m++)
+				p[SWEEP_COLUMNS*i + m] = gsl_vector_get(s->xi, 5*(i-1) + m-1);
+		}
+	}
+	r->status = s->status;
+	r->converged = s->converged;
+	r->iterations = s->iterations;
+	r->maxResidual = s->maxResidual;
+	r->seconds = seconds;
+	r->worker = getpid();
+	if (done && SweepSync(store, p, (size_t)r->points*SWEEP_COLUMNS*sizeof(double)))
+		return 1;
+	if (SweepSync(store, r, sizeof(SweepRecord)))
+		return 1;
+	__atomic_store_n(&r->state, (int32_t)(done ? SWEEP_DONE : SWEEP_FAILED), __ATOMIC_RELEASE);
+	return SweepSync(store, r, sizeof(SweepRecord)) ? 1 : 0;
+}
+
+double * SweepStoreProfile(SweepStore * store, unsigned int j)
+{
+	return (double *)store->base + store->records[j].offset;
+}
+
+unsigned int SweepStoreCount(SweepStore * store, int state)
+{
+	unsigned int count = 0;
+	for (unsigned int j = 0; j < store->header->nCases; j++)
+		count += (__atomic_load_n(&store->records[j].state, __ATOMIC_ACQUIRE) == state);
+	return count;
+}
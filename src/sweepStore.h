@@ -0,0 +1,143 @@
+/**
+ * \file
+ *
+ * \brief Result file of a sweep run by worker processes, shared through mmap.
+ *
+ * `v2fun sweep manifest.txt` keeps all results of the cases of the manifest in one binary file,
+ * manifest.txt.results, which the worker processes map with MAP_SHARED. The file is also the
+ * queue of the sweep and its progress: a worker claims a pending case with an atomic update
+ * of the file, writes the converged profile into the space of the case, syncs it to disk and
+ * only then marks the case done. After a crash the file shows which cases are finished, and
+ * the next run of the same manifest skips them and redoes the cases that were running.
+ *
+ * Layout, in native byte order:
+ * - SweepHeader.
+ * - nCases SweepRecord, in the order of the manifest.
+ * - nCases uint32 case numbers, the order in which cases are handed out (highest Reynolds
+ *   number first, the slowest cases, so the sweep does not end waiting on one of them).
+ * - the profiles, SWEEP_COLUMNS doubles per row for points rows starting at the offset of the
+ *   case (in doubles from the start of the file): y, U, k, ep, v2, f as written by SaveResults,
+ *   the wall first.
+ */
+#ifndef SWEEPSTORE_H
+#define SWEEPSTORE_H
+#include<stdint.h>
+#include<string>
+#include"sweep.h"
+using namespace std;
+
+/** \brief Version of the layout, stored in the header. */
+#define SWEEP_STORE_VERSION 1
+
+/** \brief Columns of a profile row: y, U, k, ep, v2, f. */
+#define SWEEP_COLUMNS 6
+
+/**
+ * \brief State of a case in the result file.
+ */
+enum sweepState {
+	SWEEP_PENDING = 0, /**< not run yet, or running when a worker stopped. */
+	SWEEP_RUNNING = 1, /**< claimed by a worker. */
+	SWEEP_DONE = 2, /**< solved, with its profile. */
+	SWEEP_FAILED = 3 /**< the solve returned an error, no profile. */
+};
+
+/**
+ * \brief Start of the result file.
+ */
+struct SweepHeader {
+	char magic[8]; /**< "V2FSWEEP". */
+	uint32_t version; /**< SWEEP_STORE_VERSION. */
+	uint32_t nCases; /**< cases of the manifest. */
+	uint32_t next; /**< position of the next case in the order, shared by the workers. */
+	uint32_t reserved;
+	uint64_t bytes; /**< size of the file. */
+};
+
+/**
+ * \brief Case in the result file.
+ */
+struct SweepRecord {
+	int32_t state; /**< sweepState. */
+	int32_t status; /**< error code of V2fSolverRun. */
+	int32_t iterations; /**< see V2fSolver. */
+	int32_t converged; /**< see V2fSolver. */
+	uint32_t points; /**< rows of the profile, the grid points and the wall. */
+	int32_t worker; /**< process id of the worker that ran the case. */
+	uint64_t offset; /**< first double of the profile. */
+	double constants[9]; /**< reyn, Cmu, C1, C2, Cep1, Cep2, Ceta, CL, sigmaEp of the manifest. */
+	double maxResidual; /**< see V2fSolver. */
+	double seconds; /**< wall time of the case. */
+};
+
+/**
+ * \brief Mapped result file.
+ */
+struct SweepStore {
+	int fd; /**< file descriptor. */
+	size_t bytes; /**< size of the mapping. */
+	char * base; /**< start of the mapping. */
+	SweepHeader * header; /**< header. */
+	SweepRecord * records; /**< nCases records. */
+	uint32_t * order; /**< nCases case numbers. */
+};
+
+/**
+ * \brief Opens the result file of a manifest, or creates it.
+ *
+ * An existing file must have been made for the same cases (constants and grid sizes),
+ * otherwise it is left alone and NULL is returned. Cases that were running are set back
+ * to pending, and the queue starts again from the front. Open before forking the workers,
+ * which share the mapping.
+ * \param filename name of the result file.
+ * \param cases array of the cases of the manifest.
+ * \param n number of cases.
+ * \param uniformGrid use a uniform grid, as in V2fConfig.
+ * \return pointer to the store, or NULL on error.
+ */
+SweepStore * SweepStoreOpen(string filename, SweepCase * cases, unsigned int n, bool uniformGrid);
+
+/**
+ * \brief Unmaps and closes the result file.
+ * \param store pointer to the store.
+ */
+void SweepStoreClose(SweepStore * store);
+
+/**
+ * \brief Claims the next pending case of the queue; any process sharing the mapping may call it.
+ * \param store pointer to the store.
+ * \param j set to the case number.
+ * \return 0 if a case was claimed, 1 if none is left.
+ */
+int SweepStoreClaim(SweepStore * store, unsigned int * j);
+
+/**
+ * \brief Writes the result of a claimed case, and then marks it done or failed.
+ *
+ * The profile and the record are synced to disk before the state changes, so a case
+ * marked done always has its profile in the file.
+ * \param store pointer to the store.
+ * \param j case number.
+ * \param s pointer to the solver that ran the case.
+ * \param seconds wall time of the case.
+ * \return Error code (0 = success).
+ */
+int SweepStoreWrite(SweepStore * store, unsigned int j, V2fSolver * s, double seconds);
+
+/**
+ * \brief Profile of a case, points rows of SWEEP_COLUMNS doubles.
+ * \param store pointer to the store.
+ * \param j case number.
+ * \return pointer into the mapping.
+ */
+double * SweepStoreProfile(SweepStore * store, unsigned int j);
+
+/**
+ * \brief Number of cases in a state.
+ * \param store pointer to the store.
+ * \param state sweepState.
+ * \return number of cases.
+ */
+unsigned int SweepStoreCount(SweepStore * store, int state);
+
+#endif
@@ -2,6 +2,13 @@
 // systemSolve: Sets up system to be solved for gsl_multiroot solver. 
 //
 // 12/3/2016 - (gry88) Written for CSE380 final project. 
+// 10/17/2026 - Residual templated on the vector type for dual numbers.
+// 10/17/2026 - Time terms use TimeStep for local pseudo time steps.
+// 10/17/2026 - Fused single pass residual; the per-equation path is kept as SysResidualByTerm.
+// 10/17/2026 - Residual on the field arrays with ghost cells.
+// 10/17/2026 - Scratch from the workspace in FParams.
+// 10/17/2026 - One parallel region per residual, with the thread count set at run time.
+// 10/17/2026 - Non-finite terms are returned as a status instead of exiting.
 //--------------------------------------------------
 #include<math.h>
 #include<gsl/gsl_multiroots.h>
@@ -9,293 +16,439 @@
 #include"computeTerms.h"
 #include"systemSolve.h"
 #include"finiteDiff.h"
+#include"fields.h"
+#include"workspace.h"
 using namespace std; 
 
-#define THREADS 1
-
 // The structure of this function is fixed by the definition of gsl_multiroot solvers. 
 int SysF(const gsl_vector * xi, void * p, gsl_vector * sysF)
 {
 	Log(logDEBUG2) << "Setting up system F(xi)";
 	struct FParams * params = (struct FParams *)p; //reference void pointer to parameter struct; 
 
+	//first paramter must be const. SysResidual only reads xi, so it is passed without a copy.
+	//a nonzero status makes the gsl solvers stop with GSL_EBADFUNC.
+	return SysResidual(const_cast<gsl_vector *>(xi),params,sysF);
+}
+
+// Residual of all five equations at point i of the fields, with the stencil tables of the grid.
+// Returns 1 if the production is not finite, which then carries through to val.
+template<class S>
+static int PointResidual(Fields<S> * F, FParams * params, unsigned int i, S * val)
+{
+	constants * mc = params->modelConst;
+	Grid * grid = params->grid;
+	double nu = 1/mc->reyn;
+	unsigned int xiCounter = 5*(i-1); 
+	double c1m = grid->deriv1Lower[i-1], c1p = grid->deriv1Upper[i-1];
+	double c2m = grid->deriv2Lower[i-1], c2c = grid->deriv2Center[i-1], c2p = grid->deriv2Upper[i-1];
+
+	S d1x[FIELDS_VARS],d2x[FIELDS_VARS],dt[FIELDS_VARS];
+	for (int m = 0; m<FIELDS_VARS; m++)
+	{
+		S * x = FieldsVar(F,m);
+		d1x[m] = c1m*x[i-1] + c1p*x[i+1];
+		d2x[m] = c2m*x[i-1] + c2c*x[i] + c2p*x[i+1];
+		dt[m] = -(x[i]-gsl_vector_get(params->XiN,xiCounter+m))/TimeStep(params,xiCounter+m);
+	}
+
+	S k = F->k[i], ep = F->ep[i], v2 = F->v2[i], f = F->f[i];
+	S vT = F->vT[i], T = F->T[i];
+	S dvT = c1m*F->vT[i-1] + c1p*F->vT[i+1];
+	S P = vT*pow(d1x[0],2);
+	int status = 0;
+	if (!isfinite(P))
+	{
+		Log(logERROR) << "Error: P non-finite (" << P << ")";
+		status = 1;
+	}
+	S v2k = v2/k;
+
+	// Same terms, in the same order, as SetUTerms ... SetFTerms.
+	val[0] = dt[0] + (nu + vT)*d2x[0] + d1x[0]*dvT + 1;
+	val[1] = dt[1] + (P - ep) + (nu + vT/1.3)*d2x[1] + d1x[1]*dvT;
+	val[2] = dt[2] + (mc->Cep1*P - mc->Cep2*ep)/T + (nu + vT/mc->sigmaEp)*d2x[2]
+		+ (1/mc->sigmaEp)*d1x[2]*dvT;
+	val[3] = dt[3] + (k*f - ep*v2k) + (nu + vT)*d2x[3] + d1x[3]*dvT;
+	val[4] = dt[4] + pow(F->L[i],2)*d2x[4] + (mc->C2*(P/k) - f) + (-(mc->C1/T)*(v2k-float(2)/3));
+	return status;
+}
+
+// Points first ... last-1 of this thread in the residual of a grid with size points, split
+// in whole cache lines of the field arrays.
+static void ThreadPoints(unsigned int size, unsigned int * first, unsigned int * last)
+{
+	unsigned int perLine = FIELDS_ALIGN/sizeof(double);
+	unsigned int threads = omp_get_num_threads();
+	unsigned int chunk = ((size-1 + threads-1)/threads + perLine-1)/perLine*perLine;
+	*first = 1 + omp_get_thread_num()*chunk;
+	*last = *first + chunk;
+	if (*first > size)
+		*first = size;
+	if (*last > size)
+		*last = size;
+}
+
+template<class V>
+int SysResidual(V * xi, FParams * params, V * sysF)
+{
+	Log(logDEBUG2) << "Setting up fused system";
+	typedef VecScalar<V> S;
+	unsigned int i; 
+	unsigned int size = xi->size/5+1; //size of single vectors, I in doc. 
+	constants * mc = params->modelConst;
+	Grid * grid = params->grid;
+
+	// The residual works on the field arrays, with the boundary conditions in the ghost cells
+	// and the stencil tables. At the centerline the first derivatives vanish by symmetry.
+	Fields<S> * F, * R;
+	int allocated = WorkspaceFields(params->work,size,&F,&R);
+	S ep0 = ComputeEp0(xi,mc,grid), f0 = Computef0(xi,mc,grid);
+	int status = !isfinite(ep0) || !isfinite(f0);
+
+	// Each thread gathers, computes and scatters its own points. Only the stencils reach into
+	// the points of the neighbouring threads, after the barrier.
+	#pragma omp parallel num_threads(GridThreads(size)) private(i) reduction(|:status)
+	{
+	unsigned int first, last;
+	ThreadPoints(size,&first,&last);
+	FieldsGather(xi,F,first,last);
+	status |= ComputeFieldTerms(F,mc,first,last);
+	#pragma omp barrier
+	#pragma omp single
+	FieldsSetGhosts(F,ep0,f0);
+
+	for (i = first; i<last; i++)
+	{
+		S val[FIELDS_VARS];
+		status |= PointResidual(F,params,i,val);
+		for (int m = 0; m<FIELDS_VARS; m++)
+			FieldsVar(R,m)[i] = val[m];
+	}
+	FieldsScatter(R,sysF,first,last);
+	}
+
+	for (int m = 0; m<FIELDS_VARS; m++)
+	{
+		if (!isfinite(FieldsVar(R,m)[size-1]))
+		{
+			Log(logERROR) << "Error setting terms in system at the centerline";
+			status = 1;
+			break;
+		}
+	}
+
+	// Cleanup
+	if (allocated)
+	{
+		FieldsFree(F);
+		FieldsFree(R);
+	}
+
+	return status; 
+}
+
+template<class V>
+int SysResidualByTerm(V * xi, FParams * params, V * sysF)
+{
 	int vecSize = ((xi->size))/double(5)+1;  // size of single vector. I in doc. 
-	
-	//first paramter must be const. But since we need do access vector, we have to define
-	//a temporary vector so work with. Perhaps there is a way around this. 
-	gsl_vector * tempxi = gsl_vector_alloc(xi->size);  
-	gsl_vector_memcpy(tempxi,xi);
 
 	// Enough functions need eddy viscosity so we store results, same as T.
 	// Note each of the Term vectors are full size (starting at i=0)
-	gsl_vector * vT = gsl_vector_calloc(vecSize);
-	gsl_vector * T  = gsl_vector_calloc(vecSize);
+	V * vT = VecTraits<V>::Calloc(vecSize);
+	V * T  = VecTraits<V>::Calloc(vecSize);
+
+	// One parallel region for the whole evaluation. The setters share out their loops in it,
+	// and each unknown of sysF is written by one thread. The boundary of each setter is done by
+	// a single thread, so its status is combined over the threads.
+	int status = 0;
+	#pragma omp parallel num_threads(GridThreads(vecSize)) reduction(|:status)
+	{
+	#pragma omp for
 	for (unsigned int i = 1; i<vT->size;i++)
 	{
-		gsl_vector_set(T,i,ComputeT(tempxi,params->modelConst,i));
+		VecSet(T,i,ComputeT(xi,params->modelConst,i));
                 // Set to 0 for laminar case
-		gsl_vector_set(vT,i,ComputeEddyVisc(tempxi,T,params->modelConst,i));
+		VecSet(vT,i,ComputeEddyVisc(xi,T,params->modelConst,i));
+		if (!isfinite(VecGet(vT,i)))
+			status = 1;
 	}
 
 	//Set each term based on functions below. 
-	if(SetUTerms(tempxi,vT,params,sysF))
+	if(SetUTerms(xi,vT,params,sysF))
 	{
 		Log(logERROR) << "Error setting U terms in system";
-		exit(1);
+		status = 1;
 	}
 
-	//cout << omp_get_thread_num() << " MADE IT" << endl;
-
-	if(SetKTerms(tempxi,vT,params,sysF))
+	if(SetKTerms(xi,vT,params,sysF))
 	{
 		Log(logERROR) << "Error setting k terms in system";
-		exit(1); 
+		status = 1; 
 	}
 
-	if(SetEpTerms(tempxi,vT,T,params,sysF))
+	if(SetEpTerms(xi,vT,T,params,sysF))
 	{
 		Log(logERROR) << "Error setting ep terms in system";
-		exit(1); 
+		status = 1; 
 	}
 
-	if(SetV2Terms(tempxi,vT,params,sysF))
+	if(SetV2Terms(xi,vT,params,sysF))
 	{
 		Log(logERROR) << "Error setting v2 terms in system";
-		exit(1); 
+		status = 1; 
 	}
 
-	if(SetFTerms(tempxi,vT,T,params,sysF))
+	if(SetFTerms(xi,vT,T,params,sysF))
 	{
 		Log(logERROR) << "Error setting F terms in system";
-		exit(1); 
+		status = 1; 
+	}
 	}
 
-//	for(unsigned int i = 0; i<sysF->size;i++)
-//	{
-//		cout << gsl_vector_get(sysF,i) << endl; 
-//	}
-	
 	// Cleanup
-	gsl_vector_free(vT);
-	gsl_vector_free(T);
-	gsl_vector_free(tempxi);
+	VecTraits<V>::Free(vT);
+	VecTraits<V>::Free(T);
 
-	return 0; 
+	return status; 
 }
 
-int SetFTerms(gsl_vector * xi, gsl_vector * vT, gsl_vector * T, FParams * params, gsl_vector * sysF)
+template<class V>
+int SetFTerms(V * xi, V * vT, V * T, FParams * params, V * sysF)
 {
 	Log(logDEBUG2) << "Setting f terms\n";
 	unsigned int i; 
 	unsigned int size = xi->size/float(5) + 1; //size of single vectors. Comes from old structure of code before restructure branch in git.  
-	double xiCounter; 
-	double f0 = Computef0(xi,params->modelConst,params->grid);
+	unsigned int xiCounter; 
+	VecScalar<V> f0 = Computef0(xi,params->modelConst,params->grid);
 
-	#pragma omp parallel num_threads(THREADS)
-	{
 	#pragma omp for private(xiCounter)
 	for(i = 1; i<size-1; i++)
 	{
-		double firstTerm,secondTerm,thirdTerm,fourthTerm,val; 
+		VecScalar<V> firstTerm,secondTerm,thirdTerm,fourthTerm,val; 
 		xiCounter=5*(i-1); 
-		firstTerm = -(gsl_vector_get(xi,xiCounter+4)-gsl_vector_get(params->XiN,xiCounter+4))/params->deltaT;	
+		firstTerm = -(VecGet(xi,xiCounter+4)-gsl_vector_get(params->XiN,xiCounter+4))/TimeStep(params,xiCounter+4);	
 		secondTerm = pow(ComputeL(xi,params->modelConst,i),2)*Deriv2(xi,f0,xiCounter+4, params->grid);
-		thirdTerm = params->modelConst->C2*(ComputeP(xi,vT,params->grid,i)/gsl_vector_get(xi,xiCounter+1)) - gsl_vector_get(xi,xiCounter+4);
-		fourthTerm = -(params->modelConst->C1/gsl_vector_get(T,i))*( (gsl_vector_get(xi,xiCounter+3)/gsl_vector_get(xi,xiCounter+1))-float(2)/3); 
+		thirdTerm = params->modelConst->C2*(ComputeP(xi,vT,params->grid,i)/VecGet(xi,xiCounter+1)) - VecGet(xi,xiCounter+4);
+		fourthTerm = -(params->modelConst->C1/VecGet(T,i))*( (VecGet(xi,xiCounter+3)/VecGet(xi,xiCounter+1))-float(2)/3); 
 		val = firstTerm + secondTerm + thirdTerm + fourthTerm;
 		//if (!isfinite(val))
 		//	return 1; 
-		gsl_vector_set(sysF,xiCounter+4,val); 
+		VecSet(sysF,xiCounter+4,val); 
 		Log(logDEBUG3) << "f term = " << val<< " at " << i;
 	}
-	}
 
-	double firstTerm,secondTerm,thirdTerm,val; 
+	int status = 0;
+	#pragma omp single
+	{
+	VecScalar<V> firstTerm,secondTerm,thirdTerm,val; 
 	//boundary terms. 
 	i=size-1;  
 	xiCounter=5*(i-1); 
-	firstTerm = -(gsl_vector_get(xi,xiCounter+4)-gsl_vector_get(params->XiN,xiCounter+4))/params->deltaT;	
+	firstTerm = -(VecGet(xi,xiCounter+4)-gsl_vector_get(params->XiN,xiCounter+4))/TimeStep(params,xiCounter+4);	
 	secondTerm = pow(ComputeL(xi,params->modelConst,i),2)*BdryDeriv2(xi,xiCounter+4,params->grid);
-	thirdTerm = -gsl_vector_get(xi,xiCounter+4) -(params->modelConst->C1/gsl_vector_get(T,i))*( (gsl_vector_get(xi,xiCounter+3)/gsl_vector_get(xi,xiCounter+1))-float(2)/3); 
+	thirdTerm = -VecGet(xi,xiCounter+4) -(params->modelConst->C1/VecGet(T,i))*( (VecGet(xi,xiCounter+3)/VecGet(xi,xiCounter+1))-float(2)/3); 
 	val = firstTerm+secondTerm+thirdTerm;
 	Log(logDEBUG3) << "f term = " << val << " at " << i;
 	if(!isfinite(val))
-		return 1; 
-	gsl_vector_set(sysF,xiCounter+4,val);
-	return 0; 
+		status = 1; 
+	else
+		VecSet(sysF,xiCounter+4,val);
+	}
+	return status; 
 } 
-int SetV2Terms(gsl_vector * xi,gsl_vector * vT,FParams * params, gsl_vector * sysF)
+template<class V>
+int SetV2Terms(V * xi,V * vT,FParams * params, V * sysF)
 {
 	
 	Log(logDEBUG2) << "Setting V2 terms";
 	unsigned int i; 
 	unsigned int size = xi->size/float(5)+1; 
-	double xiCounter; //counter for xi vector. 
+	unsigned int xiCounter; //counter for xi vector. 
 
 	// i loops of size of U,k,ep,v2,f. 
-	#pragma omp parallel num_threads(THREADS) 
-	{
 	#pragma omp for private(xiCounter)
 	for(i = 1; i<size-1; i++)
 	{
-		double firstTerm,secondTerm,thirdTerm,fourthTerm,val; 
+		VecScalar<V> firstTerm,secondTerm,thirdTerm,fourthTerm,val; 
 		xiCounter=5*(i-1); //xiCounter is the counter for xi. 
-		firstTerm = -(gsl_vector_get(xi,xiCounter+3)-gsl_vector_get(params->XiN,xiCounter+3))/params->deltaT;	
-		secondTerm = gsl_vector_get(xi,xiCounter+1)*gsl_vector_get(xi,xiCounter+4) - gsl_vector_get(xi,xiCounter+2)*( ( gsl_vector_get(xi,xiCounter+3)/gsl_vector_get(xi,xiCounter+1)));
-		thirdTerm = (1/params->modelConst->reyn + gsl_vector_get(vT,i))*Deriv2(xi,0,xiCounter+3,params->grid);
+		firstTerm = -(VecGet(xi,xiCounter+3)-gsl_vector_get(params->XiN,xiCounter+3))/TimeStep(params,xiCounter+3);	
+		secondTerm = VecGet(xi,xiCounter+1)*VecGet(xi,xiCounter+4) - VecGet(xi,xiCounter+2)*( ( VecGet(xi,xiCounter+3)/VecGet(xi,xiCounter+1)));
+		thirdTerm = (1/params->modelConst->reyn + VecGet(vT,i))*Deriv2(xi,0,xiCounter+3,params->grid);
 		fourthTerm = Deriv1(xi,0,xiCounter+3,params->grid)*Deriv1vT(vT,i,params->grid);
 		val = firstTerm + secondTerm + thirdTerm + fourthTerm;
 		Log(logDEBUG3) << "V2 term = " << val<< " at " << i;
 		//if (!isfinite(val))
 		//	return 1; 
-		gsl_vector_set(sysF,xiCounter+3,val); 
-	}
+		VecSet(sysF,xiCounter+3,val); 
 	}
 
-	double val; 
-	double firstTerm,secondTerm,thirdTerm;  //as defined in doc. 
+	int status = 0;
+	#pragma omp single
+	{
+	VecScalar<V> val; 
+	VecScalar<V> firstTerm,secondTerm,thirdTerm;  //as defined in doc. 
 	// compute boundary terms. 
 	i=size-1; 
 	xiCounter=5*(i-1); 
-	firstTerm = -(gsl_vector_get(xi,xiCounter+3)-gsl_vector_get(params->XiN,xiCounter+3))/params->deltaT;	
-	secondTerm = gsl_vector_get(xi,xiCounter+1)*gsl_vector_get(xi,xiCounter+4) - gsl_vector_get(xi,xiCounter+2)*( (gsl_vector_get(xi,xiCounter+3)/gsl_vector_get(xi,xiCounter+1)));
-	thirdTerm = (1/params->modelConst->reyn + gsl_vector_get(vT,i))*BdryDeriv2(xi,xiCounter+3,params->grid);
+	firstTerm = -(VecGet(xi,xiCounter+3)-gsl_vector_get(params->XiN,xiCounter+3))/TimeStep(params,xiCounter+3);	
+	secondTerm = VecGet(xi,xiCounter+1)*VecGet(xi,xiCounter+4) - VecGet(xi,xiCounter+2)*( (VecGet(xi,xiCounter+3)/VecGet(xi,xiCounter+1)));
+	thirdTerm = (1/params->modelConst->reyn + VecGet(vT,i))*BdryDeriv2(xi,xiCounter+3,params->grid);
 	val = firstTerm + secondTerm + thirdTerm;
 	Log(logDEBUG3) << "V2 term = " << val<< " at " << i;
 	if (!isfinite(val))
-		return 1; 
-	gsl_vector_set(sysF,xiCounter+3,val); 
+		status = 1; 
+	else
+		VecSet(sysF,xiCounter+3,val); 
+	}
 
-	return 0; 
+	return status; 
 }
 
 
-int SetEpTerms(gsl_vector * xi, gsl_vector * vT,gsl_vector * T,FParams * params, gsl_vector * sysF)
+template<class V>
+int SetEpTerms(V * xi, V * vT,V * T,FParams * params, V * sysF)
 {
 	Log(logDEBUG2) << "Setting Ep terms";
 	unsigned int i; 
 	unsigned int size = vT->size;
-	double xiCounter; 
-	double ep0 = ComputeEp0(xi,params->modelConst,params->grid);
+	unsigned int xiCounter; 
+	VecScalar<V> ep0 = ComputeEp0(xi,params->modelConst,params->grid);
 
 	//same loop as above. 
-	#pragma omp parallel num_threads(THREADS) 
-	{
 	#pragma omp for private(xiCounter)
 	for (i = 1; i<size-1;i++)
 	{
-		double firstTerm,secondTerm,thirdTerm,fourthTerm,val; 
+		VecScalar<V> firstTerm,secondTerm,thirdTerm,fourthTerm,val; 
 		xiCounter=5*(i-1); 
-		firstTerm = -(gsl_vector_get(xi,xiCounter+2)-gsl_vector_get(params->XiN,xiCounter+2))/params->deltaT;	
-		secondTerm = (params->modelConst->Cep1*ComputeP(xi,vT,params->grid,i) - params->modelConst->Cep2*gsl_vector_get(xi,xiCounter+2))/gsl_vector_get(T,i);
-		thirdTerm = (1/params->modelConst->reyn + gsl_vector_get(vT,i)/params->modelConst->sigmaEp)*Deriv2(xi,ep0,xiCounter+2,params->grid);
+		firstTerm = -(VecGet(xi,xiCounter+2)-gsl_vector_get(params->XiN,xiCounter+2))/TimeStep(params,xiCounter+2);	
+		secondTerm = (params->modelConst->Cep1*ComputeP(xi,vT,params->grid,i) - params->modelConst->Cep2*VecGet(xi,xiCounter+2))/VecGet(T,i);
+		thirdTerm = (1/params->modelConst->reyn + VecGet(vT,i)/params->modelConst->sigmaEp)*Deriv2(xi,ep0,xiCounter+2,params->grid);
 		fourthTerm = (1/params->modelConst->sigmaEp)*Deriv1(xi,ep0,xiCounter+2,params->grid)*Deriv1vT(vT,i,params->grid);
 		val = firstTerm + secondTerm + thirdTerm + fourthTerm;
 		Log(logDEBUG3) << "Ep term = " << val << " at " << i;
 		//if (!isfinite(val))
 		//	return 1; 
-		gsl_vector_set(sysF,xiCounter+2,val); 
-	}
+		VecSet(sysF,xiCounter+2,val); 
 	}
 
-	double val; 
-	double firstTerm, secondTerm,thirdTerm;  //as in doc. 
+	int status = 0;
+	#pragma omp single
+	{
+	VecScalar<V> val; 
+	VecScalar<V> firstTerm, secondTerm,thirdTerm;  //as in doc. 
 	i=size-1;  
 	xiCounter=5*(i-1); 
-	firstTerm = -(gsl_vector_get(xi,xiCounter+2)-gsl_vector_get(params->XiN,xiCounter+2))/params->deltaT;	
-	secondTerm = - (params->modelConst->Cep2*gsl_vector_get(xi,xiCounter+2))/gsl_vector_get(T,i); 
-	thirdTerm = (1/params->modelConst->reyn + gsl_vector_get(vT,i)/params->modelConst->sigmaEp)*BdryDeriv2(xi,xiCounter+2,params->grid);
+	firstTerm = -(VecGet(xi,xiCounter+2)-gsl_vector_get(params->XiN,xiCounter+2))/TimeStep(params,xiCounter+2);	
+	secondTerm = - (params->modelConst->Cep2*VecGet(xi,xiCounter+2))/VecGet(T,i); 
+	thirdTerm = (1/params->modelConst->reyn + VecGet(vT,i)/params->modelConst->sigmaEp)*BdryDeriv2(xi,xiCounter+2,params->grid);
 	val = firstTerm + secondTerm + thirdTerm;
 	Log(logDEBUG3) << "Ep term = " << val << " at " << i;
 	if (!isfinite(val))
-		return 1; 
-	gsl_vector_set(sysF,xiCounter+2,val);
-	return 0; 
+		status = 1; 
+	else
+		VecSet(sysF,xiCounter+2,val);
+	}
+	return status; 
 }
 
 
-int SetKTerms(gsl_vector * xi, gsl_vector* vT,FParams * params,gsl_vector *sysF)
+template<class V>
+int SetKTerms(V * xi, V * vT,FParams * params,V * sysF)
 {
 	Log(logDEBUG2) <<"Setting K terms";
 	unsigned int i;  
 	unsigned int size=vT->size; 
-	double xiCounter; 
+	unsigned int xiCounter; 
 	//same loops as above. 
-	#pragma omp parallel num_threads(THREADS) 
-	{
 	#pragma omp for private(xiCounter)
 	for(i=1; i<size-1;i++)
 	{
-		double firstTerm,secondTerm,thirdTerm,fourthTerm,val; 
+		VecScalar<V> firstTerm,secondTerm,thirdTerm,fourthTerm,val; 
 		xiCounter=5*(i-1);
-		firstTerm = -(gsl_vector_get(xi,xiCounter+1)-gsl_vector_get(params->XiN,xiCounter+1))/params->deltaT;	
-		secondTerm = ComputeP(xi,vT,params->grid,i)-gsl_vector_get(xi,xiCounter+2);
-		thirdTerm = (1/params->modelConst->reyn + gsl_vector_get(vT,i)/1.3)*Deriv2(xi,0,xiCounter+1,params->grid);
+		firstTerm = -(VecGet(xi,xiCounter+1)-gsl_vector_get(params->XiN,xiCounter+1))/TimeStep(params,xiCounter+1);	
+		secondTerm = ComputeP(xi,vT,params->grid,i)-VecGet(xi,xiCounter+2);
+		thirdTerm = (1/params->modelConst->reyn + VecGet(vT,i)/1.3)*Deriv2(xi,0,xiCounter+1,params->grid);
 		fourthTerm = Deriv1(xi,0,xiCounter+1,params->grid)*Deriv1vT(vT,i,params->grid);
 		val = firstTerm + secondTerm + thirdTerm + fourthTerm; 
 		Log(logDEBUG3) << "K term = " << val<< " at "<<i;
 		//if(!isfinite(val))
 		//	return 1; 
-		gsl_vector_set(sysF,xiCounter+1,val); 
-	}
+		VecSet(sysF,xiCounter+1,val); 
 	}
 
-	double val; 
-	double firstTerm, secondTerm, thirdTerm;
+	int status = 0;
+	#pragma omp single
+	{
+	VecScalar<V> val; 
+	VecScalar<V> firstTerm, secondTerm, thirdTerm;
 	i = size-1;  
 	xiCounter = 5*(i-1); 
-	firstTerm = -(gsl_vector_get(xi,xiCounter+1)-gsl_vector_get(params->XiN,xiCounter+1))/params->deltaT;	
-	secondTerm = -gsl_vector_get(xi,xiCounter+2); 
-	thirdTerm = (1/params->modelConst->reyn + gsl_vector_get(vT,i)/1.3)*BdryDeriv2(xi,xiCounter+1,params->grid);
+	firstTerm = -(VecGet(xi,xiCounter+1)-gsl_vector_get(params->XiN,xiCounter+1))/TimeStep(params,xiCounter+1);	
+	secondTerm = -VecGet(xi,xiCounter+2); 
+	thirdTerm = (1/params->modelConst->reyn + VecGet(vT,i)/1.3)*BdryDeriv2(xi,xiCounter+1,params->grid);
 	val = firstTerm+secondTerm+thirdTerm; 
 	Log(logDEBUG3) << "K term = " << val<< " at "<<i;
 	if(!isfinite(val))
-		return 1; 
-	gsl_vector_set(sysF,xiCounter+1,val); 
-	return 0; 
+		status = 1; 
+	else
+		VecSet(sysF,xiCounter+1,val); 
+	}
+	return status; 
 
 }
 
-int SetUTerms( gsl_vector * xi, gsl_vector * vT, FParams * params,gsl_vector * sysF)
+template<class V>
+int SetUTerms(V * xi, V * vT, FParams * params,V * sysF)
 {
 	Log(logDEBUG2) << "Setting U terms";
 	//same structure as other functions. 
 	unsigned int i; 
 	unsigned int size=vT->size; 
-	double xiCounter;
+	unsigned int xiCounter;
 
-	#pragma omp parallel num_threads(THREADS) 
-	{
 	#pragma omp for private(xiCounter)
 	for(i=1; i<size-1; i++)
 	{
 		xiCounter = 5*(i-1);
 		//cout << omp_get_thread_num() << endl; 
 
-		double firstTerm, secondTerm, thirdTerm,val;
-		firstTerm = -(gsl_vector_get(xi,xiCounter)-gsl_vector_get(params->XiN,xiCounter))/params->deltaT;	
-		secondTerm = (1/params->modelConst->reyn + gsl_vector_get(vT,i))*Deriv2(xi,0,xiCounter, params->grid);
+		VecScalar<V> firstTerm, secondTerm, thirdTerm,val;
+		firstTerm = -(VecGet(xi,xiCounter)-gsl_vector_get(params->XiN,xiCounter))/TimeStep(params,xiCounter);	
+		secondTerm = (1/params->modelConst->reyn + VecGet(vT,i))*Deriv2(xi,0,xiCounter, params->grid);
 		thirdTerm = Deriv1(xi,0,xiCounter, params->grid)*Deriv1vT(vT,i, params->grid);
 		val = firstTerm + secondTerm + thirdTerm+1;  
 		Log(logDEBUG3) << "U term = " << val << " at " << i;
 		//if(!isfinite(val))
 		//	return 1; 
-		gsl_vector_set(sysF,xiCounter,val);
-	}
+		VecSet(sysF,xiCounter,val);
 	}
 
-	double val; 
-	double firstTerm, secondTerm; //as in doc
+	#pragma omp single
+	{
+	VecScalar<V> val; 
+	VecScalar<V> firstTerm, secondTerm; //as in doc
 	i =size-1; 
 	xiCounter = 5*(i-1); 
-	firstTerm = -(gsl_vector_get(xi,xiCounter)-gsl_vector_get(params->XiN,xiCounter))/params->deltaT;	
-	secondTerm = (1/params->modelConst->reyn + gsl_vector_get(vT,i))*BdryDeriv2(xi,xiCounter, params->grid);
+	firstTerm = -(VecGet(xi,xiCounter)-gsl_vector_get(params->XiN,xiCounter))/TimeStep(params,xiCounter);	
+	secondTerm = (1/params->modelConst->reyn + VecGet(vT,i))*BdryDeriv2(xi,xiCounter, params->grid);
 	val = firstTerm+secondTerm + 1; 
 	Log(logDEBUG3) << "U term = " << val << " at " << i;
 	//if(!isfinite(val))
 	//	return 1; 
-	gsl_vector_set(sysF,xiCounter,val); 	
+	VecSet(sysF,xiCounter,val); 	
+	}
 	return 0; 
 }
 
-
+// Instantiations for residuals in double (gsl_vector) and dual numbers (DualVector).
+#define INSTANTIATE_SYSTEMSOLVE(V) \
+	template int SysResidual(V *,FParams *,V *); \
+	template int SysResidualByTerm(V *,FParams *,V *); \
+	template int SetUTerms(V *,V *,FParams *,V *); \
+	template int SetKTerms(V *,V *,FParams *,V *); \
+	template int SetEpTerms(V *,V *,V *,FParams *,V *); \
+	template int SetV2Terms(V *,V *,FParams *,V *); \
+	template int SetFTerms(V *,V *,V *,FParams *,V *);
+INSTANTIATE_SYSTEMSOLVE(gsl_vector)
+INSTANTIATE_SYSTEMSOLVE(DualVector)
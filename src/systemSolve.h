@@ -10,9 +10,14 @@
 #ifndef SYSTEMSOLVE_H
 #define SYSTEMSOLVE_H
 #include<gsl/gsl_vector.h>
+#include<omp.h>
 #include"setup.h"
+#include"dual.h"
 using namespace std; 
 
+/** \brief Fewest grid points per thread in the loops of the residual and Jacobians. */
+#define GRID_MIN_POINTS 64
+
 /** 
  *\brief The struct needed for gsl multiroot solvers. Defined all the parameters
  * needed for the system. 
@@ -22,18 +27,86 @@ struct FParams{
 	double deltaT; /**< step size in time. */
 	Grid* grid; /**< Pointer to grid definition */
 	constants * modelConst; /**< pointer to all of the model constants. */
+	gsl_vector * localDt; /**< local time scale of each unknown (ComputeLocalDt), or NULL for one global step. */
+	struct Workspace * work; /**< scratch of the residual and Jacobians (WorkspaceAlloc), or NULL to allocate on each call. */
 }; 
 
+/**
+ * \brief Pseudo time step of unknown j: deltaT, or deltaT times its local time scale.
+ * \param params pointer to parameters for system.
+ * \param j index into xi.
+ * \return time step.
+ */
+inline double TimeStep(FParams * params, unsigned int j)
+{
+	return params->localDt ? params->deltaT*gsl_vector_get(params->localDt,j) : params->deltaT;
+}
+
+/**
+ * \brief Threads a parallel region started here gets: omp_get_max_threads() (the threads
+ * input, or OMP_NUM_THREADS), or 1 where nested regions are inactive, as in a sweep (sweep.h).
+ * \return number of threads.
+ */
+inline int AvailableThreads()
+{
+	return (omp_get_active_level() < omp_get_max_active_levels()) ? omp_get_max_threads() : 1;
+}
+
+/**
+ * \brief Threads for a loop over a grid with size points.
+ *
+ * All threads of AvailableThreads(), but at least GRID_MIN_POINTS points per thread, since
+ * starting a thread costs about as much as the residual at a few dozen points.
+ * \param size grid points.
+ * \return number of threads.
+ */
+inline int GridThreads(unsigned int size)
+{
+	int threads = AvailableThreads();
+	int most = size/GRID_MIN_POINTS;
+	return most < 1 ? 1 : (most < threads ? most : threads);
+}
+
 /**
  * \brief Main function used by gsl_multiroot solver to set up system. 
  *
  * \param xi pointer to gsl_vector of unknowns at n+1 time step. 
  * \param p pointer to parameters for system. 
  * \param sysF gsl_vector defining multiroot function. 
- * \return Error code (0 = success). 
+ * \return Error code (0 = success, 1 if a term is not finite). 
  */
 int SysF(const gsl_vector * xi, void * p, gsl_vector * sysF);
 
+/**
+ * \brief Sets up the system for any vector type, e.g. gsl_vector or DualVector.
+ *
+ * SysF calls this with gsl_vector. With a DualVector the derivatives seeded in xi are carried
+ * through to sysF exactly (see ADJacobian). All five equations are set in one walk over the
+ * grid: the grid metrics, P, L and the derivatives of vT are evaluated once per point.
+ * The walk is one parallel region of GridThreads threads, each owning a contiguous range of
+ * points, so the result does not depend on the number of threads.
+ * \param xi pointer to vector of unknowns at n+1 time step.
+ * \param params pointer to parameters for system.
+ * \param sysF vector defining multiroot function.
+ * \return Error code (0 = success, 1 if a term is not finite).
+ */
+template<class V>
+int SysResidual(V * xi, FParams * params, V * sysF);
+
+/**
+ * \brief Same system as SysResidual, set one equation at a time by SetUTerms ... SetFTerms.
+ *
+ * Kept as the reference for the fused residual in tests and benchmarks. The setters share
+ * out their loops (orphaned omp for) in one parallel region, and set the centerline in an
+ * omp single, so they may also be called outside of a parallel region.
+ * \param xi pointer to vector of unknowns at n+1 time step.
+ * \param params pointer to parameters for system.
+ * \param sysF vector defining multiroot function.
+ * \return Error code (0 = success).
+ */
+template<class V>
+int SysResidualByTerm(V * xi, FParams * params, V * sysF);
+
 /** 
  * \brief Sets terms in system related to mean veloctity, U. 
  * \param xi pointer to gsl_vector of unknowns \f$
@@ -43,7 +116,8 @@ int SysF(const gsl_vector * xi, void * p, gsl_vector * sysF);
  * \param sysF gsl_vector defining multiroot function. 
  * \return Error code (0 = success). 
  */
-int SetUTerms(gsl_vector * xi, gsl_vector * vT,FParams * params,gsl_vector * sysF);
+template<class V>
+int SetUTerms(V * xi, V * vT,FParams * params,V * sysF);
 
 /** 
  * \brief Sets terms in system related to kinetic energy, k. 
@@ -54,7 +128,8 @@ int SetUTerms(gsl_vector * xi, gsl_vector * vT,FParams * params,gsl_vector * sys
  * \param sysF gsl_vector defining multiroot function. 
  * \return Error code (0 = success). 
  */
-int SetKTerms(gsl_vector * xi,gsl_vector * vT, FParams * params,gsl_vector *sysF);
+template<class V>
+int SetKTerms(V * xi,V * vT, FParams * params,V * sysF);
 
 /** 
  * \brief Sets terms in system related to dissipation, \f$\epsilon\f$. 
@@ -66,7 +141,8 @@ int SetKTerms(gsl_vector * xi,gsl_vector * vT, FParams * params,gsl_vector *sysF
  * \param sysF gsl_vector defining multiroot function. 
  * \return Error code (0 = success). 
  */
-int SetEpTerms(gsl_vector * xi, gsl_vector * vT, gsl_vector * T ,FParams * params, gsl_vector * sysF);
+template<class V>
+int SetEpTerms(V * xi, V * vT, V * T ,FParams * params, V * sysF);
 
 /** 
  * \brief Sets terms in system related to velocity scale, \f$\overline{v^2}\f$. 
@@ -77,7 +153,8 @@ int SetEpTerms(gsl_vector * xi, gsl_vector * vT, gsl_vector * T ,FParams * param
  * \param sysF gsl_vector defining multiroot function. 
  * \return Error code (0 = success). 
  */
-int SetV2Terms(gsl_vector * xi, gsl_vector * vT,  FParams * params, gsl_vector * sysF);
+template<class V>
+int SetV2Terms(V * xi, V * vT,  FParams * params, V * sysF);
 
 /** 
  * \brief Sets terms in system related to mean veloctity, U. 
@@ -89,6 +166,7 @@ int SetV2Terms(gsl_vector * xi, gsl_vector * vT,  FParams * params, gsl_vector *
  * \param sysF gsl_vector defining multiroot function. 
  * \return Error code (0 = success). 
  */
-int SetFTerms(gsl_vector * xi, gsl_vector * vT, gsl_vector * T, FParams * params, gsl_vector * sysF);
+template<class V>
+int SetFTerms(V * xi, V * vT, V * T, FParams * params, V * sysF);
 
 #endif
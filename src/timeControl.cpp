@@ -0,0 +1,131 @@
+//--------------------------------------------------
+// timeControl: Pseudo time step controllers.
+//
+// 10/17/2026 - Written to replace the deltaT heuristic
+//              in NewtonSolve.
+//--------------------------------------------------
+#include<math.h>
+#include"timeControl.h"
+using namespace std;
+
+// The original rule from NewtonSolve: grow by 2 while the residual drops by a
+// modest factor, cut by 10 after more than 3 steps where it doubles.
+static void LegacyUpdate(TimeController * tc, double resNorm, double maxRes, double change)
+{
+	const double residual_switch = 0.5; // deltaT won't increase if residual is above this limit
+	double ratio = maxRes/tc->prevMaxRes;
+	if (ratio > 2.0)
+		tc->divergedCount++;
+	else
+		tc->divergedCount = 0;
+	if (tc->divergedCount > 3)
+		tc->deltaT /= 10;
+	if (maxRes < residual_switch && tc->deltaT < tc->maxDeltaT && ratio > 0.2 && ratio < 1.0)
+		tc->deltaT *= 2;
+}
+
+static void SERUpdate(TimeController * tc, double resNorm, double maxRes, double change)
+{
+	tc->deltaT *= fmin(fmax(tc->prevRes/resNorm,0.1),10.0);
+	tc->deltaT = fmin(tc->deltaT,tc->maxDeltaT);
+}
+
+static void PIUpdate(TimeController * tc, double resNorm, double maxRes, double change)
+{
+	if (change <= 0.0)
+		return;
+	double factor = pow(tc->target/change,tc->kI);
+	if (tc->prevChange > 0.0)
+		factor *= pow(tc->prevChange/change,tc->kP);
+	tc->deltaT = fmin(tc->deltaT*fmin(fmax(factor,0.1),10.0),tc->maxDeltaT);
+	tc->prevChange = change;
+}
+
+TimeController * TimeControllerAlloc(solverOptions * solverOpts)
+{
+	DtUpdate update;
+	if (solverOpts->timeControl == "legacy")
+		update = &LegacyUpdate;
+	else if (solverOpts->timeControl == "ser")
+		update = &SERUpdate;
+	else if (solverOpts->timeControl == "pi")
+		update = &PIUpdate;
+	else
+		return NULL;
+
+	TimeController * tc = new TimeController;
+	tc->type = solverOpts->timeControl;
+	tc->update = update;
+	tc->deltaT = solverOpts->deltaT0;
+	tc->maxDeltaT = solverOpts->maxDeltaT;
+	tc->steadySwitch = solverOpts->steadySwitch;
+	tc->kP = solverOpts->piKP;
+	tc->kI = solverOpts->piKI;
+	tc->target = solverOpts->piTarget;
+	tc->maxGrowth = (tc->type == "legacy") ? 0.0 : TC_MAX_GROWTH;
+	tc->prevRes = 0.0;
+	tc->prevMaxRes = 100;
+	tc->prevChange = 0.0;
+	tc->divergedCount = 0;
+	tc->steps = 0;
+	tc->steadySteps = 0;
+	tc->rejectedSteps = 0;
+	tc->rejected = false;
+	tc->damped = false;
+	tc->steady = false;
+	tc->dampedSteps = 0;
+	return tc;
+}
+
+void TimeControllerFree(TimeController * tc)
+{
+	delete tc;
+}
+
+bool TimeControllerReject(TimeController * tc, double resNorm)
+{
+	if (tc->maxGrowth <= 0.0 || tc->steps == 0)
+		return false;
+	if (isfinite(resNorm) && resNorm <= tc->maxGrowth*tc->prevRes)
+		return false;
+	tc->deltaT /= 10;
+	tc->rejectedSteps++;
+	tc->rejected = true;
+	return true;
+}
+
+void TimeControllerDamped(TimeController * tc, double alpha)
+{
+	if (alpha >= 1.0)
+		return;
+	if (!tc->steady)
+		tc->deltaT *= fmax(alpha,0.1);
+	tc->dampedSteps++;
+	tc->damped = true;
+}
+
+double TimeControllerNext(TimeController * tc, double resNorm, double maxRes, double change)
+{
+	// Nothing to compare against before the first step, and nothing new after a rejected one.
+	bool retry = tc->rejected || tc->damped;
+	if (tc->steps > 0 && !tc->rejected)
+	{
+		tc->update(tc,resNorm,maxRes,change);
+	}
+	tc->steps++;
+	tc->prevRes = resNorm;
+	tc->prevMaxRes = maxRes;
+	tc->rejected = false;
+	tc->damped = false;
+	tc->steady = false;
+
+	// After a rejected or damped step the next one is finite, with the cut step. Steady steps
+	// are not cut, the next finite step tells if deltaT is too large.
+	if (resNorm < tc->steadySwitch && !retry)
+	{
+		tc->steadySteps++;
+		tc->steady = true;
+		return INFINITY;
+	}
+	return tc->deltaT;
+}
@@ -0,0 +1,109 @@
+/**
+ * \file
+ *
+ * \brief Controllers for the pseudo time step, \f$\Delta t\f$.
+ *
+ * NewtonSolve takes one Newton step per pseudo time step, so \f$\Delta t\f$ only controls how
+ * fast the solution is driven to steady state. A TimeController picks \f$\Delta t\f$ before
+ * every step from the steady residual \f$\|F(\xi^n)\|\f$ (F with no time derivative) and the
+ * relative change of the previous step. The available controllers are
+ * - "legacy": the original heuristic, doubling \f$\Delta t\f$ while the residual drops steadily.
+ * - "ser": switched evolution relaxation, \f$\Delta t^{n} = \Delta t^{n-1}\|F(\xi^{n-1})\|/\|F(\xi^n)\|\f$.
+ * - "pi": PI control of the relative change \f$e^n = \|\xi^n-\xi^{n-1}\|/\|\xi^n\|\f$,
+ *   \f$\Delta t^{n} = \Delta t^{n-1} (e^{n-2}/e^{n-1})^{k_P} (e_{target}/e^{n-1})^{k_I}\f$.
+ *
+ * With any of them, steady Newton (\f$\Delta t = \infty\f$) is used while the steady residual
+ * is below steady_switch. Except for legacy, a step that grows the steady residual by more than
+ * TC_MAX_GROWTH is rejected and retried with \f$\Delta t/10\f$. A step the line search had to
+ * scale by \f$\alpha < 1\f$ was too long for the Newton model, so \f$\Delta t\f$ is scaled by
+ * \f$\alpha\f$ as well.
+ */
+#ifndef TIMECONTROL_H
+#define TIMECONTROL_H
+#include<string>
+#include"setup.h"
+using namespace std;
+
+/**
+ * \brief Largest growth of the steady residual norm accepted over one step.
+ */
+#define TC_MAX_GROWTH 10.0
+
+struct TimeController;
+
+/**
+ * \brief Updates tc->deltaT before a step.
+ * \param tc pointer to controller.
+ * \param resNorm \f$\|F(\xi^n)\|_2\f$ with no time derivative.
+ * \param maxRes largest entry of the residual after the previous step.
+ * \param change relative change of the previous step.
+ */
+typedef void (*DtUpdate)(TimeController * tc, double resNorm, double maxRes, double change);
+
+/**
+ * \brief State of a pseudo time step controller.
+ */
+struct TimeController {
+	string type; /**< "legacy", "ser" or "pi". */
+	DtUpdate update; /**< update rule of type. */
+	double deltaT; /**< current (finite) time step. */
+	double maxDeltaT; /**< largest finite time step. */
+	double steadySwitch; /**< use \f$\Delta t = \infty\f$ while resNorm is below this (0 = never). */
+	double kP; /**< proportional gain of pi. */
+	double kI; /**< integral gain of pi. */
+	double target; /**< relative change pi aims for. */
+	double maxGrowth; /**< reject steps growing resNorm by more than this (0 = never). */
+	double prevRes; /**< resNorm at the previous step. */
+	double prevMaxRes; /**< maxRes at the previous step (legacy). */
+	double prevChange; /**< change at the previous step (pi). */
+	int divergedCount; /**< steps in a row with a growing residual (legacy). */
+	int steps; /**< number of steps taken. */
+	int steadySteps; /**< number of steps taken with \f$\Delta t = \infty\f$. */
+	int rejectedSteps; /**< number of steps rejected. */
+	bool rejected; /**< the last step was rejected. */
+	bool steady; /**< the last step was taken with \f$\Delta t = \infty\f$. */
+	bool damped; /**< the last step was scaled down by the line search. */
+	int dampedSteps; /**< number of steps scaled down by the line search. */
+};
+
+/**
+ * \brief Allocate the controller chosen by solverOpts->timeControl.
+ * \param solverOpts pointer to solver options (time_control, deltaT0, max_deltaT, steady_switch, pi_*).
+ * \return pointer to new controller, or NULL for an unknown type.
+ */
+TimeController * TimeControllerAlloc(solverOptions * solverOpts);
+
+/**
+ * \brief Free a controller.
+ * \param tc pointer to controller.
+ */
+void TimeControllerFree(TimeController * tc);
+
+/**
+ * \brief Check the step just taken. If it is rejected, deltaT is cut and the caller has to
+ * restore \f$\xi\f$ from before the step.
+ * \param tc pointer to controller.
+ * \param resNorm \f$\|F(\xi^{n+1})\|_2\f$ with no time derivative.
+ * \return true if the step is rejected.
+ */
+bool TimeControllerReject(TimeController * tc, double resNorm);
+
+/**
+ * \brief Report a step scaled by the line search. The next step is a finite one, and after a 
+ * finite step deltaT is also scaled by alpha (at most cut by 10).
+ * \param tc pointer to controller.
+ * \param alpha scale of the step, nothing is done for alpha >= 1.
+ */
+void TimeControllerDamped(TimeController * tc, double alpha);
+
+/**
+ * \brief Time step for the next step.
+ * \param tc pointer to controller.
+ * \param resNorm \f$\|F(\xi^n)\|_2\f$ with no time derivative.
+ * \param maxRes largest entry of the residual after the previous step.
+ * \param change relative change of the previous step.
+ * \return \f$\Delta t\f$, which is INFINITY for a steady Newton step.
+ */
+double TimeControllerNext(TimeController * tc, double resNorm, double maxRes, double change);
+
+#endif
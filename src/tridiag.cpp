@@ -0,0 +1,154 @@
+//--------------------------------------------------
+// tridiag: Storage and solve for scalar tridiagonal systems.
+//
+// 10/17/2026 - Written to replace the dense LU solve in Solve4f0.
+// 10/17/2026 - Scratch owned by the system, and cyclic reduction in O(n) work.
+//--------------------------------------------------
+#include<stdlib.h>
+#include<string.h>
+#include<math.h>
+#include<omp.h>
+#include"tridiag.h"
+#include"../include/loglevel.h"
+using namespace std;
+
+TridiagonalSystem * TridiagAlloc(unsigned int n)
+{
+	TridiagonalSystem * sys = (TridiagonalSystem *)malloc(sizeof(TridiagonalSystem));
+	sys->n = n;
+	sys->lower = gsl_vector_calloc(n);
+	sys->diag  = gsl_vector_calloc(n);
+	sys->upper = gsl_vector_calloc(n);
+	sys->rhs   = gsl_vector_calloc(n);
+	sys->work  = (double *)malloc(4*n*sizeof(double));
+	return sys;
+}
+
+void TridiagFree(TridiagonalSystem * sys)
+{
+	gsl_vector_free(sys->lower);
+	gsl_vector_free(sys->diag);
+	gsl_vector_free(sys->upper);
+	gsl_vector_free(sys->rhs);
+	free(sys->work);
+	free(sys);
+}
+
+void TridiagSetRow(TridiagonalSystem * sys, unsigned int i, double lower, double diag, double upper, double rhs)
+{
+	gsl_vector_set(sys->lower,i,(i > 0) ? lower : 0.0);
+	gsl_vector_set(sys->diag,i,diag);
+	gsl_vector_set(sys->upper,i,(i < sys->n-1) ? upper : 0.0);
+	gsl_vector_set(sys->rhs,i,rhs);
+}
+
+int TridiagSolve(TridiagonalSystem * sys, gsl_vector * x)
+{
+	unsigned int n = sys->n;
+	double * c = sys->work; // modified upper diagonal
+	double denom;
+
+	// Forward sweep
+	denom = gsl_vector_get(sys->diag,0);
+	if (denom == 0.0)
+	{
+		Log(logERROR) << "Error: zero pivot in tridiagonal solve at 0";
+		return 1;
+	}
+	c[0] = gsl_vector_get(sys->upper,0)/denom;
+	gsl_vector_set(x,0,gsl_vector_get(sys->rhs,0)/denom);
+	for (unsigned int i = 1; i < n; i++)
+	{
+		double a = gsl_vector_get(sys->lower,i);
+		denom = gsl_vector_get(sys->diag,i) - a*c[i-1];
+		if (denom == 0.0)
+		{
+			Log(logERROR) << "Error: zero pivot in tridiagonal solve at " << i;
+			return 1;
+		}
+		c[i] = gsl_vector_get(sys->upper,i)/denom;
+		gsl_vector_set(x,i,(gsl_vector_get(sys->rhs,i) - a*gsl_vector_get(x,i-1))/denom);
+	}
+
+	// Back substitution
+	for (int i = n-2; i >= 0; i--)
+		gsl_vector_set(x,i,gsl_vector_get(x,i) - c[i]*gsl_vector_get(x,i+1));
+
+	return 0;
+}
+
+int TridiagSolveCR(TridiagonalSystem * sys, gsl_vector * x)
+{
+	int n = sys->n;
+	int status = 0;
+	// The system is reduced in a copy, so it is not modified.
+	double * a = sys->work;
+	double * b = a + n;
+	double * c = a + 2*n;
+	double * d = a + 3*n;
+
+	#pragma omp parallel reduction(|:status)
+	{
+		#pragma omp for
+		for (int i = 0; i < n; i++)
+		{
+			a[i] = gsl_vector_get(sys->lower,i);
+			b[i] = gsl_vector_get(sys->diag,i);
+			c[i] = gsl_vector_get(sys->upper,i);
+			d[i] = gsl_vector_get(sys->rhs,i);
+		}
+
+		// The step with stride s eliminates rows i-s and i+s from the rows i = 2s-1 mod 2s, which
+		// then only couple to each other (i-2s and i+2s). It reads rows that it does not write.
+		int s;
+		for (s = 1; 2*s <= n; s *= 2)
+		{
+			#pragma omp for
+			for (int i = 2*s-1; i < n; i += 2*s)
+			{
+				if (b[i-s] == 0.0 || (i+s < n && b[i+s] == 0.0))
+				{
+					status |= 1;
+					continue;
+				}
+				double k1 = a[i]/b[i-s];
+				double k2 = (i+s < n) ? c[i]/b[i+s] : 0.0;
+				b[i] -= c[i-s]*k1 + ((i+s < n) ? a[i+s]*k2 : 0.0);
+				d[i] -= d[i-s]*k1 + ((i+s < n) ? d[i+s]*k2 : 0.0);
+				a[i] = -a[i-s]*k1;
+				c[i] = (i+s < n) ? -c[i+s]*k2 : 0.0;
+			}
+		}
+
+		// Row s-1 is left on its own. Back substitution solves the rows eliminated at each step
+		// from the rows of the steps after it.
+		#pragma omp single
+		{
+			if (b[s-1] == 0.0)
+				status |= 1;
+			else
+				gsl_vector_set(x,s-1,d[s-1]/b[s-1]);
+		}
+		for (s /= 2; s >= 1; s /= 2)
+		{
+			#pragma omp for
+			for (int i = s-1; i < n; i += 2*s)
+			{
+				double r = d[i];
+				if (i-s >= 0)
+					r -= a[i]*gsl_vector_get(x,i-s);
+				if (i+s < n)
+					r -= c[i]*gsl_vector_get(x,i+s);
+				if (b[i] == 0.0)
+					status |= 1;
+				else
+					gsl_vector_set(x,i,r/b[i]);
+			}
+		}
+	}
+	if (status)
+	{
+		Log(logERROR) << "Error: zero pivot in cyclic reduction";
+	}
+	return status;
+}
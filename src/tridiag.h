@@ -0,0 +1,81 @@
+/**
+ * \file
+ *
+ * \brief Storage and solve for scalar tridiagonal systems.
+ *
+ * Used for systems that only couple a grid point to its two neighbors, such as the
+ * finite difference equation for the initial values of f in Solve4f0. Storage is O(N), and
+ * the scratch of the solves is allocated with the system, so a system that is solved again
+ * (as in SegregatedStep) does not allocate. The system can be solved either with the serial
+ * Thomas algorithm or with cyclic reduction, which spreads the rows of every reduction step
+ * over the OpenMP threads.
+ */
+#ifndef TRIDIAG_H
+#define TRIDIAG_H
+
+#include<gsl/gsl_vector.h>
+
+#define CR_MIN_SIZE 20000 /**< smallest system for which Solve4f0 uses cyclic reduction. */
+
+/**
+ * \brief Tridiagonal system Ax = b.
+ *
+ * Row i is lower[i]*x[i-1] + diag[i]*x[i] + upper[i]*x[i+1] = rhs[i].
+ */
+struct TridiagonalSystem {
+	unsigned int n; /**< number of rows. */
+	gsl_vector * lower; /**< sub-diagonal. lower[0] is unused. */
+	gsl_vector * diag; /**< diagonal. */
+	gsl_vector * upper; /**< super-diagonal. upper[n-1] is unused. */
+	gsl_vector * rhs; /**< right hand side. */
+	double * work; /**< scratch of the solves, 4n values. */
+};
+
+/**
+ * \brief Allocate a zeroed tridiagonal system.
+ * \param n number of rows.
+ * \return pointer to new system.
+ */
+TridiagonalSystem * TridiagAlloc(unsigned int n);
+
+/**
+ * \brief Free a tridiagonal system.
+ * \param sys pointer to system.
+ */
+void TridiagFree(TridiagonalSystem * sys);
+
+/**
+ * \brief Set a row of the system.
+ * \param sys pointer to system.
+ * \param i row.
+ * \param lower coefficient of x[i-1] (ignored for i=0).
+ * \param diag coefficient of x[i].
+ * \param upper coefficient of x[i+1] (ignored for i=n-1).
+ * \param rhs right hand side.
+ */
+void TridiagSetRow(TridiagonalSystem * sys, unsigned int i, double lower, double diag, double upper, double rhs);
+
+/**
+ * \brief Solve the system with the Thomas algorithm.
+ *
+ * No pivoting is done, so the system should be diagonally dominant. The system is not modified.
+ * \param sys pointer to system.
+ * \param x solution.
+ * \return Error code (0 = success).
+ */
+int TridiagSolve(TridiagonalSystem * sys, gsl_vector * x);
+
+/**
+ * \brief Solve the system with cyclic reduction.
+ *
+ * Each of the \f$\lfloor \log_2 n \rfloor\f$ reduction steps eliminates every other remaining
+ * row, and the back substitution solves them again in reverse order, so the work is O(n) like
+ * the Thomas algorithm. The rows of a step are independent, and are split over the OpenMP
+ * threads of a single parallel region. No pivoting is done. The system is not modified.
+ * \param sys pointer to system.
+ * \param x solution.
+ * \return Error code (0 = success).
+ */
+int TridiagSolveCR(TridiagonalSystem * sys, gsl_vector * x);
+
+#endif
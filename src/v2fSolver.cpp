@@ -0,0 +1,489 @@
+//--------------------------------------------------
+// v2fSolver: One v2-f solve with its own configuration,
+// status and output.
+//
+// 10/17/2026 - Written from main.cpp, with NewtonSolve and SequenceSolve, so that
+//              several solves can run in one process.
+// 10/17/2026 - Steps of the line search are not clipped by Limit.
+// 10/17/2026 - Nor are semismooth steps.
+// 10/17/2026 - Mixed precision solves in double precision counted.
+// 10/17/2026 - Anderson mixed steps kept above the bounds by the line search.
+// 10/17/2026 - Steps that F failed within are rejected.
+// 10/17/2026 - Thread count set before the log of the pool, and restored after the solve.
+//--------------------------------------------------
+#include<iomanip>
+#include<sstream>
+#include<math.h>
+#include<omp.h>
+#include<gsl/gsl_multiroots.h>
+#include<gsl/gsl_blas.h>
+#include"v2fSolver.h"
+#include"systemSolve.h"
+#include"chordNewton.h"
+#include"jfnk.h"
+#include"timeControl.h"
+#include"gridTransfer.h"
+#include"multigrid.h"
+#include"anderson.h"
+#include"segregated.h"
+#include"lineSearch.h"
+#include"semismooth.h"
+#include"computeTerms.h"
+#include"workspace.h"
+using namespace std;
+
+static void PrintState(int i, string status, double deltaT, double maxres)
+{
+	Log(logINFO) << setw(11)<< "Iteration: " << setw(7) << std::left <<  i << "\tdeltaT = " << setw(10) << std::left << setprecision(5) << deltaT
+		<< setw(14) << "\tMax Residual: " << setw(10) << std::left << setprecision(5) << maxres << "\t GSL SOLVER STATUS: " << status;
+}
+
+// Log level and sink of the calling thread, and of the threads of the pool its parallel
+// regions run on, unless it is in a parallel region itself (a sweep), whose nested regions
+// only have the calling thread.
+static void SetLog(loglevel_e level, ostream * sink)
+{
+	if (!omp_in_parallel())
+	{
+		#pragma omp parallel
+		{
+			loglevel = level;
+			logSink = sink;
+		}
+	}
+	loglevel = level;
+	logSink = sink;
+}
+
+int V2fConfigParse(V2fConfig * config, runOptions * runOpts, int ac, char ** av)
+{
+	runOptions unused;
+	if (!runOpts)
+		runOpts = &unused;
+	config->modelConst = {.reyn=0,.Cmu=0,.C1=0,.C2=0,.Cep1=0,.Cep2=0,.Ceta=0,.CL=0,.sigmaEp=0};
+	if (Input_Parse(&config->modelConst,config->dataFile,config->outFile,config->uniformGrid,config->maxTs,
+	                config->restarting,&config->solverOpts,ac,av,runOpts))
+		return 1;
+	config->initFile = runOpts->initFile;
+	config->snapshotPrefix = runOpts->snapshotPrefix;
+	config->snapshotEvery = runOpts->snapshotEvery;
+	config->logLevel = loglevel;
+	config->log = NULL;
+	return 0;
+}
+
+V2fSolver * V2fSolverAlloc(const V2fConfig * config)
+{
+	V2fSolver * s = new V2fSolver;
+	s->config = *config;
+	s->grid = new Grid(config->uniformGrid, 1.0, 1.0/config->modelConst.reyn);
+	s->xi = gsl_vector_calloc(5*s->grid->getSize());
+	s->status = 0;
+	s->converged = false;
+	s->iterations = 0;
+	s->maxResidual = INFINITY;
+	return s;
+}
+
+void V2fSolverFree(V2fSolver * s)
+{
+	gsl_vector_free(s->xi);
+	delete s->grid;
+	delete s;
+}
+
+// Initial conditions, solve and output of V2fSolverRun, with the log already set.
+static int Run(V2fSolver * s)
+{
+	V2fConfig * c = &s->config;
+	constants * modelConst = &c->modelConst;
+	Log(logINFO) << "---> Number of grid points = " << s->grid->getSize();
+
+	// Solving for initial conditions
+	Log(logINFO) << "Solving initial conditions for U,k,ep,v2";
+	if (c->solverOpts.gridLevels > 1 && c->solverOpts.solver != "fas")
+	{
+		// Initial conditions from the solution on the coarser grids.
+		if(SequenceSolve(s))
+		{
+			Log(logERROR) << "Error in grid sequence.";
+			return 1;
+		}
+	}
+	else
+	{
+		if(SolveIC(s->xi,modelConst,s->grid,c->dataFile,c->restarting))
+		{
+			Log(logERROR) << "Error interpolating initial conditions.";
+			return 1;
+		}
+
+		if (!c->restarting)
+		{
+		        Log(logINFO) << "Solving initial conditions for f";
+			if(Solve4f0(s->xi,modelConst,s->grid))
+			{
+				Log(logERROR) << "Error initializing f";
+				return 1;
+			}
+		}
+	}
+	if (!c->initFile.empty() && SaveResults(s->xi,c->initFile,s->grid,modelConst))
+		return 1;
+
+	// Newton Solve.
+	Log(logINFO) << "Solving system...";
+	int status;
+	if (c->solverOpts.solver == "fas")
+	{
+		Multigrid * mg = MultigridAlloc(s->grid,modelConst,&c->solverOpts);
+		status = MultigridSolve(s->xi,mg,c->maxTs);
+		MultigridFree(mg);
+	}
+	else
+		status = NewtonSolve(s,s->xi,s->grid);
+	if (status)
+		return 1;
+
+	// The result is judged by its steady residual, whichever solver found it.
+	gsl_vector * f = gsl_vector_alloc(s->xi->size);
+	struct FParams steady = {s->xi,INFINITY,s->grid,modelConst};
+	status = SysF(s->xi,&steady,f);
+	s->maxResidual = fmax(gsl_vector_max(f),-gsl_vector_min(f));
+	s->converged = !status && gsl_multiroot_test_residual(f,1e-7) == GSL_SUCCESS;
+	gsl_vector_free(f);
+	if (status)
+		return 1;
+
+	//writing data to output
+	if (!c->outFile.empty())
+	{
+		Log(logINFO) << "Writing results to " << c->outFile;
+		if (SaveResults(s->xi,c->outFile,s->grid,modelConst))
+			return 1;
+	}
+	return 0;
+}
+
+int V2fSolverRun(V2fSolver * s)
+{
+	loglevel_e level = loglevel;
+	ostream * sink = logSink;
+	int threads = omp_get_max_threads();
+	// The team size first, so SetLog reaches every thread the solve runs on.
+	if (s->config.solverOpts.threads > 0)
+		omp_set_num_threads(s->config.solverOpts.threads);
+	SetLog(s->config.logLevel,s->config.log ? s->config.log : &cerr);
+
+	s->iterations = 0;
+	s->converged = false;
+	s->maxResidual = INFINITY;
+	s->status = Run(s);
+
+	SetLog(level,sink);
+	omp_set_num_threads(threads);
+	return s->status;
+}
+
+int NewtonSolve(V2fSolver * sv, gsl_vector * xi, Grid * grid)
+{
+	constants * modelConst = &sv->config.modelConst;
+	solverOptions * solverOpts = &sv->config.solverOpts;
+	int max_ts = sv->config.maxTs;
+        double max_residual = 100;    // The max residual at the current step
+        double change = 0.0;          // relative change of xi over the last step
+        double deltaT;
+	int status;  // status of solver
+	int error = 0; // residual of xi not finite
+	bool stepFailed = false; // F failed within the last step, which is then rejected
+	int iter = 0;
+	//set up solver
+	Log(logINFO) <<"Setting up Solver";
+	gsl_vector * x = gsl_vector_alloc(xi->size); // unknowns at n+1 time step
+	gsl_vector * f = gsl_vector_alloc(xi->size); // residual at x
+	gsl_vector * fs = gsl_vector_alloc(xi->size); // steady residual at xi
+	gsl_vector * xOld = gsl_vector_alloc(xi->size); // xi before the last step
+	ChordNewton * C = NULL;                      // lagged Jacobian for the newton solver
+	gsl_multiroot_fsolver * s = NULL;            // gsl solver for dnewton
+	JFNKPrecond * M = NULL;                      // preconditioner for jfnk
+	Segregated * S = NULL;                       // group by group steps for segregated
+	Semismooth * B = NULL;                       // bound constrained steps for semismooth
+	LineSearch * ls = NULL;                      // scales the steps
+	gsl_vector * localDt = NULL;                 // local time scales, deltaT is then a multiple of them
+	if (solverOpts->localDt)
+	{
+		localDt = gsl_vector_alloc(xi->size);
+		ComputeLocalDt(xi,modelConst,grid,localDt);
+	}
+	if (solverOpts->lineSearch)
+		ls = LineSearchAlloc(xi->size,solverOpts);
+	TimeController * tc = TimeControllerAlloc(solverOpts); // picks deltaT
+	Workspace * work = WorkspaceAlloc(xi->size/5+1);       // scratch of SysF and the Jacobians
+	unsigned long allocFirstStep = 0;                      // scratch allocations up to the end of step 1
+	Anderson * aa = NULL;                        // mixes the last steps
+	gsl_vector * xMix = NULL;                    // Anderson mixed step
+	int mixCount = 0;                            // mixed steps taken
+	if (solverOpts->andersonDepth > 0)
+	{
+		aa = AndersonAlloc(xi->size,solverOpts->andersonDepth,solverOpts->andersonRestart);
+		xMix = gsl_vector_alloc(xi->size);
+	}
+	if (solverOpts->solver == "dnewton")
+		s = gsl_multiroot_fsolver_alloc(gsl_multiroot_fsolver_dnewton,xi->size);
+	else if (solverOpts->solver == "jfnk")
+		M = JFNKPrecondAlloc(solverOpts->precond,xi->size/5);
+	else if (solverOpts->solver == "semismooth")
+		B = SemismoothAlloc(xi->size/5,solverOpts);
+	else
+		C = ChordNewtonAlloc(xi->size/5,solverOpts);
+	// With the bounds as complementarity conditions F does not vanish on an active bound,
+	// so the time step control and the convergence test use the residual of the bounded problem.
+	gsl_vector * res = B ? B->res : fs;
+	if (solverOpts->solver == "segregated")
+	{
+		// The frozen coupling between the groups is only stable for moderate deltaT.
+		S = SegregatedAlloc(xi->size/5,solverOpts->jacMaxAge);
+		tc->maxDeltaT = fmin(tc->maxDeltaT,solverOpts->segregatedMaxDeltaT);
+		tc->deltaT = fmin(tc->deltaT,tc->maxDeltaT);
+		tc->steadySwitch = 0.0;
+	}
+	//for time marching, starting small and getting bigger works best.
+	do
+	{
+		iter++;
+		// F(xi) has no time derivative term, so it is the steady residual for any deltaT.
+		struct FParams p = {xi,tc->deltaT,grid,modelConst,localDt,work};
+		FParams * params = &p;
+		int evalStatus = SysF(xi,params,fs);
+		if (B)
+			SemismoothResidual(xi,fs,res);
+		// A step to a point where the residual is not finite, or one that F failed within,
+		// is rejected too, if the controller rejects steps at all.
+		if (TimeControllerReject(tc,stepFailed ? NAN : gsl_blas_dnrm2(res)))
+		{
+			Log(logDEBUG) << "Step rejected, retrying with deltaT = " << tc->deltaT;
+			gsl_vector_memcpy(xi,xOld);
+			evalStatus = SysF(xi,params,fs);
+			if (B)
+				SemismoothResidual(xi,fs,res);
+			if (aa)
+				AndersonReset(aa);
+		}
+		else if (stepFailed)
+			evalStatus = 1;
+		if (evalStatus)
+		{
+			Log(logERROR) << "Residual not finite at iteration " << iter;
+			error = 1;
+			break;
+		}
+		// Segregated steps only converge linearly, so the coupled ones finish the solve.
+		if (S && fmax(gsl_vector_max(fs),-gsl_vector_min(fs)) < solverOpts->segregatedSwitch)
+		{
+			Log(logINFO) << "Switching to coupled Newton steps after " << S->stepCount << " segregated steps";
+			SegregatedFree(S);
+			S = NULL;
+			tc->maxDeltaT = solverOpts->maxDeltaT;
+			tc->steadySwitch = solverOpts->steadySwitch;
+		}
+		if (localDt)
+			ComputeLocalDt(xi,modelConst,grid,localDt);
+		double resNorm = gsl_blas_dnrm2(res);
+		deltaT = TimeControllerNext(tc,resNorm,max_residual,change);
+		p.deltaT = deltaT;
+		//only need one iteration per deltaT since we don't care about temporal accuracy.
+		//We are just trying to get to the fully developed region of flow.
+		if (s)
+		{
+			gsl_multiroot_function F = {&SysF,xi->size,params};
+			gsl_multiroot_fsolver_set(s,&F,xi);
+			status = gsl_multiroot_fsolver_iterate(s);
+			gsl_vector_memcpy(x,s->x);
+			gsl_vector_memcpy(f,s->f);
+		}
+		else if (M)
+		{
+			gsl_vector_memcpy(x,xi);
+			status = JFNKStep(x,params,M,solverOpts,fs,f);
+		}
+		else if (S)
+		{
+			gsl_vector_memcpy(x,xi);
+			status = SegregatedStep(x,params,S,fs,f);
+		}
+		else if (B)
+		{
+			gsl_vector_memcpy(x,xi);
+			status = SemismoothStep(x,params,B,fs,f);
+		}
+		else
+		{
+			gsl_vector_memcpy(x,xi);
+			status = ChordNewtonStep(x,params,C,fs,f);
+		}
+		stepFailed = (status == GSL_EBADFUNC);
+		// The line search keeps k and v2 above their bounds itself, so f stays F of its step,
+		// and the semismooth steps project onto all bounds themselves.
+		if (ls && !status)
+		{
+			double alpha;
+			status = LineSearchStep(xi,x,params,fs,f,ls,&alpha);
+			if (!status)
+				TimeControllerDamped(tc,alpha);
+		}
+		else if (!B)
+			Limit(x);
+		// The Newton step is the map x -> G(x) that Anderson acceleration mixes with the last
+		// ones. Every deltaT gives a map with the same fixed point, and the mixed step is only
+		// taken if it has a smaller steady residual than both the Newton step and xi. The mixed
+		// step is not a time step, so its steady residual is the one reported. With the line
+		// search it is kept above the bounds like the Newton steps, not clipped to them.
+		if (aa && !status && AndersonMix(aa,xi,x,xMix))
+		{
+			if (ls)
+				LineSearchLimit(xi,xMix,ls);
+			else
+				Limit(xMix);
+			struct FParams steady = {x,INFINITY,grid,modelConst,NULL,work};
+			int mixStatus = SysF(x,&steady,fs);
+			double newtonNorm = gsl_blas_dnrm2(fs);
+			steady.XiN = xMix;
+			mixStatus |= SysF(xMix,&steady,fs);
+			if (!mixStatus && gsl_blas_dnrm2(fs) < fmin(newtonNorm,resNorm))
+			{
+				gsl_vector_memcpy(x,xMix);
+				gsl_vector_memcpy(f,fs);
+				mixCount++;
+			}
+		}
+		if (B)
+			SemismoothResidual(x,f,f);
+		max_residual = gsl_vector_max(f);
+		if (!status)
+			PrintState(iter,string(gsl_strerror(status)),deltaT,max_residual);
+		gsl_vector_memcpy(xOld,xi);
+		gsl_vector_sub(xi,x);
+		change = gsl_blas_dnrm2(xi)/gsl_blas_dnrm2(x);
+		gsl_vector_memcpy(xi,x);
+
+		if (!sv->config.snapshotPrefix.empty() && iter%sv->config.snapshotEvery == 0)
+		{
+			ostringstream name;
+			name << sv->config.snapshotPrefix << iter << ".dat";
+			SaveResults(xi,name.str(),grid,modelConst);
+		}
+
+		status = gsl_multiroot_test_residual (f, 1e-7);
+		if (iter == 1)
+			allocFirstStep = WorkspaceAllocCount();
+	}while(status == GSL_CONTINUE && iter < max_ts);
+
+	Log(logINFO) << "Time control " << tc->type << ": " << iter << " iterations (" << tc->steadySteps
+		<< " steady, " << tc->rejectedSteps << " rejected), final max residual " << max_residual;
+	sv->iterations = iter;
+	if (s)
+		gsl_multiroot_fsolver_free(s);
+	if (M)
+		JFNKPrecondFree(M);
+	if (S)
+	{
+		Log(logINFO) << "Segregated steps: " << S->stepCount;
+		SegregatedFree(S);
+	}
+	if (B)
+	{
+		Log(logINFO) << "Semismooth steps: " << B->stepCount << ", " << B->activeCount << " values on their bound";
+		if (B->LU->single)
+		{
+			Log(logINFO) << "Mixed precision: " << B->refineCount << " refinement steps in " << B->stepCount - B->doubleCount
+				<< " solves, " << B->doubleCount << " solves in double precision";
+		}
+		SemismoothFree(B);
+	}
+	if (C)
+	{
+		Log(logINFO) << "Jacobian factored " << C->refactorCount << " times in " << C->stepCount << " steps";
+		if (C->LU->single)
+		{
+			Log(logINFO) << "Mixed precision: " << C->refineCount << " refinement steps in " << C->solveCount
+				<< " solves, " << C->doubleCount << " solves in double precision";
+		}
+		ChordNewtonFree(C);
+	}
+	if (localDt)
+		gsl_vector_free(localDt);
+	if (ls)
+	{
+		Log(logINFO) << "Line search: " << ls->limitedCount << " steps limited, " << ls->backtrackCount
+			<< " backtracks, " << ls->failedCount << " failed, " << ls->heldCount << " held values on their bound, "
+			<< tc->dampedSteps << " damped";
+		LineSearchFree(ls);
+	}
+	if (aa)
+	{
+		Log(logINFO) << "Anderson acceleration: " << mixCount << " of " << aa->mixCount << " mixed steps taken, "
+			<< aa->restartCount << " restarts";
+		AndersonFree(aa);
+		gsl_vector_free(xMix);
+	}
+	// Only counted when built with -DDEBUG_ALLOC.
+	Log(logDEBUG) << "Scratch allocations after the first step: " << WorkspaceAllocCount()-allocFirstStep;
+	WorkspaceFree(work);
+	TimeControllerFree(tc);
+	gsl_vector_free(x);
+	gsl_vector_free(f);
+	gsl_vector_free(fs);
+	gsl_vector_free(xOld);
+	return error;
+}
+
+int SequenceSolve(V2fSolver * s)
+{
+	constants * modelConst = &s->config.modelConst;
+	Grid * grid = s->grid;
+	bool restarting = s->config.restarting;
+	// Level l has ceil(N/2^l) points, and none has fewer than SEQ_MIN_SIZE.
+	int levels = s->config.solverOpts.gridLevels;
+	while (levels > 1 && ceil(grid->getSize()/pow(2.0,levels-1)) < SEQ_MIN_SIZE)
+		levels--;
+
+	Grid * prevGrid = NULL;
+	gsl_vector * xPrev = NULL;
+	int status = 0;
+	for (int l = levels-1; l >= 0; l--)
+	{
+		Grid * level = (l == 0) ? grid : new Grid(grid->isUniform,1.0,GridSize(ceil(grid->getSize()/pow(2.0,l))));
+		gsl_vector * x = (l == 0) ? s->xi : gsl_vector_calloc(5*level->getSize());
+		Log(logINFO) << "Grid level " << l << ": " << level->getSize() << " points";
+		if (!xPrev)
+		{
+			if(SolveIC(x,modelConst,level,s->config.dataFile,restarting) || (!restarting && Solve4f0(x,modelConst,level)))
+			{
+				Log(logERROR) << "Error initializing level " << l;
+				status = 1;
+			}
+		}
+		else
+		{
+			status = Prolong(xPrev,prevGrid,x,level,modelConst);
+			gsl_vector_free(xPrev);
+			delete prevGrid;
+			xPrev = NULL;
+		}
+		// The target grid is solved by the caller.
+		if (!status && l > 0)
+			status = NewtonSolve(s,x,level);
+		if (status || l == 0)
+		{
+			if (l > 0)
+			{
+				gsl_vector_free(x);
+				delete level;
+			}
+			break;
+		}
+		xPrev = x;
+		prevGrid = level;
+	}
+	return status;
+}
@@ -0,0 +1,105 @@
+/**
+ * \file
+ *
+ * \brief One v2-f solve, from the initial conditions to the converged profile.
+ *
+ * A V2fSolver holds everything one solve needs: its configuration, grid, unknowns and
+ * result. Nothing is shared with other solvers, so several of them can run at the same time
+ * in one process (see sweep.h). Errors, including terms that are not finite, are returned
+ * as a status instead of ending the process. The log of a solver goes to the stream and at
+ * the level of its configuration, and it only writes the files its configuration names.
+ */
+#ifndef V2FSOLVER_H
+#define V2FSOLVER_H
+#include<gsl/gsl_vector.h>
+#include<iostream>
+#include<string>
+#include"setup.h"
+#include"Grid.h"
+using namespace std;
+
+/**
+ * \brief Configuration of one solve, as read by Input_Parse.
+ *
+ * An empty file name means the file is not written.
+ */
+struct V2fConfig {
+	constants modelConst; /**< model constants and Reynolds number. */
+	solverOptions solverOpts; /**< options of the nonlinear solve. */
+	string dataFile; /**< data file of the initial conditions. */
+	bool uniformGrid; /**< use a uniform grid. */
+	bool restarting; /**< the data file contains f. */
+	int maxTs; /**< largest number of pseudo time steps (FAS cycles with solver = fas). */
+	string outFile; /**< converged profile. */
+	string initFile; /**< initial conditions. */
+	string snapshotPrefix; /**< profile every snapshotEvery steps, to snapshotPrefix<step>.dat. */
+	int snapshotEvery; /**< pseudo time steps between two snapshots. */
+	loglevel_e logLevel; /**< level of the log. */
+	ostream * log; /**< stream of the log (NULL = std::cerr). */
+};
+
+/**
+ * \brief A solve and its result.
+ */
+struct V2fSolver {
+	V2fConfig config; /**< copy of the configuration. */
+	Grid * grid; /**< grid of the solve. */
+	gsl_vector * xi; /**< unknowns, the converged profile after V2fSolverRun. */
+	int status; /**< error code of the last run (0 = success). */
+	bool converged; /**< the steady residual of xi passes gsl_multiroot_test_residual(1e-7). */
+	int iterations; /**< pseudo time steps on the target grid (0 with solver = fas). */
+	double maxResidual; /**< largest absolute value of the steady residual of xi. */
+};
+
+/**
+ * \brief Fills a configuration from the input file and command line.
+ * \param config pointer to the configuration.
+ * \param runOpts pointer to the sweep options, also read (NULL = not needed).
+ * \param ac argument count passed to main.
+ * \param av argument vector passed to main.
+ * \return Error code (0 = success).
+ */
+int V2fConfigParse(V2fConfig * config, runOptions * runOpts, int ac, char ** av);
+
+/**
+ * \brief Allocates a solver with the grid and unknowns of the configuration.
+ * \param config pointer to the configuration, which is copied.
+ * \return pointer to the solver.
+ */
+V2fSolver * V2fSolverAlloc(const V2fConfig * config);
+
+/**
+ * \brief Frees a solver.
+ * \param s pointer to the solver.
+ */
+void V2fSolverFree(V2fSolver * s);
+
+/**
+ * \brief Solves for the profile: initial conditions, the grid sequence or FAS hierarchy, the
+ * pseudo time steps and the files of the configuration.
+ *
+ * The parallel regions of the calling thread get the threads of the configuration, if set.
+ * The calling thread logs with the level and stream of the configuration, and so do the
+ * threads of its parallel regions unless it is itself in one. All three are restored at the end.
+ * \param s pointer to the solver.
+ * \return Error code (0 = success), also kept in s->status.
+ */
+int V2fSolverRun(V2fSolver * s);
+
+/**
+ * \brief Pseudo time steps from xi until the residual converges or maxTs steps are taken.
+ * \param s pointer to the solver, for its configuration and iteration count.
+ * \param xi pointer to gsl_vector of unknowns, the initial conditions and then the result.
+ * \param grid pointer to the grid of xi.
+ * \return Error code (0 = success, 1 if the residual is not finite and the step cannot be retried).
+ */
+int NewtonSolve(V2fSolver * s, gsl_vector * xi, Grid * grid);
+
+/**
+ * \brief Initial conditions on the target grid from the solutions on gridLevels-1 coarser grids.
+ * \param s pointer to the solver.
+ * \return Error code (0 = success).
+ */
+int SequenceSolve(V2fSolver * s);
+
+#endif
@@ -0,0 +1,123 @@
+//--------------------------------------------------
+// workspace: Scratch of the residual and Jacobians, allocated once per grid.
+//
+// 10/17/2026 - Written so SysF and the Jacobians do not allocate on every call.
+// 10/17/2026 - Workspaces of the threads of the colored Jacobian.
+//--------------------------------------------------
+#include"workspace.h"
+using namespace std;
+
+static unsigned long allocCount = 0;
+
+#ifdef DEBUG_ALLOC
+void WorkspaceCountAlloc(unsigned int n)
+{
+	#pragma omp atomic
+	allocCount += n;
+}
+#endif
+
+unsigned long WorkspaceAllocCount()
+{
+	return allocCount;
+}
+
+gsl_vector * ScratchVector(size_t n)
+{
+	WorkspaceCountAlloc(1);
+	return gsl_vector_calloc(n);
+}
+
+Workspace * WorkspaceAlloc(unsigned int size)
+{
+	Workspace * w = new Workspace;
+	unsigned int n = 5*(size-1);
+	w->size = size;
+	w->F = FieldsAlloc<double>(size);
+	w->R = FieldsAlloc<double>(size);
+	w->FD = FieldsAlloc<JacDual>(size);
+	w->RD = FieldsAlloc<JacDual>(size);
+	w->x = VecTraits<DualVector>::Calloc(n);
+	w->f = VecTraits<DualVector>::Calloc(n);
+	WorkspaceCountAlloc(2);
+	w->T = ScratchVector(size);
+	w->vT = ScratchVector(size);
+	w->dTdk = ScratchVector(size);
+	w->dTdep = ScratchVector(size);
+	w->dvTdk = ScratchVector(size);
+	w->dvTdep = ScratchVector(size);
+	w->dvTdv2 = ScratchVector(size);
+	w->xPert = ScratchVector(n);
+	w->fPert = ScratchVector(n);
+	w->f0 = ScratchVector(n);
+	w->h = ScratchVector(n);
+	w->nThreads = 0;
+	w->threads = NULL;
+	return w;
+}
+
+void WorkspaceFree(Workspace * w)
+{
+	if (!w)
+		return;
+	for (unsigned int t = 0; t < w->nThreads; t++)
+		WorkspaceFree(w->threads[t]);
+	delete [] w->threads;
+	FieldsFree(w->F);
+	FieldsFree(w->R);
+	FieldsFree(w->FD);
+	FieldsFree(w->RD);
+	VecTraits<DualVector>::Free(w->x);
+	VecTraits<DualVector>::Free(w->f);
+	gsl_vector_free(w->T);
+	gsl_vector_free(w->vT);
+	gsl_vector_free(w->dTdk);
+	gsl_vector_free(w->dTdep);
+	gsl_vector_free(w->dvTdk);
+	gsl_vector_free(w->dvTdep);
+	gsl_vector_free(w->dvTdv2);
+	gsl_vector_free(w->xPert);
+	gsl_vector_free(w->fPert);
+	gsl_vector_free(w->f0);
+	gsl_vector_free(w->h);
+	delete w;
+}
+
+void WorkspaceThreads(Workspace * w, unsigned int n)
+{
+	if (n <= w->nThreads)
+		return;
+	Workspace ** threads = new Workspace*[n];
+	WorkspaceCountAlloc(1);
+	for (unsigned int t = 0; t < n; t++)
+		threads[t] = (t < w->nThreads) ? w->threads[t] : WorkspaceAlloc(w->size);
+	delete [] w->threads;
+	w->threads = threads;
+	w->nThreads = n;
+}
+
+int WorkspaceFields(Workspace * w, unsigned int size, Fields<double> ** F, Fields<double> ** R)
+{
+	if (WorkspaceFits(w,size))
+	{
+		*F = w->F;
+		*R = w->R;
+		return 0;
+	}
+	*F = FieldsAlloc<double>(size);
+	*R = FieldsAlloc<double>(size);
+	return 1;
+}
+
+int WorkspaceFields(Workspace * w, unsigned int size, Fields<JacDual> ** F, Fields<JacDual> ** R)
+{
+	if (WorkspaceFits(w,size))
+	{
+		*F = w->FD;
+		*R = w->RD;
+		return 0;
+	}
+	*F = FieldsAlloc<JacDual>(size);
+	*R = FieldsAlloc<JacDual>(size);
+	return 1;
+}
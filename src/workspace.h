@@ -0,0 +1,109 @@
+/**
+ * \file
+ *
+ * \brief Scratch memory of the residual and the Jacobians, allocated once per grid.
+ *
+ * SysF is called many times per pseudo time step (5N+1 times by dnewton), and every call used 
+ * to allocate its own field arrays and vectors. A Workspace holds all of that scratch for one 
+ * grid: the field arrays of SysResidual in double and dual numbers, the terms and their 
+ * derivatives used by SysJ, the seeded unknowns of ADJacobian and the perturbed vectors of 
+ * ColoredFDJacobian. The solve allocates it with the unknowns and passes it in FParams::work.
+ * With work = NULL (or a workspace of another grid) each call allocates its scratch as before.
+ *
+ * Built with -DDEBUG_ALLOC, every scratch allocation is counted (WorkspaceAllocCount), so the
+ * unit tests and the log of a solve show that no call allocates once a workspace exists.
+ */
+#ifndef WORKSPACE_H
+#define WORKSPACE_H
+#include<gsl/gsl_vector.h>
+#include"dual.h"
+#include"fields.h"
+using namespace std;
+
+/**
+ * \brief Scratch of the residual and Jacobians on one grid.
+ */
+struct Workspace {
+	unsigned int size; /**< grid points including the wall, xi->size/5+1. */
+	Fields<double> * F; /**< fields of SysResidual. */
+	Fields<double> * R; /**< residual of SysResidual. */
+	Fields<JacDual> * FD; /**< fields of SysResidual in dual numbers. */
+	Fields<JacDual> * RD; /**< residual of SysResidual in dual numbers. */
+	DualVector * x; /**< seeded unknowns of ADJacobian. */
+	DualVector * f; /**< residual of ADJacobian. */
+	gsl_vector * T; /**< T of SysJ, size entries. */
+	gsl_vector * vT; /**< vT of SysJ, size entries. */
+	gsl_vector * dTdk; /**< derivatives of T and vT in SysJ, size entries each. */
+	gsl_vector * dTdep;
+	gsl_vector * dvTdk;
+	gsl_vector * dvTdep;
+	gsl_vector * dvTdv2;
+	gsl_vector * xPert; /**< perturbed unknowns of ColoredFDJacobian. */
+	gsl_vector * fPert; /**< residual at xPert. */
+	gsl_vector * f0; /**< residual at the unperturbed unknowns. */
+	gsl_vector * h; /**< perturbation of each unknown. */
+	unsigned int nThreads; /**< number of workspaces in threads. */
+	Workspace ** threads; /**< one workspace per thread of ColoredFDJacobianThreads (WorkspaceThreads). */
+};
+
+/**
+ * \brief Allocate the scratch for a grid.
+ * \param size grid points including the wall, xi->size/5+1.
+ * \return pointer to new workspace.
+ */
+Workspace * WorkspaceAlloc(unsigned int size);
+
+/**
+ * \brief Free a workspace.
+ * \param w pointer to workspace, or NULL.
+ */
+void WorkspaceFree(Workspace * w);
+
+/**
+ * \brief Makes sure w has a workspace for each of n threads, allocating the missing ones.
+ * \param w pointer to workspace.
+ * \param n number of threads.
+ */
+void WorkspaceThreads(Workspace * w, unsigned int n);
+
+/**
+ * \brief Whether w holds the scratch of a grid with size points (w may be NULL).
+ */
+inline bool WorkspaceFits(Workspace * w, unsigned int size)
+{
+	return w && w->size == size;
+}
+
+/**
+ * \brief Field arrays for SysResidual, from w if it fits, else newly allocated.
+ * \param w pointer to workspace, or NULL.
+ * \param size grid points including the wall.
+ * \param F fields (output).
+ * \param R residual (output).
+ * \return 1 if F and R were allocated and have to be freed with FieldsFree, else 0.
+ */
+int WorkspaceFields(Workspace * w, unsigned int size, Fields<double> ** F, Fields<double> ** R);
+
+/** \brief Same as above, in dual numbers. */
+int WorkspaceFields(Workspace * w, unsigned int size, Fields<JacDual> ** F, Fields<JacDual> ** R);
+
+/**
+ * \brief gsl_vector_calloc, counted as a scratch allocation.
+ * \param n number of elements.
+ * \return new zeroed vector.
+ */
+gsl_vector * ScratchVector(size_t n);
+
+#ifdef DEBUG_ALLOC
+/** \brief Counts n scratch allocations. */
+void WorkspaceCountAlloc(unsigned int n);
+#else
+inline void WorkspaceCountAlloc(unsigned int n) {}
+#endif
+
+/**
+ * \brief Scratch allocations so far; always 0 unless built with -DDEBUG_ALLOC.
+ */
+unsigned long WorkspaceAllocCount();
+
+#endif
@@ -0,0 +1,245 @@
+//--------------------------------------------------
+// bench: Timing of the residual kernels.
+//
+// 10/17/2026 - Written for the fused residual (SysResidual against SysResidualByTerm).
+// 10/17/2026 - Batch kernels for T, L and vT.
+// 10/17/2026 - Residual and Jacobians with and without a workspace.
+// 10/17/2026 - Strong scaling over the number of threads.
+// 10/17/2026 - Colored Jacobian on threads.
+// 10/17/2026 - Strong scaling up to 8 threads, with the speedups.
+//--------------------------------------------------
+#include<iostream>
+#include<iomanip>
+#include<chrono>
+#include<math.h>
+#include"../../src/setup.h"
+#include"../../src/systemSolve.h"
+#include"../../src/computeTerms.h"
+#include"../../src/jacobian.h"
+#include"../../src/adJacobian.h"
+#include"../../src/fdJacobian.h"
+#include"../../src/workspace.h"
+using namespace std; 
+
+// Time of one call of fun in microseconds, the fastest of batches of 10 calls repeated for at
+// least minTime seconds, so other load on the machine does not count.
+template<class Fun>
+double TimeCall(Fun fun, double minTime)
+{
+	typedef chrono::steady_clock clock;
+	fun(); // warm up
+	double elapsed = 0, best = INFINITY;
+	clock::time_point start = clock::now();
+	while (elapsed < minTime)
+	{
+		clock::time_point batch = clock::now();
+		for (unsigned int r = 0; r < 10; r++)
+			fun();
+		clock::time_point now = clock::now();
+		best = fmin(best,chrono::duration<double>(now-batch).count()/10);
+		elapsed = chrono::duration<double>(now-start).count();
+	}
+	return 1e6*best;
+}
+
+int BenchResidual(double reyn, const char * data)
+{
+	Grid grid(false, 1.0, 1.0/reyn);
+	unsigned int n = 5*grid.getSize();
+	gsl_vector * xi = gsl_vector_calloc(n); 
+	gsl_vector * f = gsl_vector_alloc(n); 
+	struct constants Const = {
+		.reyn=reyn,.Cmu=0.19,.C1=0.4,.C2=0.3,.Cep1=1.55,.Cep2=1.9,.Ceta=70,.CL=0.3,.sigmaEp=1.3};
+	if (SolveIC(xi,&Const,&grid,data,false) || Solve4f0(xi,&Const,&grid))
+	{
+		cout << "Could not read " << data << endl;
+		return 1;
+	}
+	struct FParams p = {xi,1.0,&grid,&Const};
+	DualVector * x = VecTraits<DualVector>::Calloc(n);
+	DualVector * fd = VecTraits<DualVector>::Calloc(n);
+	for (unsigned int i = 0; i < n; i++)
+		x->data[i] = gsl_vector_get(xi,i);
+
+	double byTerm = TimeCall([&]{ SysResidualByTerm(xi,&p,f); },0.5);
+	double fused = TimeCall([&]{ SysResidual(xi,&p,f); },0.5);
+	double byTermDual = TimeCall([&]{ SysResidualByTerm(x,&p,fd); },0.5);
+	double fusedDual = TimeCall([&]{ SysResidual(x,&p,fd); },0.5);
+
+	cout << fixed << setprecision(1);
+	cout << "Re " << setw(5) << setprecision(0) << reyn << setprecision(1) << " (" << setw(4) << grid.getSize() << " points)"
+		<< "  double: " << setw(7) << byTerm << " -> " << setw(7) << fused << " us ("
+		<< setprecision(2) << byTerm/fused << "x)" << setprecision(1)
+		<< "  dual: " << setw(7) << byTermDual << " -> " << setw(7) << fusedDual << " us ("
+		<< setprecision(2) << byTermDual/fusedDual << "x)" << endl;
+
+	VecTraits<DualVector>::Free(x);
+	VecTraits<DualVector>::Free(fd);
+	gsl_vector_free(xi);
+	gsl_vector_free(f);
+	return 0; 
+}
+
+int BenchTerms(double reyn, const char * data)
+{
+	Grid grid(false, 1.0, 1.0/reyn);
+	unsigned int size = grid.getSize()+1;
+	gsl_vector * xi = gsl_vector_calloc(5*(size-1)); 
+	gsl_vector * T = gsl_vector_calloc(size); 
+	gsl_vector * L = gsl_vector_calloc(size); 
+	gsl_vector * vT = gsl_vector_calloc(size); 
+	struct constants Const = {
+		.reyn=reyn,.Cmu=0.19,.C1=0.4,.C2=0.3,.Cep1=1.55,.Cep2=1.9,.Ceta=70,.CL=0.3,.sigmaEp=1.3};
+	if (SolveIC(xi,&Const,&grid,data,false) || Solve4f0(xi,&Const,&grid))
+	{
+		cout << "Could not read " << data << endl;
+		return 1;
+	}
+	Fields<double> * F = FieldsAlloc<double>(size);
+	FieldsGather(xi,F);
+
+	double point = TimeCall([&]{
+		for (unsigned int i = 1; i < size; i++)
+		{
+			gsl_vector_set(T,i,ComputeT(xi,&Const,i));
+			gsl_vector_set(L,i,ComputeL(xi,&Const,i));
+			gsl_vector_set(vT,i,ComputeEddyVisc(xi,T,&Const,i));
+		}},0.3);
+	cout << fixed << setprecision(2);
+	cout << "Re " << setw(5) << setprecision(0) << reyn << setprecision(2) << "  point: " << setw(6) << point << " us";
+	termsKernel kernels[3] = {TERMS_SCALAR,TERMS_AVX2,TERMS_AVX512};
+	for (int c = 0; c <= TermsKernelBest(); c++)
+	{
+		double batch = TimeCall([&]{ ComputeTermsBatch(F->k+1,F->ep+1,F->v2+1,F->T+1,F->L+1,
+			F->vT+1,size-1,&Const,kernels[c]); },0.3);
+		cout << "  " << TermsKernelName(kernels[c]) << ": " << setw(5) << batch << " us";
+	}
+	cout << endl;
+
+	FieldsFree(F);
+	gsl_vector_free(xi);
+	gsl_vector_free(T);
+	gsl_vector_free(L);
+	gsl_vector_free(vT);
+	return 0; 
+}
+
+int BenchWorkspace(double reyn, const char * data)
+{
+	Grid grid(false, 1.0, 1.0/reyn);
+	unsigned int n = 5*grid.getSize();
+	gsl_vector * xi = gsl_vector_calloc(n); 
+	gsl_vector * f = gsl_vector_alloc(n); 
+	struct constants Const = {
+		.reyn=reyn,.Cmu=0.19,.C1=0.4,.C2=0.3,.Cep1=1.55,.Cep2=1.9,.Ceta=70,.CL=0.3,.sigmaEp=1.3};
+	if (SolveIC(xi,&Const,&grid,data,false) || Solve4f0(xi,&Const,&grid))
+	{
+		cout << "Could not read " << data << endl;
+		return 1;
+	}
+	Workspace * w = WorkspaceAlloc(n/5+1);
+	struct FParams p = {xi,1.0,&grid,&Const};
+	struct FParams pw = {xi,1.0,&grid,&Const,NULL,w};
+	BlockTridiag * J = BlockTridiagAlloc(n/5);
+	gsl_multiroot_function F = {&SysF,n,&p};
+	gsl_multiroot_function Fw = {&SysF,n,&pw};
+
+	double sysF[2],sysJ[2],ad[2],colored[2];
+	sysF[0] = TimeCall([&]{ SysF(xi,&p,f); },0.3);
+	sysF[1] = TimeCall([&]{ SysF(xi,&pw,f); },0.3);
+	sysJ[0] = TimeCall([&]{ SysJ(xi,&p,J); },0.3);
+	sysJ[1] = TimeCall([&]{ SysJ(xi,&pw,J); },0.3);
+	ad[0] = TimeCall([&]{ ADJacobian(xi,&p,J); },0.3);
+	ad[1] = TimeCall([&]{ ADJacobian(xi,&pw,J); },0.3);
+	colored[0] = TimeCall([&]{ ColoredFDJacobian(&F,xi,NULL,J); },0.3);
+	colored[1] = TimeCall([&]{ ColoredFDJacobian(&Fw,xi,NULL,J,w); },0.3);
+
+	cout << fixed << setprecision(1);
+	cout << "Re " << setw(5) << setprecision(0) << reyn << setprecision(1)
+		<< "  SysF: " << setw(5) << sysF[0] << " -> " << setw(5) << sysF[1]
+		<< "  SysJ: " << setw(5) << sysJ[0] << " -> " << setw(5) << sysJ[1]
+		<< "  AD: " << setw(6) << ad[0] << " -> " << setw(6) << ad[1]
+		<< "  colored: " << setw(6) << colored[0] << " -> " << setw(6) << colored[1] << " us" << endl;
+
+	BlockTridiagFree(J);
+	WorkspaceFree(w);
+	gsl_vector_free(xi);
+	gsl_vector_free(f);
+	return 0; 
+}
+
+int BenchThreads(double reyn, const char * data)
+{
+	Grid grid(false, 1.0, 1.0/reyn);
+	unsigned int n = 5*grid.getSize();
+	gsl_vector * xi = gsl_vector_calloc(n); 
+	gsl_vector * f = gsl_vector_alloc(n); 
+	struct constants Const = {
+		.reyn=reyn,.Cmu=0.19,.C1=0.4,.C2=0.3,.Cep1=1.55,.Cep2=1.9,.Ceta=70,.CL=0.3,.sigmaEp=1.3};
+	if (SolveIC(xi,&Const,&grid,data,false) || Solve4f0(xi,&Const,&grid))
+	{
+		cout << "Could not read " << data << endl;
+		return 1;
+	}
+	Workspace * w = WorkspaceAlloc(n/5+1);
+	struct FParams p = {xi,1.0,&grid,&Const,NULL,w};
+	BlockTridiag * J = BlockTridiagAlloc(n/5);
+	int threads = omp_get_max_threads();
+	double base[3];
+
+	cout << fixed << setprecision(1);
+	cout << "Re " << setw(5) << setprecision(0) << reyn << setprecision(1) << " (" << setw(4) << grid.getSize() << " points)" << endl;
+	for (int t = 1; t <= 8; t *= 2)
+	{
+		omp_set_num_threads(t);
+		double sysF = TimeCall([&]{ SysF(xi,&p,f); },0.3);
+		double sysJ = TimeCall([&]{ SysJ(xi,&p,J); },0.3);
+		double colored = TimeCall([&]{ ColoredFDJacobianThreads(xi,NULL,&p,J); },0.3);
+		if (t == 1)
+		{
+			base[0] = sysF;
+			base[1] = sysJ;
+			base[2] = colored;
+		}
+		cout << "  " << t << " (" << GridThreads(n/5+1) << "): " << setw(7) << sysF << " / " << setw(7) << sysJ
+			<< " / " << setw(7) << colored << " us, speedup " << setprecision(2) << base[0]/sysF << " / "
+			<< base[1]/sysJ << " / " << base[2]/colored << setprecision(1)
+			<< (t > omp_get_num_procs() ? " (more threads than cores)" : "") << endl;
+	}
+	omp_set_num_threads(threads);
+
+	BlockTridiagFree(J);
+	WorkspaceFree(w);
+	gsl_vector_free(xi);
+	gsl_vector_free(f);
+	return 0; 
+}
+
+int main()
+{
+	loglevel = logINFO;
+	cout << "--------------------------------------------------" << endl;
+	cout << "Residual per call: SysResidualByTerm -> SysResidual" << endl; 
+	cout << "--------------------------------------------------" << endl; 
+	BenchResidual(180,"../../data/Reyn_180.dat");
+	BenchResidual(2000,"../../data/Reyn_2000.dat");
+	BenchResidual(5200,"../../data/Reyn_5200.dat");
+	cout << "--------------------------------------------------" << endl;
+	cout << "T, L and vT per pass: point functions, batch kernels" << endl; 
+	cout << "--------------------------------------------------" << endl; 
+	BenchTerms(2000,"../../data/Reyn_2000.dat");
+	BenchTerms(5200,"../../data/Reyn_5200.dat");
+	cout << "--------------------------------------------------" << endl;
+	cout << "Per call: without -> with a workspace" << endl; 
+	cout << "--------------------------------------------------" << endl; 
+	BenchWorkspace(180,"../../data/Reyn_180.dat");
+	BenchWorkspace(5200,"../../data/Reyn_5200.dat");
+	cout << "--------------------------------------------------" << endl;
+	cout << "Strong scaling: SysF / SysJ / colored Jacobian per call with 1, 2, 4, 8 threads (used by SysF)" << endl; 
+	cout << "and the speedup over 1 thread; " << omp_get_num_procs() << " cores" << endl; 
+	cout << "--------------------------------------------------" << endl; 
+	BenchThreads(2000,"../../data/Reyn_2000.dat");
+	BenchThreads(5200,"../../data/Reyn_5200.dat");
+	cout << "--------------------------------------------------" << endl << endl; 
+	return 0;
+}
@@ -4,6 +4,23 @@
 #include"test_systemSolve.h"
 #include"test_setup.h"
 #include "test_finiteDiff.h"
+#include "test_jacobian.h"
+#include "test_blockTridiag.h"
+#include "test_tridiag.h"
+#include "test_jfnk.h"
+#include "test_chordNewton.h"
+#include "test_fdJacobian.h"
+#include "test_adJacobian.h"
+#include "test_timeControl.h"
+#include "test_gridTransfer.h"
+#include "test_multigrid.h"
+#include "test_anderson.h"
+#include "test_segregated.h"
+#include "test_lineSearch.h"
+#include "test_semismooth.h"
+#include "test_fields.h"
+#include "test_workspace.h"
+#include "test_v2fSolver.h"
 using namespace std; 
 
 int test_loglevel();
@@ -21,6 +38,7 @@ int main(int argc,char ** argv)
 	test_remapping();
 	test_first_deriv(150);
 	test_second_deriv(1200);
+	test_stencil_tables();
 
 	ComputeT_test(); 
 	ComputeL_test();
@@ -28,6 +46,8 @@ int main(int argc,char ** argv)
 	ComputeP_test();
 	ComputeEp0_test();
 	Computef0_test();
+	ComputeLocalDt_test();
+	ComputeTermsBatch_test();
 
 	SetUTerms_test(); 
 	SetkTerms_test();
@@ -35,6 +55,42 @@ int main(int argc,char ** argv)
 	Setv2Terms_test();
 	SetFTerms_test();
 	SysF_test();
+	SysResidualFused_test();
+	SysThreads_test();
+	FieldsLayout_test();
+
+	TridiagSolve_test();
+	TridiagSolveCR_test();
+	BlockTridiagSolve_test();
+	BlockTridiagReuse_test();
+	BlockTridiagMixed_test();
+	SysJ_test();
+	SysJ_nonuniform_test();
+	SysJ_localDt_test();
+	ColoredFDJacobian_test();
+	ColoredFDJacobianThreads_test();
+	ADJacobian_test();
+	Workspace_test();
+	GMRES_test();
+	JFNKStep_test();
+	ChordNewtonSecant_test();
+	ChordNewtonPolicy_test();
+	SERTimeControl_test();
+	SteadySwitch_test();
+	GridSize_test();
+	Prolong_test();
+	Restrict_test();
+	FASCycle_test();
+	AndersonLinear_test();
+	AndersonRestart_test();
+	SegregatedStep_test();
+	LineSearchPositivity_test();
+	LineSearchBacktrack_test();
+	SemismoothResidual_test();
+	SemismoothStep_test();
+	V2fSolver_test();
+	Sweep_test();
+	SweepProcesses_test();
 
 	cout << "--------------------------------------------------" << endl << endl; 
 	
@@ -0,0 +1,79 @@
+#include<iostream>
+#include<iomanip>
+#include<math.h>
+#include"../../src/adJacobian.h"
+#include"../../src/jacobian.h"
+using namespace std; 
+
+int ADJacobian_test()
+{
+	Grid grid(false, 1.0, 1.0/180);
+	unsigned int n = 5*grid.getSize();
+	gsl_vector * xi = gsl_vector_calloc(n); 
+	gsl_vector * f = gsl_vector_alloc(n); 
+	struct constants Const = {
+		.reyn=180,.Cmu=0.19,.C1=0.4,.C2=0.3,.Cep1=1.55,.Cep2=1.9,.Ceta=70,.CL=0.3,.sigmaEp=1.3};
+	if (SolveIC(xi,&Const,&grid,"../../data/Reyn_180.dat",false) || Solve4f0(xi,&Const,&grid))
+	{
+		cout << "FAIL: Dual number Jacobian of system (could not read data)" << endl;
+		return 1;
+	}
+	struct FParams p = {xi,0.01,&grid,&Const};
+	BlockTridiag * J = BlockTridiagAlloc(n/5);
+	BlockTridiag * exact = BlockTridiagAlloc(n/5);
+	gsl_matrix * denseJ = gsl_matrix_alloc(n,n);
+	gsl_matrix * denseExact = gsl_matrix_alloc(n,n);
+	DualVector * x = VecTraits<DualVector>::Calloc(n);
+	DualVector * fd = VecTraits<DualVector>::Calloc(n);
+	int status = 0;
+
+	// The residual in dual numbers has to have the same value as SysF.
+	SysF(xi,&p,f);
+	for (unsigned int i = 0; i < n; i++)
+		x->data[i] = gsl_vector_get(xi,i);
+	SysResidual(x,&p,fd);
+	for (unsigned int i = 0; i < n && !status; i++)
+	{
+		if (fabs(fd->data[i].val-gsl_vector_get(f,i)) > 1e-12*fmax(1.0,fabs(gsl_vector_get(f,i))))
+		{
+			cout << "    At Index: " << i << std::endl;
+			cout << "    Expected: " << setprecision(15) << gsl_vector_get(f,i);
+			cout << "    Found: " << fd->data[i].val << std::endl;
+			status = 1;
+		}
+	}
+
+	// The derivatives have to match the analytic Jacobian to round off.
+	ADJacobian(xi,&p,J);
+	SysJ(xi,&p,exact);
+	BlockTridiagToDense(J,denseJ);
+	BlockTridiagToDense(exact,denseExact);
+	for (unsigned int i = 0; i < n && !status; i++)
+		for (unsigned int j = 0; j < n && !status; j++)
+		{
+			double expected = gsl_matrix_get(denseExact,i,j);
+			double found = gsl_matrix_get(denseJ,i,j);
+			if (fabs(expected-found) > 1e-9*fmax(1.0,fabs(expected)))
+			{
+				cout << "    At (" << i << "," << j << ")" << std::endl;
+				cout << "    Expected: " << setprecision(15) << expected;
+				cout << "    Found: " << found << std::endl;
+				status = 1;
+			}
+		}
+	if (status)
+	{
+		cout << "FAIL: Dual number Jacobian of system" << endl;
+		return 1;
+	}
+	cout << "PASS: Dual number Jacobian of system" << endl; 
+	BlockTridiagFree(J);
+	BlockTridiagFree(exact);
+	gsl_matrix_free(denseJ);
+	gsl_matrix_free(denseExact);
+	VecTraits<DualVector>::Free(x);
+	VecTraits<DualVector>::Free(fd);
+	gsl_vector_free(xi);
+	gsl_vector_free(f);
+	return 0; 
+}
@@ -0,0 +1,6 @@
+#ifndef TEST_ADJACOBIAN_H
+#define TEST_ADJACOBIAN_H
+
+int ADJacobian_test();
+
+#endif
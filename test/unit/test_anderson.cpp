@@ -0,0 +1,99 @@
+#include<iostream>
+#include<iomanip>
+#include<math.h>
+#include<gsl/gsl_blas.h>
+#include"../../src/anderson.h"
+using namespace std; 
+
+// G(x) = Mx + c with a lower bidiagonal M, diagonal 0.9 and subdiagonal 0.1, so the plain
+// iteration converges slowly.
+static void LinearMap(const gsl_vector * x, gsl_vector * g)
+{
+	for (unsigned int i = 0; i < x->size; i++)
+	{
+		double v = 0.9*gsl_vector_get(x,i) + 1.0;
+		if (i > 0)
+			v += 0.1*gsl_vector_get(x,i-1);
+		gsl_vector_set(g,i,v);
+	}
+}
+
+// Number of steps to |G(x) - x| < tol from x = 0, with Anderson of depth m (0 = plain).
+static int StepsToConverge(int m, double tol, int maxSteps)
+{
+	const unsigned int n = 6;
+	gsl_vector * x = gsl_vector_calloc(n);
+	gsl_vector * g = gsl_vector_alloc(n);
+	gsl_vector * xMix = gsl_vector_alloc(n);
+	Anderson * aa = (m > 0) ? AndersonAlloc(n,m,2.0) : NULL;
+	int k;
+	for (k = 0; k < maxSteps; k++)
+	{
+		LinearMap(x,g);
+		gsl_vector_sub(x,g);
+		if (gsl_blas_dnrm2(x) < tol)
+			break;
+		gsl_vector_add(x,g);
+		if (aa && AndersonMix(aa,x,g,xMix))
+			gsl_vector_memcpy(x,xMix);
+		else
+			gsl_vector_memcpy(x,g);
+	}
+	if (aa)
+		AndersonFree(aa);
+	gsl_vector_free(x);
+	gsl_vector_free(g);
+	gsl_vector_free(xMix);
+	return k;
+}
+
+int AndersonLinear_test()
+{
+	// On a linear map Anderson with a full history is GMRES, so it converges in about n steps.
+	// With m = 2 the ring buffer wraps around and it still beats the plain iteration.
+	int plain = StepsToConverge(0,1e-10,1000);
+	int full = StepsToConverge(6,1e-10,1000);
+	int wrapped = StepsToConverge(2,1e-10,1000);
+	if (full > 10 || wrapped >= plain)
+	{
+		cout << "FAIL: Anderson acceleration of a linear fixed point iteration" << endl;
+		cout << "    Steps plain: " << plain << " m=6: " << full << " m=2: " << wrapped << endl;
+		return 1;
+	}
+	cout << "PASS: Anderson acceleration of a linear fixed point iteration" << endl; 
+	return 0; 
+}
+
+int AndersonRestart_test()
+{
+	gsl_vector * x = gsl_vector_calloc(2);
+	gsl_vector * g = gsl_vector_alloc(2);
+	gsl_vector * xMix = gsl_vector_alloc(2);
+	Anderson * aa = AndersonAlloc(2,3,2.0);
+	int status = 0;
+
+	// The first step has no history, the second one is mixed.
+	gsl_vector_set_all(g,1.0);
+	status = status || AndersonMix(aa,x,g,xMix) || aa->count != 0;
+	gsl_vector_set_all(x,1.0);
+	gsl_vector_set(g,0,1.5);
+	gsl_vector_set(g,1,1.2);
+	status = status || !AndersonMix(aa,x,g,xMix) || aa->count != 1;
+
+	// A step 10 times larger than the last one clears the history.
+	gsl_vector_set(g,0,6.0);
+	gsl_vector_set(g,1,3.0);
+	status = status || AndersonMix(aa,x,g,xMix) || aa->count != 0 || aa->restartCount != 1;
+
+	AndersonFree(aa);
+	gsl_vector_free(x);
+	gsl_vector_free(g);
+	gsl_vector_free(xMix);
+	if (status)
+	{
+		cout << "FAIL: Anderson acceleration restarts" << endl;
+		return 1;
+	}
+	cout << "PASS: Anderson acceleration restarts" << endl; 
+	return 0; 
+}
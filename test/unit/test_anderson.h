@@ -0,0 +1,7 @@
+#ifndef TEST_ANDERSON_H
+#define TEST_ANDERSON_H
+
+int AndersonLinear_test();
+int AndersonRestart_test();
+
+#endif
@@ -0,0 +1,158 @@
+#include<iostream>
+#include<iomanip>
+#include<math.h>
+#include<gsl/gsl_linalg.h>
+#include"../../src/blockTridiag.h"
+using namespace std; 
+
+// Fill A with a deterministic, nonsymmetric system. The first entry of every 
+// diagonal block is zero, so the solve has to pivot within the blocks. 
+int Setuptest_BT(BlockTridiag * A)
+{
+	for (unsigned int r = 0; r < A->n; r++)
+	{
+		for (int offset = -1; offset <= 1; offset++)
+		{
+			double * block = BlockTridiagBlock(A,r,offset);
+			for (unsigned int e = 0; e < BLOCK_ELEMS; e++)
+				block[e] = sin(1.0 + 3*r + 7*e + 11*offset);
+		}
+		double * D = BlockTridiagBlock(A,r,0);
+		for (unsigned int m = 0; m < BLOCK_SIZE; m++)
+			D[BLOCK_SIZE*m+m] += 6.0;
+		D[0] = 0.0;
+	}
+	return 0; 
+}
+
+// Compare block solve against gsl's dense LU solve. The first mismatch is printed if print is set.
+int CompareDense(BlockTridiag * A, gsl_vector * b, gsl_vector * x, double tol, bool print = true)
+{
+	unsigned int n = BLOCK_SIZE*A->n;
+	gsl_matrix * M = gsl_matrix_alloc(n,n);
+	gsl_vector * trueX = gsl_vector_alloc(n);
+	gsl_permutation * p = gsl_permutation_alloc(n);
+	int s; 
+	int status = 0;
+
+	BlockTridiagToDense(A,M);
+	gsl_linalg_LU_decomp(M,p,&s);
+	gsl_linalg_LU_solve(M,p,b,trueX);
+	for (unsigned int i = 0; i < n; i++)
+	{
+		if (fabs(gsl_vector_get(x,i)-gsl_vector_get(trueX,i)) > tol)
+		{
+			if (print)
+			{
+				cout << "    At Index: " << i << std::endl;
+				cout << "    Expected: " << setprecision(15) << gsl_vector_get(trueX,i);
+				cout << "    Found: " << gsl_vector_get(x,i) << std::endl;
+				cout << "    Tolerance: " << tol << std::endl;
+			}
+			status = 1;
+			break;
+		}
+	}
+	gsl_matrix_free(M);
+	gsl_vector_free(trueX);
+	gsl_permutation_free(p);
+	return status;
+}
+
+int BlockTridiagSolve_test()
+{
+	BlockTridiag * A = BlockTridiagAlloc(7);
+	gsl_vector * b = gsl_vector_alloc(35);
+	gsl_vector * x = gsl_vector_alloc(35);
+	Setuptest_BT(A);
+	for (unsigned int i = 0; i < b->size; i++)
+		gsl_vector_set(b,i,cos(2.0*i));
+	gsl_vector_memcpy(x,b);
+
+	if (BlockTridiagSolve(A,x) || CompareDense(A,b,x,1e-10))
+	{
+		cout << "FAIL: Block tridiagonal solve" << endl;
+		return 1;
+	}
+	cout << "PASS: Block tridiagonal solve" << endl; 
+	BlockTridiagFree(A);
+	gsl_vector_free(b);
+	gsl_vector_free(x);
+	return 0; 
+}
+
+int BlockTridiagReuse_test()
+{
+	BlockTridiag * A = BlockTridiagAlloc(7);
+	BlockTridiagLU * LU = BlockTridiagLUAlloc(7);
+	gsl_vector * b = gsl_vector_alloc(35);
+	gsl_vector * x = gsl_vector_alloc(35);
+	Setuptest_BT(A);
+	BlockTridiagFactor(A,LU);
+
+	// The same factorization is used for several right hand sides.
+	for (unsigned int k = 0; k < 3; k++)
+	{
+		for (unsigned int i = 0; i < b->size; i++)
+			gsl_vector_set(b,i,cos(2.0*i + k));
+		if (BlockTridiagLUSolve(LU,b,x) || CompareDense(A,b,x,1e-10))
+		{
+			cout << "FAIL: Reusing block tridiagonal factorization" << endl;
+			return 1;
+		}
+	}
+	cout << "PASS: Reusing block tridiagonal factorization" << endl; 
+	BlockTridiagFree(A);
+	BlockTridiagLUFree(LU);
+	gsl_vector_free(b);
+	gsl_vector_free(x);
+	return 0; 
+}
+
+int BlockTridiagMixed_test()
+{
+	BlockTridiag * A = BlockTridiagAlloc(7);
+	BlockTridiagLU * LU = BlockTridiagLUAllocSingle(7);
+	gsl_vector * b = gsl_vector_alloc(35);
+	gsl_vector * x = gsl_vector_alloc(35);
+	gsl_vector * r = gsl_vector_alloc(35);
+	Setuptest_BT(A);
+	for (unsigned int i = 0; i < b->size; i++)
+		gsl_vector_set(b,i,cos(2.0*i));
+
+	// A single precision solve alone is only good to about 1e-6, the refined one to double precision.
+	// The mismatch of the first is expected, so it is not printed.
+	int fail = BlockTridiagFactor(A,LU) || BlockTridiagLUSolve(LU,b,x) || !CompareDense(A,b,x,1e-10,false);
+	int iters = BlockTridiagRefinedSolve(A,LU,b,x,r,REFINE_TOL,REFINE_MAX_ITERS);
+	if (fail || iters <= 0 || iters >= REFINE_MAX_ITERS || CompareDense(A,b,x,1e-10))
+		fail = 1;
+
+	// Refinement that cannot reach the tolerance is an error, not a solution: too few
+	// steps, factors of another matrix, and a matrix that is not finite.
+	int fewSteps = BlockTridiagRefinedSolve(A,LU,b,x,r,REFINE_TOL,0);
+	for (unsigned int r = 0; r < A->n; r++)
+		BlockTridiagBlock(A,r,0)[6] += 50.0;
+	int otherFactors = BlockTridiagRefinedSolve(A,LU,b,x,r,REFINE_TOL,REFINE_MAX_ITERS);
+	BlockTridiagBlock(A,3,0)[6] = NAN;
+	int notFinite = BlockTridiagRefinedSolve(A,LU,b,x,r,REFINE_TOL,REFINE_MAX_ITERS);
+	gsl_vector_set(b,0,NAN);
+	int badRhs = BlockTridiagRefinedSolve(A,LU,b,x,r,REFINE_TOL,REFINE_MAX_ITERS);
+	if (fewSteps != REFINE_NOT_CONVERGED || otherFactors != REFINE_NOT_CONVERGED ||
+	    notFinite != REFINE_NOT_CONVERGED || badRhs != -1)
+	{
+		cout << "    Not converged: " << fewSteps << ", " << otherFactors << ", " << notFinite << ", " << badRhs << endl;
+		fail = 1;
+	}
+	if (fail)
+	{
+		cout << "FAIL: Mixed precision block tridiagonal solve" << endl;
+		return 1;
+	}
+	cout << "PASS: Mixed precision block tridiagonal solve" << endl; 
+	BlockTridiagFree(A);
+	BlockTridiagLUFree(LU);
+	gsl_vector_free(b);
+	gsl_vector_free(x);
+	gsl_vector_free(r);
+	return 0; 
+}
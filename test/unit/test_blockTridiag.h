@@ -0,0 +1,8 @@
+#ifndef TEST_BLOCKTRIDIAG_H
+#define TEST_BLOCKTRIDIAG_H
+
+int BlockTridiagSolve_test();
+int BlockTridiagReuse_test();
+int BlockTridiagMixed_test();
+
+#endif
@@ -0,0 +1,111 @@
+#include<iostream>
+#include<iomanip>
+#include<math.h>
+#include"../../src/chordNewton.h"
+using namespace std; 
+
+int CompareVectors(gsl_vector * expected, gsl_vector * found, double tol);
+
+// Initial conditions for Re = 180, as in SysJ_nonuniform_test.
+int Setuptest_CN(gsl_vector * xi, constants * modelConst, Grid * grid)
+{
+	if (SolveIC(xi,modelConst,grid,"../../data/Reyn_180.dat",false) || Solve4f0(xi,modelConst,grid))
+		return 1;
+	return 0;
+}
+
+int ChordNewtonSecant_test()
+{
+	Grid grid(false, 1.0, 1.0/180);
+	unsigned int n = 5*grid.getSize();
+	gsl_vector * xi = gsl_vector_calloc(n); 
+	gsl_vector * x = gsl_vector_alloc(n); 
+	gsl_vector * f = gsl_vector_alloc(n); 
+	gsl_vector * y = gsl_vector_alloc(n); 
+	struct constants Const = {
+		.reyn=180,.Cmu=0.19,.C1=0.4,.C2=0.3,.Cep1=1.55,.Cep2=1.9,.Ceta=70,.CL=0.3,.sigmaEp=1.3};
+	solverOptions solverOpts;
+	solverOpts.jacMaxAge = 5;
+	solverOpts.jacDtChange = 0.2;
+	solverOpts.jacRatio = 0.5;
+	solverOpts.broyden = true;
+	if (Setuptest_CN(xi,&Const,&grid))
+	{
+		cout << "FAIL: Broyden update satisfies secant condition (could not read data)" << endl;
+		return 1;
+	}
+	struct FParams p = {xi,0.01,&grid,&Const};
+	ChordNewton * C = ChordNewtonAlloc(n/5,&solverOpts);
+
+	// After a step, the updated inverse has to map y = F(x+s) - F(x) to s. 
+	gsl_vector_memcpy(x,xi);
+	ChordNewtonStep(x,&p,C,NULL,f);
+	gsl_vector_memcpy(y,f);
+	gsl_vector_sub(y,C->f0);
+	ChordNewtonApply(C,y);
+	if (C->nUpdates != 1 || CompareVectors(C->dx,y,1e-8))
+	{
+		cout << "FAIL: Broyden update satisfies secant condition" << endl;
+		return 1;
+	}
+	cout << "PASS: Broyden update satisfies secant condition" << endl; 
+	ChordNewtonFree(C);
+	gsl_vector_free(xi);
+	gsl_vector_free(x);
+	gsl_vector_free(f);
+	gsl_vector_free(y);
+	return 0; 
+}
+
+int ChordNewtonPolicy_test()
+{
+	Grid grid(false, 1.0, 1.0/180);
+	unsigned int n = 5*grid.getSize();
+	gsl_vector * xi = gsl_vector_calloc(n); 
+	gsl_vector * x = gsl_vector_alloc(n); 
+	gsl_vector * f = gsl_vector_alloc(n); 
+	struct constants Const = {
+		.reyn=180,.Cmu=0.19,.C1=0.4,.C2=0.3,.Cep1=1.55,.Cep2=1.9,.Ceta=70,.CL=0.3,.sigmaEp=1.3};
+	solverOptions solverOpts;
+	solverOpts.jacMaxAge = 3;
+	solverOpts.jacDtChange = 0.2;
+	solverOpts.jacRatio = 1e10;
+	solverOpts.broyden = true;
+	if (Setuptest_CN(xi,&Const,&grid))
+	{
+		cout << "FAIL: Jacobian refactor policy (could not read data)" << endl;
+		return 1;
+	}
+	ChordNewton * C = ChordNewtonAlloc(n/5,&solverOpts);
+
+	// Refactor on the first step, after jac_max_age steps and when deltaT 
+	// changes by more than jac_dt_change. 
+	double deltaT[]   = {1e-3,1e-3,1e-3,1e-3,1.1e-3,2.2e-3};
+	int refactors[]   = {1,1,1,2,2,3};
+	int status = 0;
+	for (unsigned int k = 0; k < 6 && !status; k++)
+	{
+		struct FParams p = {xi,deltaT[k],&grid,&Const};
+		gsl_vector_memcpy(x,xi);
+		ChordNewtonStep(x,&p,C,NULL,f);
+		gsl_vector_memcpy(xi,x);
+		if (C->refactorCount != refactors[k])
+		{
+			cout << "    At step: " << k << std::endl;
+			cout << "    Expected: " << refactors[k];
+			cout << "    Found: " << C->refactorCount << std::endl;
+			status = 1;
+		}
+	}
+	if (status)
+	{
+		cout << "FAIL: Jacobian refactor policy" << endl;
+		return 1;
+	}
+	cout << "PASS: Jacobian refactor policy" << endl; 
+	ChordNewtonFree(C);
+	gsl_vector_free(xi);
+	gsl_vector_free(x);
+	gsl_vector_free(f);
+	return 0; 
+}
@@ -0,0 +1,7 @@
+#ifndef TEST_CHORDNEWTON_H
+#define TEST_CHORDNEWTON_H
+
+int ChordNewtonSecant_test();
+int ChordNewtonPolicy_test();
+
+#endif
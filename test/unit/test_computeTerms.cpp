@@ -280,3 +280,94 @@ int ReConstructXi_test()
 
 }
 */
+
+int ComputeLocalDt_test()
+{
+	Grid grid(false, 1.0, 1.0/180);
+	unsigned int n = 5*grid.getSize();
+	gsl_vector * xi = gsl_vector_calloc(n); 
+	gsl_vector * dt = gsl_vector_alloc(n); 
+	struct constants Const = {
+		.reyn=180,.Cmu=0.19,.C1=0.4,.C2=0.3,.Cep1=1.55,.Cep2=1.9,.Ceta=70,.CL=0.3,.sigmaEp=1.3};
+	if (SolveIC(xi,&Const,&grid,"../../data/Reyn_180.dat",false) || Solve4f0(xi,&Const,&grid))
+	{
+		cout << "FAIL: Compute local time scales (could not read data)" << endl;
+		return 1;
+	}
+	ComputeLocalDt(xi,&Const,&grid,dt);
+
+	// Scaled to at most 1, positive, and smallest at the wall for every equation.
+	int fail = !(fabs(gsl_vector_max(dt) - 1.0) < 1e-15) || !(gsl_vector_min(dt) > 0.0);
+	for (unsigned int m = 0; m < 5; m++)
+		if (!(gsl_vector_get(dt,m) < gsl_vector_get(dt,n-5+m)))
+			fail = 1;
+	gsl_vector_free(xi);
+	gsl_vector_free(dt);
+	if (fail)
+	{
+		cout << "FAIL: Compute local time scales" << endl;
+		return 1;
+	}
+	cout << "PASS: Compute local time scales" << endl; 
+	return 0; 
+}
+
+int ComputeTermsBatch_test()
+{
+	// Odd length so the vector kernels also run their scalar tails. Some points are below the
+	// limits of k, ep and v2.
+	const unsigned int n = 37;
+	gsl_vector * xi = gsl_vector_calloc(5*n); 
+	gsl_vector * Tvec = gsl_vector_calloc(n+1); 
+	double k[n],ep[n],v2[n],T[n],L[n],vT[n];
+	struct constants Const = {
+		.reyn=2000,.Cmu=0.19,.C1=0.4,.C2=0.3,.Cep1=1.55,.Cep2=1.9,.Ceta=70,.CL=0.3,.sigmaEp=1.3};
+	for (unsigned int j = 0; j < n; j++)
+	{
+		k[j] = (j%7 == 3) ? -1e-9 : 4.0*pow(sin(0.3*j),2);
+		ep[j] = (j%11 == 5) ? 0.0 : 0.2*exp(-0.15*j) + 1e-6;
+		v2[j] = (j%5 == 2) ? -1e-14 : 0.4*k[j];
+		gsl_vector_set(xi,5*j+1,k[j]);
+		gsl_vector_set(xi,5*j+2,ep[j]);
+		gsl_vector_set(xi,5*j+3,v2[j]);
+	}
+
+	// Every kernel gives the same bits as the point functions.
+	int fail = 0;
+	termsKernel kernels[3] = {TERMS_SCALAR,TERMS_AVX2,TERMS_AVX512};
+	for (int c = 0; c < 3; c++)
+	{
+		fail |= ComputeTermsBatch(k,ep,v2,T,L,vT,n,&Const,kernels[c]);
+		for (unsigned int j = 0; j < n; j++)
+		{
+			gsl_vector_set(Tvec,j+1,ComputeT(xi,&Const,j+1));
+			if (T[j] != gsl_vector_get(Tvec,j+1) || L[j] != ComputeL(xi,&Const,j+1) ||
+			    vT[j] != ComputeEddyVisc(xi,Tvec,&Const,j+1))
+			{
+				cout << "    Kernel " << TermsKernelName(kernels[c]) << " at " << j << endl;
+				fail = 1;
+			}
+		}
+	}
+
+	// A term that is not finite is reported by every kernel.
+	k[n-1] = INFINITY;
+	for (int c = 0; c < 3; c++)
+		if (!ComputeTermsBatch(k,ep,v2,T,L,vT,n,&Const,kernels[c]))
+			fail = 1;
+	k[n-1] = 1.0;
+	k[0] = INFINITY;
+	for (int c = 0; c < 3; c++)
+		if (!ComputeTermsBatch(k,ep,v2,T,L,vT,n,&Const,kernels[c]))
+			fail = 1;
+
+	gsl_vector_free(xi);
+	gsl_vector_free(Tvec);
+	if (fail)
+	{
+		cout << "FAIL: Batch T, L and vT (" << TermsKernelName(TermsKernelBest()) << ")" << endl;
+		return 1;
+	}
+	cout << "PASS: Batch T, L and vT" << endl; 
+	return 0; 
+}
@@ -11,5 +11,7 @@ int ComputeEp0_test();
 int Computef0_test();
 int Setuptest(gsl_vector * xi,constants * modelConst);
 int ComputeP_test();
+int ComputeLocalDt_test();
+int ComputeTermsBatch_test();
 
 #endif
@@ -0,0 +1,157 @@
+#include<iostream>
+#include<iomanip>
+#include<math.h>
+#include<gsl/gsl_math.h>
+#include<omp.h>
+#include"../../src/fdJacobian.h"
+#include"../../src/jacobian.h"
+#include"../../src/workspace.h"
+using namespace std; 
+
+static int fCalls = 0;
+
+// SysF, counting the number of calls.
+int CountingSysF(const gsl_vector * xi, void * p, gsl_vector * sysF)
+{
+	fCalls++;
+	return SysF(xi,p,sysF);
+}
+
+int ColoredFDJacobian_test()
+{
+	Grid grid(false, 1.0, 1.0/180);
+	unsigned int n = 5*grid.getSize();
+	gsl_vector * xi = gsl_vector_calloc(n); 
+	gsl_vector * x = gsl_vector_alloc(n); 
+	gsl_vector * f0 = gsl_vector_alloc(n); 
+	gsl_vector * f1 = gsl_vector_alloc(n); 
+	struct constants Const = {
+		.reyn=180,.Cmu=0.19,.C1=0.4,.C2=0.3,.Cep1=1.55,.Cep2=1.9,.Ceta=70,.CL=0.3,.sigmaEp=1.3};
+	if (SolveIC(xi,&Const,&grid,"../../data/Reyn_180.dat",false) || Solve4f0(xi,&Const,&grid))
+	{
+		cout << "FAIL: Colored finite difference Jacobian (could not read data)" << endl;
+		return 1;
+	}
+	struct FParams p = {xi,0.01,&grid,&Const};
+	BlockTridiag * J = BlockTridiagAlloc(n/5);
+	BlockTridiag * exact = BlockTridiagAlloc(n/5);
+	gsl_matrix * denseJ = gsl_matrix_alloc(n,n);
+	gsl_matrix * denseExact = gsl_matrix_alloc(n,n);
+	gsl_multiroot_function F = {&CountingSysF,n,&p};
+	int status = 0;
+
+	if (ColoredFDJacobian(&F,xi,NULL,J) || fCalls != FD_COLORS+1)
+	{
+		cout << "    Residual calls: " << fCalls << std::endl;
+		cout << "FAIL: Colored finite difference Jacobian" << endl;
+		return 1;
+	}
+	BlockTridiagToDense(J,denseJ);
+	SysJ(xi,&p,exact);
+	BlockTridiagToDense(exact,denseExact);
+
+	// Every column has to match perturbing that unknown alone, and be close to SysJ.
+	SysF(xi,&p,f0);
+	for (unsigned int j = 0; j < n && !status; j++)
+	{
+		double h = GSL_SQRT_DBL_EPSILON*fmax(fabs(gsl_vector_get(xi,j)),1.0);
+		gsl_vector_memcpy(x,xi);
+		gsl_vector_set(x,j,gsl_vector_get(xi,j)+h);
+		SysF(x,&p,f1);
+		for (unsigned int i = 0; i < n; i++)
+		{
+			double fd = (gsl_vector_get(f1,i)-gsl_vector_get(f0,i))/h;
+			double found = gsl_matrix_get(denseJ,i,j);
+			double scale = fmax(1.0,fabs(gsl_matrix_get(denseExact,i,j)));
+			if (fabs(fd-found) > 1e-10*fmax(1.0,fabs(fd)) || fabs(gsl_matrix_get(denseExact,i,j)-found) > 1e-4*scale)
+			{
+				cout << "    At (" << i << "," << j << ")" << std::endl;
+				cout << "    Expected: " << setprecision(15) << fd << " (analytic " << gsl_matrix_get(denseExact,i,j) << ")";
+				cout << "    Found: " << found << std::endl;
+				status = 1;
+				break;
+			}
+		}
+	}
+	if (status)
+	{
+		cout << "FAIL: Colored finite difference Jacobian" << endl;
+		return 1;
+	}
+	cout << "PASS: Colored finite difference Jacobian" << endl; 
+	BlockTridiagFree(J);
+	BlockTridiagFree(exact);
+	gsl_matrix_free(denseJ);
+	gsl_matrix_free(denseExact);
+	gsl_vector_free(xi);
+	gsl_vector_free(x);
+	gsl_vector_free(f0);
+	gsl_vector_free(f1);
+	return 0; 
+}
+
+int ColoredFDJacobianThreads_test()
+{
+	Grid grid(false, 1.0, 1.0/2000);
+	unsigned int n = 5*grid.getSize();
+	gsl_vector * xi = gsl_vector_calloc(n); 
+	struct constants Const = {
+		.reyn=2000,.Cmu=0.19,.C1=0.4,.C2=0.3,.Cep1=1.55,.Cep2=1.9,.Ceta=70,.CL=0.3,.sigmaEp=1.3};
+	if (SolveIC(xi,&Const,&grid,"../../data/Reyn_2000.dat",false) || Solve4f0(xi,&Const,&grid))
+	{
+		cout << "FAIL: Colored Jacobian on threads (could not read data)" << endl;
+		return 1;
+	}
+	Workspace * w = WorkspaceAlloc(n/5+1);
+	struct FParams p = {xi,0.01,&grid,&Const};
+	struct FParams pw = {xi,0.01,&grid,&Const,NULL,w};
+	BlockTridiag * serial = BlockTridiagAlloc(n/5);
+	BlockTridiag * J = BlockTridiagAlloc(n/5);
+	gsl_multiroot_function F = {&SysF,n,&p};
+	int threads = omp_get_max_threads();
+	int status = ColoredFDJacobian(&F,xi,NULL,serial);
+
+	// The same bits as the serial Jacobian for any number of threads, with or without a
+	// workspace, and once the thread workspaces exist no allocations.
+	for (int t = 1; t <= 5 && !status; t++)
+	{
+		omp_set_num_threads(t);
+		for (int k = 0; k < 3 && !status; k++)
+		{
+			unsigned long before = WorkspaceAllocCount();
+			status = ColoredFDJacobianThreads(xi,NULL,k ? &pw : &p,J);
+#ifdef DEBUG_ALLOC
+			if (k == 2 && WorkspaceAllocCount() != before)
+			{
+				cout << "    Allocations with " << t << " threads: " << WorkspaceAllocCount()-before << endl;
+				status = 1;
+			}
+#endif
+			for (unsigned int r = 0; r < n/5; r++)
+				for (int offset = -1; offset <= 1; offset++)
+				{
+					if ((int)r+offset < 0 || r+offset >= n/5)
+						continue;
+					double * a = BlockTridiagBlock(J,r,offset), * b = BlockTridiagBlock(serial,r,offset);
+					for (int m = 0; m < BLOCK_SIZE*BLOCK_SIZE; m++)
+						if (a[m] != b[m])
+							status = 1;
+				}
+			if (status)
+				cout << "    Differs with " << t << " threads" << endl;
+		}
+	}
+	omp_set_num_threads(threads);
+
+	if (status)
+	{
+		cout << "FAIL: Colored Jacobian on threads" << endl;
+		return 1;
+	}
+	cout << "PASS: Colored Jacobian on threads" << endl; 
+	BlockTridiagFree(serial);
+	BlockTridiagFree(J);
+	WorkspaceFree(w);
+	gsl_vector_free(xi);
+	return 0; 
+}
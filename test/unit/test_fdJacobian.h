@@ -0,0 +1,7 @@
+#ifndef TEST_FDJACOBIAN_H
+#define TEST_FDJACOBIAN_H
+
+int ColoredFDJacobian_test();
+int ColoredFDJacobianThreads_test();
+
+#endif
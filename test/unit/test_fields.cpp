@@ -0,0 +1,56 @@
+#include<iostream>
+#include<stdint.h>
+#include<math.h>
+#include"../../src/fields.h"
+using namespace std; 
+
+int FieldsLayout_test()
+{
+	unsigned int size = 11;
+	gsl_vector * xi = gsl_vector_alloc(5*(size-1)); 
+	gsl_vector * back = gsl_vector_calloc(5*(size-1)); 
+	for (unsigned int j = 0; j < xi->size; j++)
+		gsl_vector_set(xi,j,1.0+j);
+	Fields<double> * F = FieldsAlloc<double>(size);
+	Fields<JacDual> * D = FieldsAlloc<JacDual>(size);
+	int status = 0;
+
+	// Every array starts on a cache line and has room for the wall, the points and the ghost.
+	for (int m = 0; m < FIELDS_VARS; m++)
+		if ((uintptr_t)FieldsVar(F,m) % FIELDS_ALIGN || (uintptr_t)FieldsVar(D,m) % FIELDS_ALIGN)
+			status = 1;
+	if ((uintptr_t)F->vT % FIELDS_ALIGN || F->stride < size+1 || D->stride < size+1)
+		status = 1;
+
+	// Gather and scatter are inverses on points 1 ... size-1.
+	FieldsGather(xi,F);
+	if (F->k[1] != 2.0 || F->f[size-1] != 5.0*(size-1))
+		status = 1;
+	FieldsScatter(F,back);
+	for (unsigned int j = 0; j < xi->size; j++)
+		if (gsl_vector_get(back,j) != gsl_vector_get(xi,j))
+			status = 1;
+
+	// Wall values at 0 and the centerline mirrored into the ghost.
+	F->vT[size-2] = 3.0;
+	FieldsSetGhosts(F,7.0,-8.0);
+	if (F->U[0] != 0 || F->k[0] != 0 || F->ep[0] != 7.0 || F->v2[0] != 0 || F->f[0] != -8.0)
+		status = 1;
+	for (int m = 0; m < FIELDS_VARS; m++)
+		if (FieldsVar(F,m)[size] != FieldsVar(F,m)[size-2])
+			status = 1;
+	if (F->vT[size] != 3.0)
+		status = 1;
+
+	if (status)
+	{
+		cout << "FAIL: Field arrays with ghost cells" << endl;
+		return 1;
+	}
+	cout << "PASS: Field arrays with ghost cells" << endl; 
+	FieldsFree(F);
+	FieldsFree(D);
+	gsl_vector_free(xi);
+	gsl_vector_free(back);
+	return 0; 
+}
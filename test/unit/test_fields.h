@@ -0,0 +1,6 @@
+#ifndef TEST_FIELDS_H
+#define TEST_FIELDS_H
+
+int FieldsLayout_test();
+
+#endif
@@ -90,3 +90,43 @@ int test_second_deriv(int n) {
   std::cout << "PASS: Second derivative on nonuniform grid" << std::endl;
   return 0;
 }
+
+int test_stencil_tables() {
+  // SETUP
+  Grid grid(false, 1.0, 1.0/180);
+  unsigned int n = grid.getSize();
+  double delta = gsl_vector_get(grid.chi, 0);
+
+  // ASSERT
+  // The tables hold the chain rule coefficients of the mapping at each point...
+  double tol = 1e-12;
+  for (unsigned int i = 0; i < n-1; i++) {
+    double a1 = grid.dChidY(gsl_vector_get(grid.chi, i));
+    double a2 = grid.d2ChidY2(gsl_vector_get(grid.chi, i));
+    double expected[5] = {-a1/(2*delta), a1/(2*delta), a1*a1/(delta*delta) - a2/(2*delta),
+                          -2*a1*a1/(delta*delta), a1*a1/(delta*delta) + a2/(2*delta)};
+    double found[5] = {grid.deriv1Lower[i], grid.deriv1Upper[i], grid.deriv2Lower[i],
+                       grid.deriv2Center[i], grid.deriv2Upper[i]};
+    for (int c = 0; c < 5; c++) {
+      if (std::abs(found[c] - expected[c]) > tol*std::abs(expected[c])) {
+        std::cout << "FAIL: Stencil tables of the grid" << std::endl;
+        std::cout << "    At point " << i << ", coefficient " << c << std::endl;
+        std::cout << "    Expected: " << expected[c] << "   Found: " << found[c] << std::endl;
+        return 1;
+      }
+    }
+    if (grid.metric1[i] != a1 || grid.metric2[i] != a2) {
+      std::cout << "FAIL: Stencil tables of the grid (metrics)" << std::endl;
+      return 1;
+    }
+  }
+
+  // ...and the zero Neumann condition at the centerline.
+  if (grid.deriv1Lower[n-1] != 0 || grid.deriv1Upper[n-1] != 0 || grid.deriv2Upper[n-1] != 0 ||
+      grid.deriv2Lower[n-1] != 2/(delta*delta) || grid.deriv2Center[n-1] != -2/(delta*delta)) {
+    std::cout << "FAIL: Stencil tables of the grid (centerline)" << std::endl;
+    return 1;
+  }
+  std::cout << "PASS: Stencil tables of the grid" << std::endl;
+  return 0;
+}
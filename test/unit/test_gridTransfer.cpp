@@ -0,0 +1,81 @@
+#include<iostream>
+#include<iomanip>
+#include<math.h>
+#include"../../src/gridTransfer.h"
+using namespace std; 
+
+int CompareVectors(gsl_vector * expected, gsl_vector * found, double tol);
+
+int GridSize_test()
+{
+	// A grid built from its size has the same points as one built from delta_v. 
+	Grid grid(false, 1.0, 1.0/180);
+	Grid sized(false, 1.0, GridSize(grid.getSize()));
+	if (sized.getSize() != grid.getSize() || CompareVectors(grid.y,sized.y,1e-15))
+	{
+		cout << "FAIL: Grid with a given number of points" << endl;
+		return 1;
+	}
+	cout << "PASS: Grid with a given number of points" << endl; 
+	return 0; 
+}
+
+int Prolong_test()
+{
+	Grid coarse(false, 1.0, GridSize(12));
+	Grid fine(false, 1.0, GridSize(23));
+	gsl_vector * xc = gsl_vector_alloc(5*coarse.getSize());
+	gsl_vector * xf = gsl_vector_alloc(5*fine.getSize());
+	gsl_vector * expected = gsl_vector_alloc(5*fine.getSize());
+	gsl_vector * same = gsl_vector_alloc(5*coarse.getSize());
+	struct constants Const = {
+		.reyn=180,.Cmu=0.19,.C1=0.4,.C2=0.3,.Cep1=1.55,.Cep2=1.9,.Ceta=70,.CL=0.3,.sigmaEp=1.3};
+
+	// Profiles that are linear in y and zero at the wall are prolonged exactly. 
+	for (unsigned int i = 0; i < coarse.getSize(); i++)
+	{
+		double y = gsl_vector_get(coarse.y,i);
+		gsl_vector_set(xc,5*i,2*y);
+		gsl_vector_set(xc,5*i+1,3*y);
+		gsl_vector_set(xc,5*i+2,1+y);
+		gsl_vector_set(xc,5*i+3,y);
+		gsl_vector_set(xc,5*i+4,-y);
+	}
+	int status = Prolong(xc,&coarse,xf,&fine,&Const);
+	for (unsigned int i = 0; i < fine.getSize(); i++)
+	{
+		double y = gsl_vector_get(fine.y,i);
+		gsl_vector_set(expected,5*i,2*y);
+		gsl_vector_set(expected,5*i+1,3*y);
+		gsl_vector_set(expected,5*i+3,y);
+		// ep and f use the wall values below the first coarse point. 
+		gsl_vector_set(expected,5*i+2,gsl_vector_get(xf,5*i+2));
+		gsl_vector_set(expected,5*i+4,gsl_vector_get(xf,5*i+4));
+		if (y >= gsl_vector_get(coarse.y,0))
+		{
+			gsl_vector_set(expected,5*i+2,1+y);
+			gsl_vector_set(expected,5*i+4,-y);
+		}
+	}
+	if (status || CompareVectors(expected,xf,1e-12))
+	{
+		cout << "FAIL: Prolongation to a finer grid" << endl;
+		gsl_vector_free(xc); gsl_vector_free(xf); gsl_vector_free(expected); gsl_vector_free(same);
+		return 1;
+	}
+
+	// Onto the same grid, prolongation is the identity. 
+	status = Prolong(xc,&coarse,same,&coarse,&Const);
+	if (status || CompareVectors(xc,same,1e-15))
+	{
+		cout << "FAIL: Prolongation to a finer grid (same grid)" << endl;
+		gsl_vector_free(xc); gsl_vector_free(xf); gsl_vector_free(expected); gsl_vector_free(same);
+		return 1;
+	}
+	cout << "PASS: Prolongation to a finer grid" << endl; 
+	gsl_vector_free(xc);
+	gsl_vector_free(xf);
+	gsl_vector_free(expected);
+	gsl_vector_free(same);
+	return 0; 
+}
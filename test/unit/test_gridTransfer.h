@@ -0,0 +1,7 @@
+#ifndef TEST_GRIDTRANSFER_H
+#define TEST_GRIDTRANSFER_H
+
+int GridSize_test();
+int Prolong_test();
+
+#endif
@@ -0,0 +1,131 @@
+#include<iostream>
+#include<iomanip>
+#include<math.h>
+#include"../../src/jacobian.h"
+#include"../../src/computeTerms.h"
+#include"test_systemSolve.h"
+using namespace std; 
+
+// Compare SysJ to a centered finite difference approximation of SysF.
+int CompareJacobian(gsl_vector * xi, FParams * params, double tol)
+{
+	unsigned int n = xi->size;
+	BlockTridiag * J = BlockTridiagAlloc(n/5);
+	gsl_matrix * denseJ = gsl_matrix_alloc(n,n);
+	gsl_vector * x = gsl_vector_alloc(n);
+	gsl_vector * Fp = gsl_vector_alloc(n);
+	gsl_vector * Fm = gsl_vector_alloc(n);
+	int status = 0;
+
+	SysJ(xi,params,J);
+	BlockTridiagToDense(J,denseJ);
+	for (unsigned int j = 0; j < n && !status; j++)
+	{
+		double h = 1e-6*fmax(1.0,fabs(gsl_vector_get(xi,j)));
+		gsl_vector_memcpy(x,xi);
+		gsl_vector_set(x,j,gsl_vector_get(xi,j)+h);
+		SysF(x,params,Fp);
+		gsl_vector_set(x,j,gsl_vector_get(xi,j)-h);
+		SysF(x,params,Fm);
+		for (unsigned int i = 0; i < n; i++)
+		{
+			double fd = (gsl_vector_get(Fp,i)-gsl_vector_get(Fm,i))/(2*h);
+			double exact = gsl_matrix_get(denseJ,i,j);
+			if (fabs(fd-exact) > tol*fmax(1.0,fabs(fd)))
+			{
+				cout << "    At (" << i << "," << j << ")" << std::endl;
+				cout << "    Expected: " << setprecision(15) << fd;
+				cout << "    Found: " << exact << std::endl;
+				cout << "    Tolerance: " << tol << std::endl;
+				status = 1;
+				break;
+			}
+		}
+	}
+
+	BlockTridiagFree(J);
+	gsl_matrix_free(denseJ);
+	gsl_vector_free(x);
+	gsl_vector_free(Fp);
+	gsl_vector_free(Fm);
+	return status;
+}
+
+int SysJ_test()
+{
+	Grid grid(true, 1.5, 0.5);
+	gsl_vector * xi = gsl_vector_alloc(15); 
+	gsl_vector * xiN = gsl_vector_alloc(15); 
+	struct constants Const = {
+		.reyn=0,.Cmu=0,.C1=0,.C2=0,.Cep1=0,.Cep2=0,.Ceta=0,.CL=0,.sigmaEp=0};
+	constants * modelConst= &Const;  
+	struct FParams p = {xiN,1.0,&grid,modelConst};
+	FParams * params = &p; 
+	Setuptest_SS(xi,params); 
+
+	if (CompareJacobian(xi,params,1e-6))
+	{
+		cout << "FAIL: Analytic Jacobian of system" << endl;
+		return 1;
+	}
+	cout << "PASS: Analytic Jacobian of system" << endl; 
+	gsl_vector_free(xi);
+	gsl_vector_free(xiN);
+	return 0; 
+}
+
+int SysJ_nonuniform_test()
+{
+	Grid grid(false, 1.0, 1.0/180);
+	gsl_vector * xi = gsl_vector_calloc(5*grid.getSize()); 
+	struct constants Const = {
+		.reyn=180,.Cmu=0.19,.C1=0.4,.C2=0.3,.Cep1=1.55,.Cep2=1.9,.Ceta=70,.CL=0.3,.sigmaEp=1.3};
+	constants * modelConst= &Const;  
+
+	if (SolveIC(xi,modelConst,&grid,"../../data/Reyn_180.dat",false) || Solve4f0(xi,modelConst,&grid))
+	{
+		cout << "FAIL: Analytic Jacobian on nonuniform grid (could not read data)" << endl;
+		return 1;
+	}
+	struct FParams p = {xi,0.01,&grid,modelConst};
+	FParams * params = &p; 
+
+	if (CompareJacobian(xi,params,1e-5))
+	{
+		cout << "FAIL: Analytic Jacobian on nonuniform grid" << endl;
+		return 1;
+	}
+	cout << "PASS: Analytic Jacobian on nonuniform grid" << endl; 
+	gsl_vector_free(xi);
+	return 0; 
+}
+
+int SysJ_localDt_test()
+{
+	Grid grid(false, 1.0, 1.0/180);
+	gsl_vector * xi = gsl_vector_calloc(5*grid.getSize()); 
+	gsl_vector * localDt = gsl_vector_alloc(5*grid.getSize()); 
+	struct constants Const = {
+		.reyn=180,.Cmu=0.19,.C1=0.4,.C2=0.3,.Cep1=1.55,.Cep2=1.9,.Ceta=70,.CL=0.3,.sigmaEp=1.3};
+	constants * modelConst= &Const;  
+
+	if (SolveIC(xi,modelConst,&grid,"../../data/Reyn_180.dat",false) || Solve4f0(xi,modelConst,&grid))
+	{
+		cout << "FAIL: Analytic Jacobian with local time steps (could not read data)" << endl;
+		return 1;
+	}
+	ComputeLocalDt(xi,modelConst,&grid,localDt);
+	struct FParams p = {xi,0.01,&grid,modelConst,localDt};
+	FParams * params = &p; 
+
+	int fail = CompareJacobian(xi,params,1e-5);
+	gsl_vector_free(xi);
+	gsl_vector_free(localDt);
+	if (fail)
+	{
+		cout << "FAIL: Analytic Jacobian with local time steps" << endl;
+		return 1;
+	}
+	cout << "PASS: Analytic Jacobian with local time steps" << endl; 
+	return 0; 
+}
@@ -0,0 +1,8 @@
+#ifndef TEST_JACOBIAN_H
+#define TEST_JACOBIAN_H
+
+int SysJ_test();
+int SysJ_nonuniform_test();
+int SysJ_localDt_test();
+
+#endif
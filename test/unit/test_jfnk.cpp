@@ -0,0 +1,151 @@
+#include<iostream>
+#include<iomanip>
+#include<math.h>
+#include<gsl/gsl_blas.h>
+#include"../../src/jfnk.h"
+#include"../../src/jacobian.h"
+#include"../../src/setup.h"
+using namespace std; 
+
+int Setuptest_BT(BlockTridiag * A);
+
+// y = A*v for a dense matrix A.
+int DenseOp(const gsl_vector * v, void * p, gsl_vector * Av)
+{
+	gsl_matrix * A = (gsl_matrix *)p;
+	for (unsigned int i = 0; i < A->size1; i++)
+	{
+		double val = 0.0;
+		for (unsigned int j = 0; j < A->size2; j++)
+			val += gsl_matrix_get(A,i,j)*gsl_vector_get(v,j);
+		gsl_vector_set(Av,i,val);
+	}
+	return 0;
+}
+
+// DenseOp that fails from its calls-th call on.
+struct FailingOpParams {
+	gsl_matrix * A;
+	int calls;
+};
+
+int FailingOp(const gsl_vector * v, void * p, gsl_vector * Av)
+{
+	struct FailingOpParams * fp = (struct FailingOpParams *)p;
+	if (--fp->calls <= 0)
+		return 1;
+	return DenseOp(v,fp->A,Av);
+}
+
+int CompareVectors(gsl_vector * expected, gsl_vector * found, double tol)
+{
+	for (unsigned int i = 0; i < expected->size; i++)
+	{
+		if (fabs(gsl_vector_get(expected,i)-gsl_vector_get(found,i)) > tol*fmax(1.0,fabs(gsl_vector_get(expected,i))))
+		{
+			cout << "    At Index: " << i << std::endl;
+			cout << "    Expected: " << setprecision(15) << gsl_vector_get(expected,i);
+			cout << "    Found: " << gsl_vector_get(found,i) << std::endl;
+			cout << "    Tolerance: " << tol << std::endl;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+int GMRES_test()
+{
+	BlockTridiag * A = BlockTridiagAlloc(7);
+	gsl_matrix * denseA = gsl_matrix_alloc(35,35);
+	gsl_vector * b = gsl_vector_alloc(35);
+	gsl_vector * x = gsl_vector_calloc(35);
+	gsl_vector * trueX = gsl_vector_alloc(35);
+	int iters;
+	Setuptest_BT(A);
+	BlockTridiagToDense(A,denseA);
+	for (unsigned int i = 0; i < b->size; i++)
+		gsl_vector_set(b,i,cos(2.0*i));
+	gsl_vector_memcpy(trueX,b);
+	BlockTridiagSolve(A,trueX);
+
+	// Restart well before the Krylov space is complete, with no preconditioner.
+	if (GMRES(&DenseOp,denseA,NULL,NULL,b,x,10,1000,1e-12,&iters) || CompareVectors(trueX,x,1e-9))
+	{
+		cout << "FAIL: Restarted GMRES" << endl;
+		return 1;
+	}
+
+	// An operator that fails within the first cycle stops GMRES with x unchanged.
+	struct FailingOpParams fp = {denseA,5};
+	gsl_vector_set_zero(x);
+	int status = GMRES(&FailingOp,&fp,NULL,NULL,b,x,10,1000,1e-12,&iters);
+	if (status != GMRES_OP_FAILED || iters != 4 || gsl_blas_dnrm2(x) != 0.0)
+	{
+		cout << "FAIL: Restarted GMRES (failing operator, status " << status << ", " << iters << " iterations)" << endl;
+		return 1;
+	}
+	cout << "PASS: Restarted GMRES" << endl; 
+	BlockTridiagFree(A);
+	gsl_matrix_free(denseA);
+	gsl_vector_free(b);
+	gsl_vector_free(x);
+	gsl_vector_free(trueX);
+	return 0; 
+}
+
+int JFNKStep_test()
+{
+	Grid grid(false, 1.0, 1.0/180);
+	unsigned int n = 5*grid.getSize();
+	gsl_vector * xi = gsl_vector_calloc(n); 
+	struct constants Const = {
+		.reyn=180,.Cmu=0.19,.C1=0.4,.C2=0.3,.Cep1=1.55,.Cep2=1.9,.Ceta=70,.CL=0.3,.sigmaEp=1.3};
+	constants * modelConst= &Const;  
+
+	if (SolveIC(xi,modelConst,&grid,"../../data/Reyn_180.dat",false) || Solve4f0(xi,modelConst,&grid))
+	{
+		cout << "FAIL: Jacobian-free Newton-Krylov step (could not read data)" << endl;
+		return 1;
+	}
+	struct FParams p = {xi,0.01,&grid,modelConst};
+	FParams * params = &p; 
+	solverOptions solverOpts;
+	solverOpts.solver = "jfnk";
+	solverOpts.gmresRestart = 30;
+	solverOpts.gmresMaxIter = 300;
+	solverOpts.gmresTol = 1e-10;
+
+	// Newton step with the analytic Jacobian: x = xi - J^{-1}F(xi)
+	BlockTridiag * J = BlockTridiagAlloc(n/5);
+	gsl_vector * newton = gsl_vector_alloc(n);
+	gsl_vector * x = gsl_vector_alloc(n);
+	gsl_vector * f = gsl_vector_alloc(n);
+	SysF(xi,params,newton);
+	SysJ(xi,params,J);
+	BlockTridiagSolve(J,newton);
+	gsl_vector_scale(newton,-1.0);
+	gsl_vector_add(newton,xi);
+
+	const char * types[] = {"none","blockjacobi","blocktridiag"};
+	for (unsigned int t = 0; t < 3; t++)
+	{
+		JFNKPrecond * M = JFNKPrecondAlloc(types[t],n/5);
+		solverOpts.precond = types[t];
+		gsl_vector_memcpy(x,xi);
+		int status = JFNKStep(x,params,M,&solverOpts,NULL,f);
+		JFNKPrecondFree(M);
+		if (status || CompareVectors(newton,x,1e-5))
+		{
+			cout << "    Preconditioner: " << types[t] << std::endl;
+			cout << "FAIL: Jacobian-free Newton-Krylov step" << endl;
+			return 1;
+		}
+	}
+	cout << "PASS: Jacobian-free Newton-Krylov step" << endl; 
+	BlockTridiagFree(J);
+	gsl_vector_free(xi);
+	gsl_vector_free(newton);
+	gsl_vector_free(x);
+	gsl_vector_free(f);
+	return 0; 
+}
@@ -0,0 +1,7 @@
+#ifndef TEST_JFNK_H
+#define TEST_JFNK_H
+
+int GMRES_test();
+int JFNKStep_test();
+
+#endif
@@ -0,0 +1,150 @@
+#include<iostream>
+#include<iomanip>
+#include<math.h>
+#include<gsl/gsl_blas.h>
+#include"../../src/lineSearch.h"
+#include"../../src/computeTerms.h"
+using namespace std; 
+
+static int ReadIC(gsl_vector * xi, constants * Const, Grid * grid)
+{
+	return SolveIC(xi,Const,grid,"../../data/Reyn_180.dat",false) || Solve4f0(xi,Const,grid);
+}
+
+int LineSearchPositivity_test()
+{
+	Grid grid(false, 1.0, 1.0/180);
+	unsigned int n = 5*grid.getSize();
+	gsl_vector * xi = gsl_vector_calloc(n); 
+	gsl_vector * x = gsl_vector_alloc(n); 
+	gsl_vector * fxi = gsl_vector_alloc(n); 
+	gsl_vector * f = gsl_vector_alloc(n); 
+	struct constants Const = {
+		.reyn=180,.Cmu=0.19,.C1=0.4,.C2=0.3,.Cep1=1.55,.Cep2=1.9,.Ceta=70,.CL=0.3,.sigmaEp=1.3};
+	if (ReadIC(xi,&Const,&grid))
+	{
+		cout << "FAIL: Line search positivity limiter (could not read data)" << endl;
+		return 1;
+	}
+	struct solverOptions opts;
+	opts.lsTau = 0.9;
+	opts.lsMaxBacktracks = 0;
+	LineSearch * ls = LineSearchAlloc(n,&opts);
+
+	// A step that would make k negative half way across the channel. It keeps 1 - tau of
+	// the distance of k to K_MIN.
+	unsigned int i = 5*(grid.getSize()/2) + 1;
+	double k = gsl_vector_get(xi,i);
+	gsl_vector_memcpy(x,xi);
+	gsl_vector_set(x,i,-k);
+	struct FParams p = {xi,1.0,&grid,&Const};
+	SysF(xi,&p,fxi);
+	SysF(x,&p,f);
+	double alpha;
+	int fail = LineSearchStep(xi,x,&p,fxi,f,ls,&alpha);
+	if (fabs(alpha - 0.45*(k - K_MIN)/k) > 1e-12 || ls->limitedCount != 1)
+		fail = 1;
+
+	// k and v2 next to their bounds at the first point are limited too, not left to Limit.
+	// k stays positive there, so ep and f at the wall are finite.
+	gsl_vector_set(xi,1,3.0*K_MIN);
+	gsl_vector_set(xi,3,3.0*V2_MIN);
+	gsl_vector_memcpy(x,xi);
+	gsl_vector_set(x,1,0.5*K_MIN);
+	gsl_vector_set(x,3,-3.0*V2_MIN);
+	SysF(xi,&p,fxi);
+	SysF(x,&p,f);
+	double alphaWall;
+	fail |= LineSearchStep(xi,x,&p,fxi,f,ls,&alphaWall);
+	if (fabs(alphaWall - 0.3) > 1e-9 || ls->limitedCount != 2 || ls->heldCount != 0)
+		fail = 1;
+	for (unsigned int j = 0; j < n; j++)
+	{
+		int m = j%5;
+		double bound = (m == 1) ? K_MIN : (m == 3) ? V2_MIN : 0.0;
+		if ((m == 1 || m == 2 || m == 3) && !(gsl_vector_get(x,j) - bound >= 0.1*(gsl_vector_get(xi,j) - bound)*(1.0 - 1e-9)))
+			fail = 1;
+	}
+
+	// k already on K_MIN at the first point does not stop the step, it is held there.
+	gsl_vector_set(xi,1,K_MIN);
+	gsl_vector_memcpy(x,xi);
+	gsl_vector_set(x,1,0.5*K_MIN);
+	gsl_vector_set(x,i,-k);
+	SysF(xi,&p,fxi);
+	SysF(x,&p,f);
+	double alphaHeld;
+	fail |= LineSearchStep(xi,x,&p,fxi,f,ls,&alphaHeld);
+	if (fabs(alphaHeld - 0.45*(k - K_MIN)/k) > 1e-12 || gsl_vector_get(x,1) != K_MIN || ls->heldCount != 1)
+		fail = 1;
+
+	// The limit alone, as for the Anderson mixed steps, scales the same step the same way.
+	gsl_vector_memcpy(x,xi);
+	gsl_vector_set(x,1,0.5*K_MIN);
+	gsl_vector_set(x,i,-k);
+	if (fabs(LineSearchLimit(xi,x,ls) - alphaHeld) > 1e-15 || gsl_vector_get(x,1) != K_MIN)
+		fail = 1;
+	LineSearchFree(ls);
+	gsl_vector_free(xi);
+	gsl_vector_free(x);
+	gsl_vector_free(fxi);
+	gsl_vector_free(f);
+	if (fail)
+	{
+		cout << "FAIL: Line search positivity limiter (alpha " << alpha << ", " << alphaWall << ", " << alphaHeld << ")" << endl;
+		return 1;
+	}
+	cout << "PASS: Line search positivity limiter" << endl; 
+	return 0; 
+}
+
+int LineSearchBacktrack_test()
+{
+	Grid grid(false, 1.0, 1.0/180);
+	unsigned int n = 5*grid.getSize();
+	gsl_vector * xi = gsl_vector_calloc(n); 
+	gsl_vector * x = gsl_vector_alloc(n); 
+	gsl_vector * fxi = gsl_vector_alloc(n); 
+	gsl_vector * f = gsl_vector_alloc(n); 
+	gsl_vector * fx = gsl_vector_alloc(n); 
+	struct constants Const = {
+		.reyn=180,.Cmu=0.19,.C1=0.4,.C2=0.3,.Cep1=1.55,.Cep2=1.9,.Ceta=70,.CL=0.3,.sigmaEp=1.3};
+	if (ReadIC(xi,&Const,&grid))
+	{
+		cout << "FAIL: Line search backtracking (could not read data)" << endl;
+		return 1;
+	}
+	struct solverOptions opts;
+	opts.lsTau = 0.9;
+	opts.lsMaxBacktracks = 10;
+	LineSearch * ls = LineSearchAlloc(n,&opts);
+
+	// For a small deltaT, F(xi + alpha*deltaT*F_s(xi)) is close to (1-alpha)*F_s(xi), so 
+	// a step 100 times too long has to be cut back below alpha = 2.
+	double deltaT = 1e-6;
+	struct FParams p = {xi,deltaT,&grid,&Const};
+	SysF(xi,&p,fxi);
+	gsl_vector_memcpy(x,xi);
+	gsl_blas_daxpy(100*deltaT,fxi,x);
+	SysF(x,&p,f);
+	double alpha;
+	int fail = LineSearchStep(xi,x,&p,fxi,f,ls,&alpha);
+	SysF(x,&p,fx);
+	gsl_vector_sub(fx,f);
+
+	fail |= ls->backtrackCount == 0 || ls->failedCount != 0 || !(alpha < 2.0) 
+		|| !(gsl_blas_dnrm2(f) < gsl_blas_dnrm2(fxi)) || gsl_blas_dnrm2(fx) != 0.0;
+	LineSearchFree(ls);
+	gsl_vector_free(xi);
+	gsl_vector_free(x);
+	gsl_vector_free(fxi);
+	gsl_vector_free(f);
+	gsl_vector_free(fx);
+	if (fail)
+	{
+		cout << "FAIL: Line search backtracking (alpha " << alpha << ")" << endl;
+		return 1;
+	}
+	cout << "PASS: Line search backtracking" << endl; 
+	return 0; 
+}
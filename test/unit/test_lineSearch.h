@@ -0,0 +1,7 @@
+#ifndef TEST_LINESEARCH_H
+#define TEST_LINESEARCH_H
+
+int LineSearchPositivity_test();
+int LineSearchBacktrack_test();
+
+#endif
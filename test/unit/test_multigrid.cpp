@@ -0,0 +1,82 @@
+#include<iostream>
+#include<iomanip>
+#include<math.h>
+#include<gsl/gsl_blas.h>
+#include"../../src/multigrid.h"
+#include"../../src/gridTransfer.h"
+using namespace std; 
+
+int Restrict_test()
+{
+	Grid fine(false, 1.0, GridSize(23));
+	Grid coarse(false, 1.0, GridSize(12));
+	gsl_vector * rf = gsl_vector_alloc(5*fine.getSize());
+	gsl_vector * rc = gsl_vector_alloc(5*coarse.getSize());
+
+	// The weights are normalized, so a constant residual restricts to the same constant. 
+	for (unsigned int i = 0; i < rf->size; i++)
+		gsl_vector_set(rf,i,1.0+i%5);
+	int status = Restrict(rf,&fine,rc,&coarse);
+	for (unsigned int i = 0; i < rc->size && !status; i++)
+	{
+		if (fabs(gsl_vector_get(rc,i)-(1.0+i%5)) > 1e-14)
+		{
+			cout << "    At Index: " << i << std::endl;
+			cout << "    Expected: " << setprecision(15) << 1.0+i%5;
+			cout << "    Found: " << gsl_vector_get(rc,i) << std::endl;
+			status = 1;
+		}
+	}
+	gsl_vector_free(rf);
+	gsl_vector_free(rc);
+	if (status)
+	{
+		cout << "FAIL: Restriction to a coarser grid" << endl;
+		return 1;
+	}
+	cout << "PASS: Restriction to a coarser grid" << endl; 
+	return 0; 
+}
+
+int FASCycle_test()
+{
+	Grid grid(false, 1.0, 1.0/180);
+	gsl_vector * xi = gsl_vector_calloc(5*grid.getSize()); 
+	struct constants Const = {
+		.reyn=180,.Cmu=0.19,.C1=0.4,.C2=0.3,.Cep1=1.55,.Cep2=1.9,.Ceta=70,.CL=0.3,.sigmaEp=1.3};
+	if (SolveIC(xi,&Const,&grid,"../../data/Reyn_180.dat",false) || Solve4f0(xi,&Const,&grid))
+	{
+		cout << "FAIL: FAS multigrid cycles (could not read data)" << endl;
+		gsl_vector_free(xi);
+		return 1;
+	}
+	solverOptions solverOpts;
+	solverOpts.gridLevels = 2;
+	solverOpts.mgCycle = "v";
+	solverOpts.mgSmoother = "line";
+	solverOpts.mgPreSmooth = 2;
+	solverOpts.mgPostSmooth = 2;
+	solverOpts.mgCoarseIters = 4;
+	solverOpts.mgOmega = 1.0;
+	solverOpts.mgDeltaT = 10.0;
+
+	// From the initial condition a few V cycles on two levels reach the steady state. 
+	Multigrid * mg = MultigridAlloc(&grid,&Const,&solverOpts);
+	int status = (mg->nLevels != 2);
+	if (!status)
+		status = MultigridSolve(xi,mg,10);
+	gsl_vector * f = gsl_vector_alloc(xi->size);
+	FParams p = {xi,INFINITY,&grid,&Const};
+	status = status || SysF(xi,&p,f);
+	double maxRes = fmax(gsl_vector_max(f),-gsl_vector_min(f));
+	MultigridFree(mg);
+	gsl_vector_free(f);
+	gsl_vector_free(xi);
+	if (status || maxRes > 1e-7)
+	{
+		cout << "FAIL: FAS multigrid cycles (max residual " << maxRes << ")" << endl;
+		return 1;
+	}
+	cout << "PASS: FAS multigrid cycles" << endl; 
+	return 0; 
+}
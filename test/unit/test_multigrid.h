@@ -0,0 +1,7 @@
+#ifndef TEST_MULTIGRID_H
+#define TEST_MULTIGRID_H
+
+int Restrict_test();
+int FASCycle_test();
+
+#endif
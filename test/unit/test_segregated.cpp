@@ -0,0 +1,46 @@
+#include<iostream>
+#include<iomanip>
+#include<math.h>
+#include"../../src/segregated.h"
+using namespace std; 
+
+int SegregatedStep_test()
+{
+	Grid grid(false, 1.0, 1.0/180);
+	unsigned int n = 5*grid.getSize();
+	gsl_vector * xi = gsl_vector_calloc(n); 
+	gsl_vector * x = gsl_vector_alloc(n); 
+	gsl_vector * f = gsl_vector_alloc(n); 
+	struct constants Const = {
+		.reyn=180,.Cmu=0.19,.C1=0.4,.C2=0.3,.Cep1=1.55,.Cep2=1.9,.Ceta=70,.CL=0.3,.sigmaEp=1.3};
+	if (SolveIC(xi,&Const,&grid,"../../data/Reyn_180.dat",false) || Solve4f0(xi,&Const,&grid))
+	{
+		cout << "FAIL: Segregated steps (could not read data)" << endl;
+		return 1;
+	}
+
+	// With a fixed deltaT the segregated steps converge to the steady solution.
+	Segregated * S = SegregatedAlloc(n/5,1);
+	int status = 0;
+	for (int k = 0; k < 100 && !status; k++)
+	{
+		struct FParams p = {xi,2.0,&grid,&Const};
+		gsl_vector_memcpy(x,xi);
+		status = SegregatedStep(x,&p,S,NULL,f);
+		gsl_vector_memcpy(xi,x);
+	}
+	struct FParams steady = {xi,INFINITY,&grid,&Const};
+	status = status || SysF(xi,&steady,f);
+	double maxRes = fmax(gsl_vector_max(f),-gsl_vector_min(f));
+	SegregatedFree(S);
+	gsl_vector_free(xi);
+	gsl_vector_free(x);
+	gsl_vector_free(f);
+	if (status || !(maxRes < 1e-6))
+	{
+		cout << "FAIL: Segregated steps (max residual " << maxRes << ")" << endl;
+		return 1;
+	}
+	cout << "PASS: Segregated steps" << endl; 
+	return 0; 
+}
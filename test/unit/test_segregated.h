@@ -0,0 +1,6 @@
+#ifndef TEST_SEGREGATED_H
+#define TEST_SEGREGATED_H
+
+int SegregatedStep_test();
+
+#endif
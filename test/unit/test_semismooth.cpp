@@ -0,0 +1,90 @@
+#include<iostream>
+#include<iomanip>
+#include<math.h>
+#include"../../src/semismooth.h"
+using namespace std; 
+
+int SemismoothResidual_test()
+{
+	// One grid point: U, k on its bound, ep on its bound, v2 above it, f.
+	gsl_vector * x = gsl_vector_alloc(5);
+	gsl_vector * f = gsl_vector_alloc(5);
+	gsl_vector * res = gsl_vector_alloc(5);
+	double xs[5] = {1.0, SemismoothBound(1), SemismoothBound(2), 1.0, -2.0};
+	double fs[5] = {-3.0, -4.0, 5.0, -6.0, -7.0};
+	double expected[5] = {-3.0, 0.0, 5.0, -6.0, -7.0};
+	for (int j = 0; j < 5; j++)
+	{
+		gsl_vector_set(x,j,xs[j]);
+		gsl_vector_set(f,j,fs[j]);
+	}
+	SemismoothResidual(x,f,res);
+	int fail = 0;
+	for (int j = 0; j < 5; j++)
+		if (gsl_vector_get(res,j) != expected[j])
+			fail = 1;
+	gsl_vector_free(x);
+	gsl_vector_free(f);
+	gsl_vector_free(res);
+	if (fail)
+	{
+		cout << "FAIL: Semismooth residual on the bounds" << endl;
+		return 1;
+	}
+	cout << "PASS: Semismooth residual on the bounds" << endl; 
+	return 0; 
+}
+
+int SemismoothStep_test()
+{
+	Grid grid(false, 1.0, 1.0/180);
+	unsigned int n = 5*grid.getSize();
+	gsl_vector * xi = gsl_vector_calloc(n); 
+	gsl_vector * x = gsl_vector_alloc(n); 
+	gsl_vector * f = gsl_vector_alloc(n); 
+	struct constants Const = {
+		.reyn=180,.Cmu=0.19,.C1=0.4,.C2=0.3,.Cep1=1.55,.Cep2=1.9,.Ceta=70,.CL=0.3,.sigmaEp=1.3};
+	if (SolveIC(xi,&Const,&grid,"../../data/Reyn_180.dat",false) || Solve4f0(xi,&Const,&grid))
+	{
+		cout << "FAIL: Semismooth steps (could not read data)" << endl;
+		return 1;
+	}
+
+	// Cut k by 1000 half way across the channel, so the first step hits the bound. The steps 
+	// have to stay feasible and still converge to the steady solution.
+	unsigned int i = 5*(grid.getSize()/2) + 1;
+	gsl_vector_set(xi,i,1e-3*gsl_vector_get(xi,i));
+	struct solverOptions opts;
+	opts.precision = "double";
+	Semismooth * B = SemismoothAlloc(n/5,&opts);
+	int status = 0;
+	bool feasible = true;
+	int active = 0;
+	double deltaT = 0.01;
+	for (int k = 0; k < 30 && !status; k++)
+	{
+		struct FParams p = {xi,deltaT,&grid,&Const};
+		gsl_vector_memcpy(x,xi);
+		status = SemismoothStep(x,&p,B,NULL,f);
+		gsl_vector_memcpy(xi,x);
+		active += B->activeCount;
+		for (unsigned int j = 0; j < n; j++)
+			feasible = feasible && gsl_vector_get(xi,j) >= SemismoothBound(j);
+		deltaT *= 3;
+	}
+	struct FParams steady = {xi,INFINITY,&grid,&Const};
+	status = status || SysF(xi,&steady,f);
+	SemismoothResidual(xi,f,f);
+	double maxRes = fmax(gsl_vector_max(f),-gsl_vector_min(f));
+	SemismoothFree(B);
+	gsl_vector_free(xi);
+	gsl_vector_free(x);
+	gsl_vector_free(f);
+	if (status || !feasible || active == 0 || !(maxRes < 1e-6))
+	{
+		cout << "FAIL: Semismooth steps (max residual " << maxRes << ")" << endl;
+		return 1;
+	}
+	cout << "PASS: Semismooth steps" << endl; 
+	return 0; 
+}
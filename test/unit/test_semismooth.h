@@ -0,0 +1,7 @@
+#ifndef TEST_SEMISMOOTH_H
+#define TEST_SEMISMOOTH_H
+
+int SemismoothResidual_test();
+int SemismoothStep_test();
+
+#endif
@@ -1,5 +1,6 @@
 #include<iostream>
 #include<fstream> 
+#include<sstream>
 #include<math.h>
 #include"../../src/setup.h"
 #include"test_computeTerms.h"
@@ -58,7 +59,8 @@ int test_Grvy_Input(int argc,char** argv)
 	bool uniformGrid;
 	int max_ts; 
 	bool restarting;
-	if(Input_Parse(modelConst,filename,outFile,uniformGrid,max_ts,restarting,argc,argv))
+	struct solverOptions solverOpts;
+	if(Input_Parse(modelConst,filename,outFile,uniformGrid,max_ts,restarting,&solverOpts,argc,argv))
 	{ 
 		cout << "FAIL: Getting inputs" << endl; 
 		return 1; 
@@ -110,7 +112,17 @@ int test_Save_Results()
 			}
 		}
 	}
-	cout << "PASS: Saving results" << endl; 
 	inFile.close();
+
+	// The stream overload leaves the format of the caller's stream as it was.
+	ostringstream out;
+	out.precision(3);
+	SaveResults(xi,out,&grid,modelConst);
+	if (out.precision() != 3 || (out.flags() & ios_base::floatfield))
+	{
+		cout << "FAIL: Saving results (stream format not restored)" << endl;
+		return 1;
+	}
+	cout << "PASS: Saving results" << endl; 
 	return 0; 
 }
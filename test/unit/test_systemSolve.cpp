@@ -3,6 +3,7 @@
 #include<math.h>
 #include"../../src/systemSolve.h"
 #include"../../src/computeTerms.h"
+#include"../../src/jacobian.h"
 using namespace std; 
 
 int Setuptest_SS(gsl_vector * xi, struct FParams * params)
@@ -330,11 +331,115 @@ int SysF_test()
 	return 0; 
 }
 
+int SysResidualFused_test()
+{
+	Grid grid(false, 1.0, 1.0/180);
+	unsigned int n = 5*grid.getSize();
+	gsl_vector * xi = gsl_vector_calloc(n); 
+	gsl_vector * xiN = gsl_vector_alloc(n); 
+	gsl_vector * fused = gsl_vector_alloc(n); 
+	gsl_vector * byTerm = gsl_vector_alloc(n); 
+	struct constants Const = {
+		.reyn=180,.Cmu=0.19,.C1=0.4,.C2=0.3,.Cep1=1.55,.Cep2=1.9,.Ceta=70,.CL=0.3,.sigmaEp=1.3};
+	if (SolveIC(xi,&Const,&grid,"../../data/Reyn_180.dat",false) || Solve4f0(xi,&Const,&grid))
+	{
+		cout << "FAIL: Fused system (could not read data)" << endl;
+		return 1;
+	}
+	// Previous time step off the solution so the time terms are not zero.
+	for (unsigned int i = 0; i < n; i++)
+		gsl_vector_set(xiN,i,gsl_vector_get(xi,i)*(1+0.01*sin(i)));
+	struct FParams p = {xiN,0.01,&grid,&Const};
+
+	// Same terms in the same order, so the two have to agree exactly.
+	SysResidual(xi,&p,fused);
+	SysResidualByTerm(xi,&p,byTerm);
+	for (unsigned int i = 0; i < n; i++)
+	{
+		if (gsl_vector_get(fused,i) != gsl_vector_get(byTerm,i))
+		{
+			cout << "FAIL: Fused system" << endl;
+			cout << "    At Index: " << i << std::endl;
+			cout << "    Expected: " << setprecision(17) << gsl_vector_get(byTerm,i);
+			cout << "    Found: " << gsl_vector_get(fused,i) << std::endl;
+			return 1; 
+		}
+	}
+	cout << "PASS: Fused system" << endl; 
+	gsl_vector_free(xi);
+	gsl_vector_free(xiN);
+	gsl_vector_free(fused);
+	gsl_vector_free(byTerm);
+	return 0; 
+}
 
+int SysThreads_test()
+{
+	Grid grid(false, 1.0, 1.0/5200);
+	unsigned int n = 5*grid.getSize();
+	gsl_vector * xi = gsl_vector_calloc(n); 
+	gsl_vector * xiN = gsl_vector_alloc(n); 
+	gsl_vector * f[3] = {gsl_vector_alloc(n),gsl_vector_alloc(n),gsl_vector_alloc(n)}; 
+	gsl_vector * f1[3] = {gsl_vector_alloc(n),gsl_vector_alloc(n),gsl_vector_alloc(n)}; 
+	BlockTridiag * J = BlockTridiagAlloc(n/5);
+	BlockTridiag * J1 = BlockTridiagAlloc(n/5);
+	struct constants Const = {
+		.reyn=5200,.Cmu=0.19,.C1=0.4,.C2=0.3,.Cep1=1.55,.Cep2=1.9,.Ceta=70,.CL=0.3,.sigmaEp=1.3};
+	if (SolveIC(xi,&Const,&grid,"../../data/Reyn_5200.dat",false) || Solve4f0(xi,&Const,&grid))
+	{
+		cout << "FAIL: System independent of the number of threads (could not read data)" << endl;
+		return 1;
+	}
+	for (unsigned int i = 0; i < n; i++)
+		gsl_vector_set(xiN,i,gsl_vector_get(xi,i)*(1+0.01*sin(i)));
+	struct FParams p = {xiN,0.01,&grid,&Const};
+	int threads = omp_get_max_threads();
+	int status = 0;
+
+	// Every point and Jacobian row is computed by one thread in a fixed order, so any number of
+	// threads, also more than there are cores, gives the same bits.
+	for (int t = 1; t <= 4; t++)
+	{
+		omp_set_num_threads(t);
+		SysResidual(xi,&p,t == 1 ? f1[0] : f[0]);
+		SysResidualByTerm(xi,&p,t == 1 ? f1[1] : f[1]);
+		SysF(xi,&p,t == 1 ? f1[2] : f[2]);
+		SysJ(xi,&p,t == 1 ? J1 : J);
+		if (t == 1)
+			continue;
+		for (int k = 0; k < 3; k++)
+			for (unsigned int i = 0; i < n; i++)
+				if (gsl_vector_get(f[k],i) != gsl_vector_get(f1[k],i))
+					status = 1;
+		for (unsigned int r = 0; r < n/5; r++)
+			for (int offset = -1; offset <= 1; offset++)
+			{
+				if ((int)r+offset < 0 || r+offset >= n/5)
+					continue;
+				double * a = BlockTridiagBlock(J,r,offset), * b = BlockTridiagBlock(J1,r,offset);
+				for (int k = 0; k < BLOCK_SIZE*BLOCK_SIZE; k++)
+					if (a[k] != b[k])
+						status = 1;
+			}
+		if (status)
+			cout << "    Differs with " << t << " threads" << endl;
+	}
+	omp_set_num_threads(threads);
 
-
-
-
-
-
-
+	if (status)
+	{
+		cout << "FAIL: System independent of the number of threads" << endl;
+		return 1;
+	}
+	cout << "PASS: System independent of the number of threads" << endl; 
+	for (int k = 0; k < 3; k++)
+	{
+		gsl_vector_free(f[k]);
+		gsl_vector_free(f1[k]);
+	}
+	BlockTridiagFree(J);
+	BlockTridiagFree(J1);
+	gsl_vector_free(xi);
+	gsl_vector_free(xiN);
+	return 0; 
+}
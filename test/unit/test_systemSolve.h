@@ -10,6 +10,8 @@ int SetEpTerms_test();
 int Setv2Terms_test();
 int SetFTerms_test();
 int SysF_test();
+int SysResidualFused_test();
+int SysThreads_test();
 int Setuptest_SS(gsl_vector *,struct FParams *);
 
 
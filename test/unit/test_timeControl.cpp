@@ -0,0 +1,69 @@
+#include<iostream>
+#include<iomanip>
+#include<math.h>
+#include"../../src/timeControl.h"
+using namespace std; 
+
+// Options shared by the controller tests.
+void SetupTest_TC(solverOptions * solverOpts, string type)
+{
+	solverOpts->timeControl = type;
+	solverOpts->deltaT0 = 0.01;
+	solverOpts->maxDeltaT = 1000.0;
+	solverOpts->steadySwitch = 0.0;
+	solverOpts->piKP = 0.075;
+	solverOpts->piKI = 0.175;
+	solverOpts->piTarget = 0.01;
+}
+
+int SERTimeControl_test()
+{
+	solverOptions solverOpts;
+	SetupTest_TC(&solverOpts,"ser");
+	solverOpts.maxDeltaT = 1.0;
+	TimeController * tc = TimeControllerAlloc(&solverOpts);
+
+	// deltaT grows by the drop in residual, limited to a factor 10 per step and to max_deltaT.
+	double dt1 = TimeControllerNext(tc,1.0,1.0,0.0);
+	double dt2 = TimeControllerNext(tc,0.5,1.0,0.0);
+	double dt3 = TimeControllerNext(tc,0.5e-3,1.0,0.0);
+	double dt4 = TimeControllerNext(tc,0.5e-9,1.0,0.0);
+	if (dt1 != 0.01 || fabs(dt2 - 0.02) > 1e-15 || fabs(dt3 - 0.2) > 1e-15 || dt4 != 1.0)
+	{
+		cout << "FAIL: SER time step control" << endl;
+		TimeControllerFree(tc);
+		return 1;
+	}
+	cout << "PASS: SER time step control" << endl; 
+	TimeControllerFree(tc);
+	return 0; 
+}
+
+int SteadySwitch_test()
+{
+	solverOptions solverOpts;
+	SetupTest_TC(&solverOpts,"pi");
+	solverOpts.steadySwitch = 1e-3;
+	TimeController * tc = TimeControllerAlloc(&solverOpts);
+
+	// Finite steps above the switch, steady Newton below it, and back again if the residual grows.
+	double dt1 = TimeControllerNext(tc,1.0,1.0,0.0);
+	double dt2 = TimeControllerNext(tc,1e-4,1.0,0.01);
+	double dt3 = TimeControllerNext(tc,1e-2,1.0,0.01);
+	if (!isfinite(dt1) || isfinite(dt2) || !isfinite(dt3) || tc->steadySteps != 1)
+	{
+		cout << "FAIL: Switch to steady Newton" << endl;
+		TimeControllerFree(tc);
+		return 1;
+	}
+	solverOpts.timeControl = "none";
+	if (TimeControllerAlloc(&solverOpts) != NULL)
+	{
+		cout << "FAIL: Switch to steady Newton (unknown controller allocated)" << endl;
+		TimeControllerFree(tc);
+		return 1;
+	}
+	cout << "PASS: Switch to steady Newton" << endl; 
+	TimeControllerFree(tc);
+	return 0; 
+}
@@ -0,0 +1,7 @@
+#ifndef TEST_TIMECONTROL_H
+#define TEST_TIMECONTROL_H
+
+int SERTimeControl_test();
+int SteadySwitch_test();
+
+#endif
@@ -0,0 +1,91 @@
+#include<iostream>
+#include<iomanip>
+#include<math.h>
+#include<gsl/gsl_linalg.h>
+#include"../../src/tridiag.h"
+using namespace std; 
+
+// Diagonally dominant, nonsymmetric system like the one in Solve4f0. 
+int Setuptest_TD(TridiagonalSystem * sys)
+{
+	for (unsigned int i = 0; i < sys->n; i++)
+		TridiagSetRow(sys,i,1.0+0.5*sin(i),-(3.0+cos(2.0*i)),1.0+0.5*cos(i),sin(0.3*i));
+	return 0; 
+}
+
+// Compare x against gsl's dense LU solve. 
+int CompareDenseTD(TridiagonalSystem * sys, gsl_vector * x, double tol)
+{
+	unsigned int n = sys->n;
+	gsl_matrix * A = gsl_matrix_calloc(n,n);
+	gsl_vector * trueX = gsl_vector_alloc(n);
+	gsl_permutation * p = gsl_permutation_alloc(n);
+	int s; 
+	int status = 0;
+
+	for (unsigned int i = 0; i < n; i++)
+	{
+		if (i > 0)
+			gsl_matrix_set(A,i,i-1,gsl_vector_get(sys->lower,i));
+		gsl_matrix_set(A,i,i,gsl_vector_get(sys->diag,i));
+		if (i < n-1)
+			gsl_matrix_set(A,i,i+1,gsl_vector_get(sys->upper,i));
+	}
+	gsl_linalg_LU_decomp(A,p,&s);
+	gsl_linalg_LU_solve(A,p,sys->rhs,trueX);
+	for (unsigned int i = 0; i < n; i++)
+	{
+		if (fabs(gsl_vector_get(x,i)-gsl_vector_get(trueX,i)) > tol)
+		{
+			cout << "    At Index: " << i << std::endl;
+			cout << "    Expected: " << setprecision(15) << gsl_vector_get(trueX,i);
+			cout << "    Found: " << gsl_vector_get(x,i) << std::endl;
+			cout << "    Tolerance: " << tol << std::endl;
+			status = 1;
+			break;
+		}
+	}
+	gsl_matrix_free(A);
+	gsl_vector_free(trueX);
+	gsl_permutation_free(p);
+	return status;
+}
+
+int TridiagSolve_test()
+{
+	TridiagonalSystem * sys = TridiagAlloc(37);
+	gsl_vector * x = gsl_vector_alloc(37);
+	Setuptest_TD(sys);
+
+	if (TridiagSolve(sys,x) || CompareDenseTD(sys,x,1e-12))
+	{
+		cout << "FAIL: Tridiagonal solve" << endl;
+		return 1;
+	}
+	cout << "PASS: Tridiagonal solve" << endl; 
+	TridiagFree(sys);
+	gsl_vector_free(x);
+	return 0; 
+}
+
+int TridiagSolveCR_test()
+{
+	// Sizes around powers of two, where the last reduction step leaves a different row.
+	const unsigned int sizes[] = {1, 2, 3, 7, 8, 9, 37, 64, 1000};
+	for (unsigned int k = 0; k < sizeof(sizes)/sizeof(sizes[0]); k++)
+	{
+		TridiagonalSystem * sys = TridiagAlloc(sizes[k]);
+		gsl_vector * x = gsl_vector_alloc(sizes[k]);
+		Setuptest_TD(sys);
+		int status = TridiagSolveCR(sys,x) || CompareDenseTD(sys,x,1e-12);
+		TridiagFree(sys);
+		gsl_vector_free(x);
+		if (status)
+		{
+			cout << "FAIL: Tridiagonal solve with cyclic reduction (n = " << sizes[k] << ")" << endl;
+			return 1;
+		}
+	}
+	cout << "PASS: Tridiagonal solve with cyclic reduction" << endl; 
+	return 0; 
+}
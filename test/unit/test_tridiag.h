@@ -0,0 +1,7 @@
+#ifndef TEST_TRIDIAG_H
+#define TEST_TRIDIAG_H
+
+int TridiagSolve_test();
+int TridiagSolveCR_test();
+
+#endif
@@ -0,0 +1,272 @@
+#include<iostream>
+#include<fstream>
+#include<sstream>
+#include<stdio.h>
+#include<string.h>
+#include<math.h>
+#include"../../src/v2fSolver.h"
+#include"../../src/sweep.h"
+#include"../../src/sweepStore.h"
+using namespace std;
+
+// Options of the unit test input file, for a Re 180 solve with the given Cmu.
+static int SetupTest_V2f(V2fConfig * config, double Cmu)
+{
+	char * av[] = {(char *)"test",(char *)"-c",(char *)"input_file.txt"};
+	loglevel_e level = loglevel;
+	int status = V2fConfigParse(config,NULL,3,av);
+	loglevel = level;
+	config->modelConst = {
+		.reyn=180,.Cmu=Cmu,.C1=0.4,.C2=0.3,.Cep1=1.55,.Cep2=1.9,.Ceta=70,.CL=0.3,.sigmaEp=1.3};
+	config->dataFile = "../../data/Reyn_180.dat";
+	config->outFile = "";
+	config->maxTs = 100;
+	config->logLevel = logERROR;
+	return status;
+}
+
+int V2fSolver_test()
+{
+	V2fConfig config;
+	if (SetupTest_V2f(&config,0.19))
+	{
+		cout << "FAIL: Solver with its own log and status (could not read inputs)" << endl;
+		return 1;
+	}
+	int status = 0;
+	loglevel_e level = loglevel;
+	ostream * sink = logSink;
+
+	// A solve logs to its own stream, at its own level, and leaves the log of the caller as it was.
+	ostringstream log;
+	config.logLevel = logINFO;
+	config.log = &log;
+	V2fSolver * s = V2fSolverAlloc(&config);
+	if (V2fSolverRun(s) || !s->converged || s->iterations < 1 || !(s->maxResidual < 1e-7) ||
+	    log.str().find("Time control") == string::npos || loglevel != level || logSink != sink)
+	{
+		cout << "    Solve: status " << s->status << ", " << s->iterations << " iterations, max residual " << s->maxResidual << endl;
+		status = 1;
+	}
+	V2fSolverFree(s);
+
+	// Errors are returned: terms that are not finite, and a missing data file.
+	ostringstream badLog;
+	config.log = &badLog;
+	config.logLevel = logERROR;
+	config.modelConst.Ceta = NAN;
+	s = V2fSolverAlloc(&config);
+	if (!V2fSolverRun(s) || s->converged || badLog.str().find("non-finite") == string::npos)
+	{
+		cout << "    Not finite: status " << s->status << endl;
+		status = 1;
+	}
+	V2fSolverFree(s);
+	config.modelConst.Ceta = 70;
+	config.dataFile = "no_such_file.dat";
+	s = V2fSolverAlloc(&config);
+	if (!V2fSolverRun(s) || s->converged)
+	{
+		cout << "    Missing data file: status " << s->status << endl;
+		status = 1;
+	}
+	V2fSolverFree(s);
+
+	if (status)
+	{
+		cout << "FAIL: Solver with its own log and status" << endl;
+		return 1;
+	}
+	cout << "PASS: Solver with its own log and status" << endl;
+	return 0;
+}
+
+int Sweep_test()
+{
+	V2fConfig config;
+	if (SetupTest_V2f(&config,0.19))
+	{
+		cout << "FAIL: Cases of a sweep side by side (could not read inputs)" << endl;
+		return 1;
+	}
+	const unsigned int n = 6;
+	SweepCase cases[n];
+	for (unsigned int j = 0; j < n; j++)
+	{
+		cases[j].modelConst = config.modelConst;
+		cases[j].modelConst.Cmu = 0.17 + 0.01*j;
+		cases[j].dataFile = config.dataFile;
+	}
+	cases[n-1].dataFile = "no_such_file.dat";
+
+	// Every case on its own, one after the other.
+	int expected[n], iterations[n];
+	double maxResidual[n];
+	for (unsigned int j = 0; j < n; j++)
+	{
+		V2fConfig c = config;
+		ostringstream log;
+		c.log = &log;
+		c.modelConst = cases[j].modelConst;
+		c.dataFile = cases[j].dataFile;
+		V2fSolver * s = V2fSolverAlloc(&c);
+		expected[j] = V2fSolverRun(s);
+		iterations[j] = s->iterations;
+		maxResidual[j] = s->maxResidual;
+		V2fSolverFree(s);
+	}
+
+	// The same cases side by side must give the same results, and the failed one must not stop
+	// the others. The log of the failed case goes to the log of this thread.
+	ostream * sink = logSink;
+	ostringstream log;
+	logSink = &log;
+	int sweepStatus = SweepRun(&config,cases,n,3,"");
+	logSink = sink;
+	int status = (sweepStatus != 1);
+	for (unsigned int j = 0; j < n; j++)
+	{
+		if (cases[j].status != expected[j] || cases[j].iterations != iterations[j] ||
+		    !(cases[j].maxResidual == maxResidual[j] || (isinf(maxResidual[j]) && isinf(cases[j].maxResidual))) ||
+		    cases[j].thread < 0 || cases[j].converged != (expected[j] == 0))
+		{
+			cout << "    Case " << j << ": status " << cases[j].status << " (" << expected[j] << "), " << cases[j].iterations
+				<< " iterations (" << iterations[j] << ")" << endl;
+			status = 1;
+		}
+	}
+	if (expected[n-1] == 0 || log.str().find("Error interpolating") == string::npos)
+		status = 1;
+
+	if (status)
+	{
+		cout << "FAIL: Cases of a sweep side by side" << endl;
+		return 1;
+	}
+	cout << "PASS: Cases of a sweep side by side" << endl;
+	return 0;
+}
+
+int SweepProcesses_test()
+{
+	V2fConfig config;
+	if (SetupTest_V2f(&config,0.19))
+	{
+		cout << "FAIL: Sweep in worker processes, resumed (could not read inputs)" << endl;
+		return 1;
+	}
+	// Three cases and one that fails, in two worker processes.
+	string manifest = "sweep_test_cases.txt", results = manifest + ".results";
+	remove(results.c_str());
+	{
+		ofstream file(manifest.c_str());
+		file << "# reyn Cmu C1 C2 Cep1 Cep2 Ceta CL sigmaEp [data_filename]" << endl;
+		for (unsigned int j = 0; j < 3; j++)
+			file << "180 " << 0.17 + 0.01*j << " 0.4 0.3 1.55 1.9 70 0.3 1.3" << endl;
+		file << "180 0.19 0.4 0.3 1.55 1.9 70 0.3 1.3 no_such_file.dat" << endl;
+	}
+	unsigned int n;
+	SweepCase * cases = SweepRead(manifest,&config,&n);
+	if (!cases || n != 4)
+	{
+		cout << "FAIL: Sweep in worker processes, resumed (could not read the manifest)" << endl;
+		return 1;
+	}
+
+	// Every case on its own: the profiles of the result file must be the same, bit for bit.
+	int status = 0;
+	double * expected[4];
+	int iterations[4];
+	for (unsigned int j = 0; j < n; j++)
+	{
+		V2fConfig c = config;
+		ostringstream log;
+		c.log = &log;
+		c.modelConst = cases[j].modelConst;
+		c.dataFile = cases[j].dataFile;
+		V2fSolver * s = V2fSolverAlloc(&c);
+		V2fSolverRun(s);
+		iterations[j] = s->iterations;
+		unsigned int points = s->grid->getSize() + 1;
+		expected[j] = new double[points*SWEEP_COLUMNS];
+		for (unsigned int i = 1; i < points; i++)
+		{
+			expected[j][SWEEP_COLUMNS*i] = gsl_vector_get(s->grid->y,i-1);
+			for (unsigned int m = 1; m < SWEEP_COLUMNS; m++)
+				expected[j][SWEEP_COLUMNS*i+m] = gsl_vector_get(s->xi,5*(i-1)+m-1);
+		}
+		V2fSolverFree(s);
+	}
+
+	ostream * sink = logSink;
+	ostringstream log;
+	logSink = &log;
+	int pids[4];
+	double seconds[4];
+	for (int run = 0; run < 3 && !status; run++)
+	{
+		// Run 1 does all cases, run 2 none, and run 3 the case left running by a worker that died.
+		int sweepStatus = SweepProcesses(&config,manifest,2);
+		SweepStore * store = SweepStoreOpen(results,cases,n,config.uniformGrid);
+		if (sweepStatus != 1 || !store)
+		{
+			cout << "    Run " << run << ": status " << sweepStatus << endl;
+			status = 1;
+			break;
+		}
+		for (unsigned int j = 0; j < n; j++)
+		{
+			SweepRecord * r = &store->records[j];
+			bool same = (j == 3) ? (r->state == SWEEP_FAILED && r->status != 0) :
+				(r->state == SWEEP_DONE && r->status == 0 && r->converged && r->iterations == iterations[j]);
+			// Rows after the wall; the wall row is checked by its own.
+			for (unsigned int i = SWEEP_COLUMNS; same && j < 3 && i < r->points*SWEEP_COLUMNS; i++)
+				same = (SweepStoreProfile(store,j)[i] == expected[j][i]);
+			if (j < 3 && !(SweepStoreProfile(store,j)[3] > 0.0))
+				same = false;
+			bool rerun = (run == 1 || (run == 2 && j != 1));
+			if (run > 0 && rerun && (r->worker != pids[j] || r->seconds != seconds[j]))
+				same = false;
+			if (run == 2 && j == 1 && r->worker == pids[j])
+				same = false;
+			if (!same)
+			{
+				cout << "    Run " << run << ", case " << j << ": state " << r->state << ", status " << r->status
+					<< ", " << r->iterations << " iterations (" << iterations[j] << ")" << endl;
+				status = 1;
+			}
+			pids[j] = r->worker;
+			seconds[j] = r->seconds;
+		}
+		if (run == 1)
+		{
+			// A worker that died while it ran case 1.
+			store->records[1].state = SWEEP_RUNNING;
+			memset(SweepStoreProfile(store,1),0,store->records[1].points*SWEEP_COLUMNS*sizeof(double));
+		}
+		SweepStoreClose(store);
+	}
+
+	// A result file is only used for the cases it was made for.
+	cases[2].modelConst.Cmu = 0.2;
+	SweepStore * store = SweepStoreOpen(results,cases,n,config.uniformGrid);
+	if (store)
+	{
+		SweepStoreClose(store);
+		status = 1;
+	}
+	logSink = sink;
+
+	for (unsigned int j = 0; j < n; j++)
+		delete[] expected[j];
+	delete[] cases;
+	remove(results.c_str());
+	remove(manifest.c_str());
+	if (status)
+	{
+		cout << "FAIL: Sweep in worker processes, resumed" << endl;
+		return 1;
+	}
+	cout << "PASS: Sweep in worker processes, resumed" << endl;
+	return 0;
+}
@@ -0,0 +1,8 @@
+#ifndef TEST_V2FSOLVER_H
+#define TEST_V2FSOLVER_H
+
+int V2fSolver_test();
+int Sweep_test();
+int SweepProcesses_test();
+
+#endif
@@ -0,0 +1,97 @@
+#include<iostream>
+#include<math.h>
+#include"../../src/workspace.h"
+#include"../../src/jacobian.h"
+#include"../../src/adJacobian.h"
+#include"../../src/fdJacobian.h"
+using namespace std; 
+
+// Residual and all three Jacobians at xi with the parameters p.
+static void Evaluate(gsl_vector * xi, FParams * p, gsl_vector * f, BlockTridiag * J[3])
+{
+	gsl_multiroot_function F = {&SysF,xi->size,p};
+	SysF(xi,p,f);
+	SysJ(xi,p,J[0]);
+	ADJacobian(xi,p,J[1]);
+	ColoredFDJacobian(&F,xi,NULL,J[2],p->work);
+}
+
+int Workspace_test()
+{
+	Grid grid(false, 1.0, 1.0/180);
+	unsigned int n = 5*grid.getSize();
+	gsl_vector * xi = gsl_vector_calloc(n); 
+	gsl_vector * f = gsl_vector_alloc(n); 
+	gsl_vector * fw = gsl_vector_alloc(n); 
+	struct constants Const = {
+		.reyn=180,.Cmu=0.19,.C1=0.4,.C2=0.3,.Cep1=1.55,.Cep2=1.9,.Ceta=70,.CL=0.3,.sigmaEp=1.3};
+	if (SolveIC(xi,&Const,&grid,"../../data/Reyn_180.dat",false) || Solve4f0(xi,&Const,&grid))
+	{
+		cout << "FAIL: Residual and Jacobians from a workspace (could not read data)" << endl;
+		return 1;
+	}
+	Workspace * w = WorkspaceAlloc(n/5+1);
+	struct FParams p = {xi,0.01,&grid,&Const};
+	struct FParams pw = {xi,0.01,&grid,&Const,NULL,w};
+	BlockTridiag * J[3], * Jw[3];
+	for (int j = 0; j < 3; j++)
+	{
+		J[j] = BlockTridiagAlloc(n/5);
+		Jw[j] = BlockTridiagAlloc(n/5);
+	}
+	int status = 0;
+
+	// The workspace must not change any result, also when it is reused at another xi.
+	for (int pass = 0; pass < 2; pass++)
+	{
+		if (pass)
+			for (unsigned int i = 0; i < n; i++)
+				gsl_vector_set(xi,i,gsl_vector_get(xi,i)*(1+0.01*sin(i)));
+		unsigned long before = WorkspaceAllocCount();
+		Evaluate(xi,&p,f,J);
+		unsigned long perCall = WorkspaceAllocCount()-before;
+		before = WorkspaceAllocCount();
+		Evaluate(xi,&pw,fw,Jw);
+		unsigned long withWork = WorkspaceAllocCount()-before;
+		for (unsigned int i = 0; i < n; i++)
+			if (gsl_vector_get(f,i) != gsl_vector_get(fw,i))
+				status = 1;
+		for (int j = 0; j < 3; j++)
+			for (unsigned int r = 0; r < n/5; r++)
+				for (int offset = -1; offset <= 1; offset++)
+				{
+					if ((int)r+offset < 0 || r+offset >= n/5)
+						continue;
+					double * a = BlockTridiagBlock(J[j],r,offset), * b = BlockTridiagBlock(Jw[j],r,offset);
+					for (int k = 0; k < BLOCK_SIZE*BLOCK_SIZE; k++)
+						if (a[k] != b[k])
+							status = 1;
+				}
+
+#ifdef DEBUG_ALLOC
+		// Without a workspace every call allocates its scratch, with one none does.
+		if (perCall == 0 || withWork != 0)
+		{
+			cout << "    Scratch allocations: " << perCall << " without, " << withWork << " with a workspace" << endl;
+			status = 1;
+		}
+#endif
+	}
+
+	if (status)
+	{
+		cout << "FAIL: Residual and Jacobians from a workspace" << endl;
+		return 1;
+	}
+	cout << "PASS: Residual and Jacobians from a workspace" << endl; 
+	for (int j = 0; j < 3; j++)
+	{
+		BlockTridiagFree(J[j]);
+		BlockTridiagFree(Jw[j]);
+	}
+	WorkspaceFree(w);
+	gsl_vector_free(xi);
+	gsl_vector_free(f);
+	gsl_vector_free(fw);
+	return 0; 
+}
@@ -0,0 +1,6 @@
+#ifndef TEST_WORKSPACE_H
+#define TEST_WORKSPACE_H
+
+int Workspace_test();
+
+#endif